@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <AutoList.hpp>
+
+// Intrusive ARC (Megiddo, Modha, FAST 2003) and 2Q (Johnson, Shasha,
+// VLDB 1994) cache policies. Resident items are linked to AutoLists of
+// the engine, every hit or move between the lists is a single relink.
+// Ghosts (keys of recently evicted items) are not items: they are kept in
+// a preallocated pool of small records with their own AutoLists and an
+// intrusive hash index by key.
+//
+// The key of an item is the KeyMember, it must not change while the item
+// is resident. Lookup of resident items is not a part of the engines: the
+// user calls touch() on a hit and insert() on a miss. Evicted items are
+// reported to aOnEvict(Item&), that must not modify the cache. Nothing is
+// thread safe. A resident item must be removed before it's destroyed.
+
+class AdaptiveCacheLink
+{
+public:
+    AdaptiveCacheLink() = default;
+    AdaptiveCacheLink(const AdaptiveCacheLink&) {}
+    AdaptiveCacheLink& operator=(const AdaptiveCacheLink&) { return *this; }
+    bool isResident() const { return 0 != m_Queue; }
+
+    AutoListLink m_Link;
+    // Resident queue id of the engine, 0 if the item isn't resident.
+    uint8_t m_Queue = 0;
+};
+
+namespace adaptive_details
+{
+    struct NoOp
+    {
+        template <class T>
+        void operator()(T&) const {}
+    };
+
+    // Pool of ghost records with a chained hash index by key; the chains go
+    // through the records, so nothing is allocated after construction.
+    // Every record is either free or linked to one of the ghost lists of the
+    // engine.
+    template <class Key, class Hash>
+    class GhostDirectory
+    {
+    public:
+        struct Ghost
+        {
+            AutoListLink m_Link;
+            Ghost* m_Chain;
+            Key m_Key;
+            uint8_t m_List;
+        };
+        using List = AutoList<Ghost, &Ghost::m_Link>;
+
+        explicit GhostDirectory(size_t aCapacity) : m_Ghosts(aCapacity)
+        {
+            size_t sBuckets = 1;
+            while (sBuckets < 2 * aCapacity)
+                sBuckets *= 2;
+            m_Buckets.assign(sBuckets, nullptr);
+            for (Ghost& sGhost : m_Ghosts)
+                m_Free.insertBack(sGhost);
+        }
+        GhostDirectory(const GhostDirectory&) = delete;
+        GhostDirectory& operator=(const GhostDirectory&) = delete;
+
+        Ghost* find(const Key& aKey)
+        {
+            Ghost* sGhost = bucket(aKey);
+            while (nullptr != sGhost && !(sGhost->m_Key == aKey))
+                sGhost = sGhost->m_Chain;
+            return sGhost;
+        }
+        // The pool must not be exhausted.
+        void add(const Key& aKey, List& aList, uint8_t aListId)
+        {
+            Ghost& sGhost = m_Free.front();
+            m_Free.removeItem(sGhost);
+            sGhost.m_Key = aKey;
+            sGhost.m_List = aListId;
+            aList.insertFront(sGhost);
+            Ghost*& sBucket = bucket(aKey);
+            sGhost.m_Chain = sBucket;
+            sBucket = &sGhost;
+            ++m_Size;
+        }
+        void release(Ghost& aGhost)
+        {
+            Ghost** sPtr = &bucket(aGhost.m_Key);
+            while (*sPtr != &aGhost)
+                sPtr = &(*sPtr)->m_Chain;
+            *sPtr = aGhost.m_Chain;
+            aGhost.m_Link.remove();
+            m_Free.insertFront(aGhost);
+            --m_Size;
+        }
+        size_t size() const { return m_Size; }
+        size_t capacity() const { return m_Ghosts.size(); }
+
+    private:
+        std::vector<Ghost> m_Ghosts;
+        std::vector<Ghost*> m_Buckets;
+        List m_Free;
+        size_t m_Size = 0;
+
+        Ghost*& bucket(const Key& aKey)
+        {
+            return m_Buckets[Hash()(aKey) & (m_Buckets.size() - 1)];
+        }
+    };
+
+    template <class List>
+    size_t calcSize(const List& aList)
+    {
+        size_t sRes = 0;
+        for (auto sItr = aList.begin(); sItr != aList.end(); ++sItr)
+            ++sRes;
+        return sRes;
+    }
+}
+
+// Adaptive Replacement Cache. T1 holds items seen once recently, T2 items
+// seen at least twice; B1 and B2 are their ghosts. A ghost hit in B1 (B2)
+// means T1 (T2) was too small and moves the target size p of T1.
+template <class Item, AdaptiveCacheLink Item::*LinkMember, class Key, Key Item::*KeyMember,
+          class Hash = std::hash<Key>>
+class ArcCache
+{
+public:
+    // The sum of all four lists never exceeds 2 * aCapacity.
+    // A capacity of 0 is taken as 1: insert must have something to evict.
+    explicit ArcCache(size_t aCapacity) : m_Capacity(aCapacity > 0 ? aCapacity : 1), m_Ghosts(2 * m_Capacity) {}
+    ArcCache(const ArcCache&) = delete;
+    ArcCache& operator=(const ArcCache&) = delete;
+
+    static bool contains(const Item& aItem)
+    {
+        return (aItem.*LinkMember).isResident();
+    }
+    // A hit, aItem must be resident.
+    void touch(Item& aItem)
+    {
+        AdaptiveCacheLink& sLink = aItem.*LinkMember;
+        if (T1 == sLink.m_Queue)
+        {
+            --m_Sizes[T1];
+            ++m_Sizes[T2];
+            sLink.m_Queue = T2;
+        }
+        m_Lists[sLink.m_Queue - T1].removeItem(sLink);
+        m_Lists[T2 - T1].insertFront(sLink);
+    }
+    // A miss, aItem must not be resident.
+    template <class OnEvict>
+    void insert(Item& aItem, OnEvict aOnEvict)
+    {
+        const Key& sKey = aItem.*KeyMember;
+        typename Ghosts::Ghost* sGhost = m_Ghosts.find(sKey);
+        if (nullptr != sGhost)
+        {
+            bool sInB2 = B2 == sGhost->m_List;
+            if (sInB2)
+                m_Target -= std::min(m_Target, std::max<size_t>(m_Sizes[B1] / m_Sizes[B2], 1));
+            else
+                m_Target = std::min(m_Capacity, m_Target + std::max<size_t>(m_Sizes[B2] / m_Sizes[B1], 1));
+            dropGhost(*sGhost);
+            if (size() >= m_Capacity)
+                replace(sInB2, aOnEvict);
+            push(aItem, T2);
+            return;
+        }
+        size_t sL1 = m_Sizes[T1] + m_Sizes[B1];
+        if (sL1 >= m_Capacity)
+        {
+            if (m_Sizes[T1] < m_Capacity)
+            {
+                dropGhost(m_GhostLists[B1 - B1].back());
+                if (size() >= m_Capacity)
+                    replace(false, aOnEvict);
+            }
+            else
+            {
+                AdaptiveCacheLink& sVictim = m_Lists[T1 - T1].back();
+                pop(sVictim);
+                aOnEvict(*item(&sVictim));
+            }
+        }
+        else if (sL1 + m_Sizes[T2] + m_Sizes[B2] >= m_Capacity)
+        {
+            if (sL1 + m_Sizes[T2] + m_Sizes[B2] >= 2 * m_Capacity)
+                dropGhost(m_GhostLists[B2 - B1].back());
+            if (size() >= m_Capacity)
+                replace(false, aOnEvict);
+        }
+        push(aItem, T1);
+    }
+    void insert(Item& aItem)
+    {
+        insert(aItem, adaptive_details::NoOp());
+    }
+    void remove(Item& aItem)
+    {
+        AdaptiveCacheLink& sLink = aItem.*LinkMember;
+        if (sLink.isResident())
+            pop(sLink);
+    }
+    size_t size() const { return m_Sizes[T1] + m_Sizes[T2]; }
+    size_t capacity() const { return m_Capacity; }
+    bool empty() const { return 0 == size(); }
+    // Target size of T1.
+    size_t target() const { return m_Target; }
+    size_t t1Size() const { return m_Sizes[T1]; }
+    size_t t2Size() const { return m_Sizes[T2]; }
+    size_t b1Size() const { return m_Sizes[B1]; }
+    size_t b2Size() const { return m_Sizes[B2]; }
+    int selfCheck() const
+    {
+        for (size_t i = T1; i <= T2; i++)
+        {
+            if (m_Lists[i - T1].selfCheck() != 0 || adaptive_details::calcSize(m_Lists[i - T1]) != m_Sizes[i])
+                return 1;
+            for (const AdaptiveCacheLink& sLink : m_Lists[i - T1])
+                if (sLink.m_Queue != i)
+                    return 2;
+        }
+        for (size_t i = B1; i <= B2; i++)
+        {
+            if (m_GhostLists[i - B1].selfCheck() != 0 || adaptive_details::calcSize(m_GhostLists[i - B1]) != m_Sizes[i])
+                return 1;
+            for (const typename Ghosts::Ghost& sGhost : m_GhostLists[i - B1])
+                if (sGhost.m_List != i)
+                    return 2;
+        }
+        if (m_Ghosts.size() != m_Sizes[B1] + m_Sizes[B2])
+            return 3;
+        if (size() > m_Capacity || m_Sizes[T1] + m_Sizes[B1] > m_Capacity ||
+            size() + m_Ghosts.size() > 2 * m_Capacity)
+            return 4;
+        return 0;
+    }
+
+private:
+    enum : uint8_t
+    {
+        NONE,
+        T1,
+        T2,
+        B1,
+        B2,
+        LIST_COUNT
+    };
+    using Ghosts = adaptive_details::GhostDirectory<Key, Hash>;
+    using List = AutoList<AdaptiveCacheLink, &AdaptiveCacheLink::m_Link>;
+
+    size_t m_Capacity;
+    size_t m_Target = 0;
+    size_t m_Sizes[LIST_COUNT] = {0, 0, 0, 0, 0};
+    List m_Lists[2];
+    typename Ghosts::List m_GhostLists[2];
+    Ghosts m_Ghosts;
+
+    // Evicts LRU of T1 or T2 to the corresponding ghost list.
+    template <class OnEvict>
+    void replace(bool aInB2, OnEvict& aOnEvict)
+    {
+        size_t sT1 = m_Sizes[T1];
+        uint8_t sFrom = sT1 > 0 && (sT1 > m_Target || (aInB2 && sT1 == m_Target)) ? T1 : T2;
+        uint8_t sTo = T1 == sFrom ? B1 : B2;
+        AdaptiveCacheLink& sVictim = m_Lists[sFrom - T1].back();
+        Item& sItem = *item(&sVictim);
+        pop(sVictim);
+        m_Ghosts.add(sItem.*KeyMember, m_GhostLists[sTo - B1], sTo);
+        ++m_Sizes[sTo];
+        aOnEvict(sItem);
+    }
+    void push(Item& aItem, uint8_t aQueue)
+    {
+        AdaptiveCacheLink& sLink = aItem.*LinkMember;
+        sLink.m_Queue = aQueue;
+        m_Lists[aQueue - T1].insertFront(sLink);
+        ++m_Sizes[aQueue];
+    }
+    void pop(AdaptiveCacheLink& aLink)
+    {
+        m_Lists[aLink.m_Queue - T1].removeItem(aLink);
+        --m_Sizes[aLink.m_Queue];
+        aLink.m_Queue = NONE;
+    }
+    void dropGhost(typename Ghosts::Ghost& aGhost)
+    {
+        --m_Sizes[aGhost.m_List];
+        m_Ghosts.release(aGhost);
+    }
+
+    static Item* item(AdaptiveCacheLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
+
+// Full 2Q. New items enter the FIFO A1in, the keys of items evicted from
+// it are remembered in the ghost FIFO A1out; a miss on a remembered key
+// puts the item to the LRU Am. Hits in A1in are ignored, so a one-time scan
+// passes through A1in without disturbing Am.
+template <class Item, AdaptiveCacheLink Item::*LinkMember, class Key, Key Item::*KeyMember,
+          class Hash = std::hash<Key>>
+class TwoQueueCache
+{
+public:
+    // Defaults are the tuning recommended by the paper: Kin is 25% and Kout
+    // is 50% of the capacity.
+    explicit TwoQueueCache(size_t aCapacity)
+        : TwoQueueCache(aCapacity, std::max<size_t>(aCapacity / 4, 1), aCapacity / 2) {}
+    // A capacity of 0 is taken as 1: insert must have something to evict.
+    TwoQueueCache(size_t aCapacity, size_t aInCapacity, size_t aOutCapacity)
+        : m_Capacity(aCapacity > 0 ? aCapacity : 1), m_InCapacity(aInCapacity > 0 ? aInCapacity : 1),
+          m_Ghosts(aOutCapacity) {}
+    TwoQueueCache(const TwoQueueCache&) = delete;
+    TwoQueueCache& operator=(const TwoQueueCache&) = delete;
+
+    static bool contains(const Item& aItem)
+    {
+        return (aItem.*LinkMember).isResident();
+    }
+    // A hit, aItem must be resident.
+    void touch(Item& aItem)
+    {
+        AdaptiveCacheLink& sLink = aItem.*LinkMember;
+        if (AM != sLink.m_Queue)
+            return;
+        m_Lists[AM - A1IN].removeItem(sLink);
+        m_Lists[AM - A1IN].insertFront(sLink);
+    }
+    // A miss, aItem must not be resident.
+    template <class OnEvict>
+    void insert(Item& aItem, OnEvict aOnEvict)
+    {
+        typename Ghosts::Ghost* sGhost = m_Ghosts.find(aItem.*KeyMember);
+        uint8_t sQueue = A1IN;
+        if (nullptr != sGhost)
+        {
+            dropGhost(*sGhost);
+            sQueue = AM;
+        }
+        if (size() >= m_Capacity)
+            reclaim(aOnEvict);
+        AdaptiveCacheLink& sLink = aItem.*LinkMember;
+        sLink.m_Queue = sQueue;
+        m_Lists[sQueue - A1IN].insertFront(sLink);
+        ++m_Sizes[sQueue];
+    }
+    void insert(Item& aItem)
+    {
+        insert(aItem, adaptive_details::NoOp());
+    }
+    void remove(Item& aItem)
+    {
+        AdaptiveCacheLink& sLink = aItem.*LinkMember;
+        if (sLink.isResident())
+            pop(sLink);
+    }
+    size_t size() const { return m_Sizes[A1IN] + m_Sizes[AM]; }
+    size_t capacity() const { return m_Capacity; }
+    bool empty() const { return 0 == size(); }
+    size_t inSize() const { return m_Sizes[A1IN]; }
+    size_t mainSize() const { return m_Sizes[AM]; }
+    size_t outSize() const { return m_Sizes[A1OUT]; }
+    int selfCheck() const
+    {
+        for (size_t i = A1IN; i <= AM; i++)
+        {
+            if (m_Lists[i - A1IN].selfCheck() != 0 || adaptive_details::calcSize(m_Lists[i - A1IN]) != m_Sizes[i])
+                return 1;
+            for (const AdaptiveCacheLink& sLink : m_Lists[i - A1IN])
+                if (sLink.m_Queue != i)
+                    return 2;
+        }
+        if (m_Out.selfCheck() != 0 || adaptive_details::calcSize(m_Out) != m_Sizes[A1OUT] ||
+            m_Ghosts.size() != m_Sizes[A1OUT])
+            return 1;
+        if (size() > m_Capacity)
+            return 4;
+        return 0;
+    }
+
+private:
+    enum : uint8_t
+    {
+        NONE,
+        A1IN,
+        AM,
+        A1OUT,
+        LIST_COUNT
+    };
+    using Ghosts = adaptive_details::GhostDirectory<Key, Hash>;
+    using List = AutoList<AdaptiveCacheLink, &AdaptiveCacheLink::m_Link>;
+
+    size_t m_Capacity;
+    size_t m_InCapacity;
+    size_t m_Sizes[LIST_COUNT] = {0, 0, 0, 0};
+    List m_Lists[2];
+    typename Ghosts::List m_Out;
+    Ghosts m_Ghosts;
+
+    template <class OnEvict>
+    void reclaim(OnEvict& aOnEvict)
+    {
+        if (m_Sizes[A1IN] > m_InCapacity || 0 == m_Sizes[AM])
+        {
+            AdaptiveCacheLink& sVictim = m_Lists[A1IN - A1IN].back();
+            Item& sItem = *item(&sVictim);
+            pop(sVictim);
+            if (m_Ghosts.capacity() != 0)
+            {
+                if (m_Sizes[A1OUT] == m_Ghosts.capacity())
+                    dropGhost(m_Out.back());
+                m_Ghosts.add(sItem.*KeyMember, m_Out, A1OUT);
+                ++m_Sizes[A1OUT];
+            }
+            aOnEvict(sItem);
+        }
+        else
+        {
+            AdaptiveCacheLink& sVictim = m_Lists[AM - A1IN].back();
+            pop(sVictim);
+            aOnEvict(*item(&sVictim));
+        }
+    }
+    void pop(AdaptiveCacheLink& aLink)
+    {
+        m_Lists[aLink.m_Queue - A1IN].removeItem(aLink);
+        --m_Sizes[aLink.m_Queue];
+        aLink.m_Queue = NONE;
+    }
+    void dropGhost(typename Ghosts::Ghost& aGhost)
+    {
+        --m_Sizes[A1OUT];
+        m_Ghosts.release(aGhost);
+    }
+
+    static Item* item(AdaptiveCacheLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
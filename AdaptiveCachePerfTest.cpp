@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AdaptiveCache.hpp>
+#include <AutoList.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct Entry
+    {
+        AdaptiveCacheLink m_Link;
+        AutoListLink m_Lru;
+        uint32_t m_Key = 0;
+        bool m_Cached = false;
+    };
+
+    class LruPolicy
+    {
+    public:
+        explicit LruPolicy(size_t aCapacity) : m_Capacity(aCapacity) {}
+        static const char* name() { return "AutoList LRU"; }
+        bool access(Entry& e)
+        {
+            if (e.m_Cached)
+            {
+                m_List.removeItem(e);
+                m_List.insertFront(e);
+                return true;
+            }
+            if (m_Size == m_Capacity)
+            {
+                Entry& sVictim = m_List.back();
+                m_List.removeItem(sVictim);
+                sVictim.m_Cached = false;
+            }
+            else
+            {
+                ++m_Size;
+            }
+            m_List.insertFront(e);
+            e.m_Cached = true;
+            return false;
+        }
+    private:
+        AutoList<Entry, &Entry::m_Lru> m_List;
+        size_t m_Size = 0;
+        size_t m_Capacity;
+    };
+
+    template <class Cache>
+    class AdaptivePolicy
+    {
+    public:
+        explicit AdaptivePolicy(size_t aCapacity) : m_Cache(aCapacity) {}
+        bool access(Entry& e)
+        {
+            if (Cache::contains(e))
+            {
+                m_Cache.touch(e);
+                return true;
+            }
+            m_Cache.insert(e);
+            return false;
+        }
+    private:
+        Cache m_Cache;
+    };
+
+    struct ArcPolicy : AdaptivePolicy<ArcCache<Entry, &Entry::m_Link, uint32_t, &Entry::m_Key>>
+    {
+        using AdaptivePolicy::AdaptivePolicy;
+        static const char* name() { return "ARC"; }
+    };
+
+    struct TwoQueuePolicy : AdaptivePolicy<TwoQueueCache<Entry, &Entry::m_Link, uint32_t, &Entry::m_Key>>
+    {
+        using AdaptivePolicy::AdaptivePolicy;
+        static const char* name() { return "2Q"; }
+    };
+
+    static size_t SideEffect = 0;
+}
+
+// Keys of a trace are dense: 0..aKeyCount-1.
+struct Trace
+{
+    const char* m_Name;
+    size_t m_KeyCount;
+    std::vector<uint32_t> m_Keys;
+};
+
+const size_t KEY_COUNT = 1024 * 1024;
+const size_t TRACE_SIZE = 4 * 1024 * 1024;
+
+// Zipf-like keys (log-uniform ranks) spread over the key space.
+static uint32_t zipf(std::mt19937& aRand)
+{
+    std::uniform_real_distribution<double> sUniform(0., 1.);
+    size_t sRank = static_cast<size_t>(std::pow(double(KEY_COUNT), sUniform(aRand))) - 1;
+    return (sRank * 2654435761u) & (KEY_COUNT - 1);
+}
+
+static Trace zipfTrace()
+{
+    Trace sTrace{"zipf-like", KEY_COUNT, std::vector<uint32_t>(TRACE_SIZE)};
+    std::mt19937 sRand(1);
+    for (uint32_t& k : sTrace.m_Keys)
+        k = zipf(sRand);
+    return sTrace;
+}
+
+// Every 4th access belongs to a sequential scan.
+static Trace scanTrace()
+{
+    Trace sTrace{"zipf-like with scans", KEY_COUNT, std::vector<uint32_t>(TRACE_SIZE)};
+    std::mt19937 sRand(2);
+    size_t sScan = 0;
+    for (size_t i = 0; i < TRACE_SIZE; i++)
+        sTrace.m_Keys[i] = i % 4 == 0 ? (sScan++ * 2654435761u) & (KEY_COUNT - 1) : zipf(sRand);
+    return sTrace;
+}
+
+// Every other access is a loop over a set that is a bit larger than the
+// cache, the worst case of LRU.
+static Trace loopTrace(size_t aCapacity)
+{
+    Trace sTrace{"zipf-like with a loop", KEY_COUNT, std::vector<uint32_t>(TRACE_SIZE)};
+    std::mt19937 sRand(3);
+    size_t sLoop = aCapacity + aCapacity / 4;
+    for (size_t i = 0; i < TRACE_SIZE; i++)
+        sTrace.m_Keys[i] = i % 2 == 0 ? KEY_COUNT - 1 - (i / 2) % sLoop : zipf(sRand);
+    return sTrace;
+}
+
+// Text file with one key per line, keys are renumbered densely.
+static Trace fileTrace(const char* aFileName)
+{
+    Trace sTrace{aFileName, 0, std::vector<uint32_t>()};
+    std::ifstream sFile(aFileName);
+    std::unordered_map<uint64_t, uint32_t> sIds;
+    uint64_t sKey;
+    while (sFile >> sKey)
+    {
+        auto sRes = sIds.emplace(sKey, sIds.size());
+        sTrace.m_Keys.push_back(sRes.first->second);
+    }
+    sTrace.m_KeyCount = sIds.size();
+    return sTrace;
+}
+
+template <class Policy>
+static void run(const Trace& aTrace, size_t aCapacity)
+{
+    std::vector<Entry> sEntries(aTrace.m_KeyCount);
+    for (size_t i = 0; i < sEntries.size(); i++)
+        sEntries[i].m_Key = i;
+    Policy sPolicy(aCapacity);
+    size_t sHits = 0;
+
+    using namespace std::chrono;
+    high_resolution_clock::time_point sStart = high_resolution_clock::now();
+    for (uint32_t k : aTrace.m_Keys)
+        sHits += sPolicy.access(sEntries[k]);
+    duration<double> sSpan = duration_cast<duration<double>>(high_resolution_clock::now() - sStart);
+
+    size_t sOps = aTrace.m_Keys.size();
+    std::cout << "  " << Policy::name() << ": " << sOps / 1000000. / sSpan.count() << " Mrps, hit rate "
+              << 100. * sHits / sOps << "%" << std::endl;
+    SideEffect += sHits;
+}
+
+static void test(const Trace& aTrace, size_t aCapacity)
+{
+    std::cout << aTrace.m_Name << ", " << aTrace.m_Keys.size() << " accesses of " << aTrace.m_KeyCount
+              << " keys, capacity " << aCapacity << std::endl;
+    run<LruPolicy>(aTrace, aCapacity);
+    run<ArcPolicy>(aTrace, aCapacity);
+    run<TwoQueuePolicy>(aTrace, aCapacity);
+}
+
+// Usage: AdaptiveCachePerf.test [trace_file capacity]
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        test(fileTrace(argv[1]), std::stoul(argv[2]));
+    }
+    else
+    {
+        const size_t CAPACITIES[] = {KEY_COUNT / 64, KEY_COUNT / 8};
+        for (size_t sCapacity : CAPACITIES)
+        {
+            test(zipfTrace(), sCapacity);
+            test(scanTrace(), sCapacity);
+            test(loopTrace(sCapacity), sCapacity);
+        }
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AdaptiveCache.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Page
+{
+    int m_Id;
+    AdaptiveCacheLink m_Link;
+    Page(int aId = 0) : m_Id(aId) {}
+};
+
+using Arc = ArcCache<Page, &Page::m_Link, int, &Page::m_Id>;
+using TwoQueue = TwoQueueCache<Page, &Page::m_Link, int, &Page::m_Id>;
+
+template <class Cache>
+void access(Cache& aCache, Page& aPage, std::vector<int>& aEvicted)
+{
+    if (Cache::contains(aPage))
+        aCache.touch(aPage);
+    else
+        aCache.insert(aPage, [&aEvicted](Page& p) { aEvicted.push_back(p.m_Id); });
+}
+
+void arc_simple()
+{
+    ANNOUNCE();
+
+    Page sPages[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    Arc sCache(4);
+    std::vector<int> sEvicted;
+    for (int i = 0; i < 4; i++)
+        access(sCache, sPages[i], sEvicted);
+    CHECK(sCache.size(), size_t(4));
+    CHECK(sCache.t1Size(), size_t(4));
+    CHECK(sCache.selfCheck(), 0);
+
+    // A hit moves the page to T2.
+    access(sCache, sPages[1], sEvicted);
+    CHECK(sCache.t1Size(), size_t(3));
+    CHECK(sCache.t2Size(), size_t(1));
+    CHECK(sEvicted.empty());
+
+    // T1 is above the target (0), its LRU goes to B1.
+    access(sCache, sPages[4], sEvicted);
+    CHECK(sEvicted == std::vector<int>({0}));
+    CHECK(sCache.b1Size(), size_t(1));
+    CHECK(!Arc::contains(sPages[0]));
+    CHECK(sCache.selfCheck(), 0);
+
+    // A miss on a B1 ghost grows the target and brings the page to T2.
+    access(sCache, sPages[0], sEvicted);
+    CHECK(sCache.target(), size_t(1));
+    CHECK(Arc::contains(sPages[0]));
+    CHECK(sCache.t2Size(), size_t(2));
+    CHECK(sCache.size(), size_t(4));
+    CHECK(sEvicted == std::vector<int>({0, 2}));
+    CHECK(sCache.selfCheck(), 0);
+
+    for (Page& p : sPages)
+        sCache.remove(p);
+    CHECK(sCache.empty());
+    CHECK(sCache.selfCheck(), 0);
+}
+
+void two_queue_simple()
+{
+    ANNOUNCE();
+
+    Page sPages[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    TwoQueue sCache(4, 2, 2);
+    std::vector<int> sEvicted;
+    for (int i = 0; i < 4; i++)
+        access(sCache, sPages[i], sEvicted);
+    CHECK(sCache.inSize(), size_t(4));
+
+    // A1in is over its share, its tail is remembered in A1out.
+    access(sCache, sPages[4], sEvicted);
+    CHECK(sEvicted == std::vector<int>({0}));
+    CHECK(sCache.outSize(), size_t(1));
+
+    // A miss on a remembered key goes to Am.
+    access(sCache, sPages[0], sEvicted);
+    CHECK(sCache.mainSize(), size_t(1));
+    CHECK(sCache.outSize(), size_t(1));
+    CHECK(sEvicted == std::vector<int>({0, 1}));
+    CHECK(sCache.selfCheck(), 0);
+
+    // A1out is a FIFO of limited size.
+    access(sCache, sPages[5], sEvicted);
+    access(sCache, sPages[6], sEvicted);
+    CHECK(sCache.outSize(), size_t(2));
+    CHECK(sEvicted == std::vector<int>({0, 1, 2, 3}));
+    access(sCache, sPages[1], sEvicted);
+    CHECK(sCache.mainSize(), size_t(1));
+    CHECK(sCache.selfCheck(), 0);
+
+    for (Page& p : sPages)
+        sCache.remove(p);
+    CHECK(sCache.empty());
+    CHECK(sCache.selfCheck(), 0);
+}
+
+// Random accesses with random removals, evictions are checked against
+// the residency of pages.
+template <class Cache>
+void massive(Cache& aCache, size_t aCapacity)
+{
+    std::vector<Page> sPages(1000);
+    for (size_t i = 0; i < sPages.size(); i++)
+        sPages[i].m_Id = i;
+    std::vector<char> sResident(sPages.size(), 0);
+    size_t sResidentCount = 0;
+    bool sOk = true;
+    auto sOnEvict = [&](Page& p)
+    {
+        sOk = sOk && sResident[p.m_Id] == 1 && !Cache::contains(p);
+        sResident[p.m_Id] = 0;
+        --sResidentCount;
+    };
+    for (int sStep = 0; sStep < 100000; sStep++)
+    {
+        int i = rand() % 4 == 0 ? rand() % sPages.size() : rand() % (sPages.size() / 8);
+        Page& sPage = sPages[i];
+        if (Cache::contains(sPage))
+        {
+            sOk = sOk && sResident[i] == 1;
+            if (rand() % 64 == 0)
+            {
+                aCache.remove(sPage);
+                sResident[i] = 0;
+                --sResidentCount;
+            }
+            else
+            {
+                aCache.touch(sPage);
+            }
+        }
+        else
+        {
+            sOk = sOk && sResident[i] == 0;
+            aCache.insert(sPage, sOnEvict);
+            sResident[i] = 1;
+            ++sResidentCount;
+        }
+        sOk = sOk && aCache.size() == sResidentCount && sResidentCount <= aCapacity;
+        if (sStep % 1000 == 0)
+            sOk = sOk && aCache.selfCheck() == 0;
+    }
+    CHECK(sOk);
+    for (Page& p : sPages)
+        aCache.remove(p);
+    CHECK(aCache.empty());
+    CHECK(aCache.selfCheck(), 0);
+}
+
+void arc_massive()
+{
+    ANNOUNCE();
+
+    const size_t SIZES[] = {1, 2, 7, 100};
+    for (size_t sCapacity : SIZES)
+    {
+        Arc sCache(sCapacity);
+        massive(sCache, sCapacity);
+    }
+}
+
+void two_queue_massive()
+{
+    ANNOUNCE();
+
+    const size_t SIZES[] = {1, 2, 7, 100};
+    for (size_t sCapacity : SIZES)
+    {
+        TwoQueue sCache(sCapacity);
+        massive(sCache, sCapacity);
+    }
+}
+
+// A working set that is used repeatedly survives a long one-time scan.
+template <class Cache>
+void scan(Cache& aCache)
+{
+    const int HOT = 50;
+    std::vector<Page> sPages(10000);
+    for (size_t i = 0; i < sPages.size(); i++)
+        sPages[i].m_Id = i;
+    std::vector<int> sEvicted;
+    for (int sRound = 0; sRound < 4; sRound++)
+        for (int i = 0; i < HOT; i++)
+            access(aCache, sPages[i], sEvicted);
+    for (int i = HOT; i < 10000; i++)
+    {
+        access(aCache, sPages[i], sEvicted);
+        if (i % 100 == 0)
+            for (int j = 0; j < HOT; j++)
+                access(aCache, sPages[j], sEvicted);
+    }
+    int sHotResident = 0;
+    for (int i = 0; i < HOT; i++)
+        sHotResident += Cache::contains(sPages[i]);
+    CHECK(sHotResident, HOT);
+    CHECK(aCache.selfCheck(), 0);
+    for (Page& p : sPages)
+        aCache.remove(p);
+}
+
+void scan_resistance()
+{
+    ANNOUNCE();
+
+    Arc sArc(100);
+    scan(sArc);
+    TwoQueue sTwoQueue(100);
+    scan(sTwoQueue);
+}
+
+template <class Cache>
+void zero_capacity(Cache& aCache)
+{
+    Page sPages[3] = {0, 1, 2};
+    std::vector<int> sEvicted;
+    CHECK(aCache.capacity(), size_t(1));
+    for (Page& p : sPages)
+        access(aCache, p, sEvicted);
+    CHECK(sEvicted == std::vector<int>({0, 1}));
+    CHECK(aCache.size(), size_t(1));
+    CHECK(Cache::contains(sPages[2]));
+    CHECK(aCache.selfCheck(), 0);
+    for (Page& p : sPages)
+        aCache.remove(p);
+    CHECK(aCache.empty());
+}
+
+void zero_capacities()
+{
+    ANNOUNCE();
+
+    Arc sArc(0);
+    zero_capacity(sArc);
+    TwoQueue sTwoQueue(0);
+    zero_capacity(sTwoQueue);
+    TwoQueue sTwoQueueIn(0, 0, 0);
+    zero_capacity(sTwoQueueIn);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    arc_simple();
+    two_queue_simple();
+    arc_massive();
+    two_queue_massive();
+    scan_resistance();
+    zero_capacities();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
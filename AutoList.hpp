@@ -26,43 +26,62 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
 
+#include <ListStats.hpp>
 #include <Ring.hpp>
+#include <RingBatch.hpp>
 
-class AutoListLink
+// Stats is a statistics policy (see ListStats.hpp), only its static
+// onCopyJoin and onRelink are used by the link.
+template <class Stats>
+class BasicAutoListLink
 {
 public:
-    AutoListLink() : m_Ring(0) {}
-    AutoListLink(const AutoListLink& aLink)
+    BasicAutoListLink() : m_Ring(0) {}
+    BasicAutoListLink(const BasicAutoListLink& aLink)
     {
         if (aLink.isAlone())
+        {
             m_Ring.init();
+        }
         else
+        {
             aLink.m_Ring.add(&m_Ring);
+            Stats::onCopyJoin();
+        }
     }
-    AutoListLink(AutoListLink&& aLink) noexcept
+    BasicAutoListLink(BasicAutoListLink&& aLink) noexcept
     {
         aLink.m_Ring.add(&m_Ring);
         aLink.m_Ring.remove();
         aLink.m_Ring.init();
+        Stats::onRelink();
     }
-    ~AutoListLink()
+    ~BasicAutoListLink()
     {
         m_Ring.remove();
     }
-    AutoListLink& operator=(const AutoListLink& aLink)
+    BasicAutoListLink& operator=(const BasicAutoListLink& aLink)
     {
         m_Ring.remove();
         if (aLink.isAlone())
+        {
             m_Ring.init();
+        }
         else
+        {
             aLink.m_Ring.add(&m_Ring, false);
+            Stats::onCopyJoin();
+        }
         return *this;
     }
-    AutoListLink& operator=(AutoListLink&& aLink) noexcept
+    BasicAutoListLink& operator=(BasicAutoListLink&& aLink) noexcept
     {
         m_Ring.swap(&aLink.m_Ring);
+        Stats::onRelink();
         return *this;
     }
     bool isAlone() const
@@ -82,31 +101,35 @@ public:
     mutable Ring m_Ring;
 };
 
-template <class Item, AutoListLink Item::*LinkMember>
-class AutoList
+using AutoListLink = BasicAutoListLink<NoListStats>;
+
+// Stats is a statistics policy (see ListStats.hpp), stats are kept with
+// the list object and are not transferred by copy or move.
+template <class Stats, class Item, BasicAutoListLink<Stats> Item::*LinkMember>
+class BasicAutoList : private Stats
 {
 public:
-    AutoList() : m_Ring(0) {}
-    ~AutoList()
+    BasicAutoList() : m_Ring(0) {}
+    ~BasicAutoList()
     {
         m_Ring.remove();
     }
 
-    AutoList(const AutoList&) : m_Ring(0) {}
-    AutoList& operator=(const AutoList&)
+    BasicAutoList(const BasicAutoList&) : m_Ring(0) {}
+    BasicAutoList& operator=(const BasicAutoList&)
     {
         m_Ring.remove();
         m_Ring.init();
         return *this;
     }
 
-    AutoList(AutoList&& aList) noexcept
+    BasicAutoList(BasicAutoList&& aList) noexcept
     {
         aList.m_Ring.add(&m_Ring);
         aList.m_Ring.remove();
         aList.m_Ring.init();
     }
-    AutoList& operator=(AutoList&& aList) noexcept
+    BasicAutoList& operator=(BasicAutoList&& aList) noexcept
     {
         m_Ring.swap(&aList.m_Ring);
         return *this;
@@ -114,20 +137,43 @@ public:
 
     void insertFront(Item& aItem)
     {
+        Stats::onInsert();
         m_Ring.add(&((aItem.*LinkMember).m_Ring), false);
     }
     void insertBack(Item& aItem)
     {
+        Stats::onInsert();
         m_Ring.add(&((aItem.*LinkMember).m_Ring), true);
     }
     void insertAfter(Item& aExistingItem, Item& aNewItem)
     {
+        Stats::onInsert();
         (aExistingItem.*LinkMember).m_Ring.add(&((aNewItem.*LinkMember).m_Ring), false);
     }
     void removeItem(Item& aItem)
     {
+        Stats::onRemove();
         (aItem.*LinkMember).remove();
     }
+    // Removes aCount items at once, faster than one by one if the items are
+    // given in list order (see removeRingBatch).
+    void removeBatch(Item* const* aItems, size_t aCount)
+    {
+        for (size_t i = 0; i < aCount; i++)
+            Stats::onRemove();
+        removeRingBatch(aItems, aCount, [](Item* aItem) { return &(aItem->*LinkMember).m_Ring; });
+    }
+    // The same as removeBatch, but first sorts aItems by address (see
+    // sortRingBatch), for batches that are collected in random order.
+    void removeBatchSorted(Item** aItems, size_t aCount)
+    {
+        sortRingBatch(aItems, aCount);
+        removeBatch(aItems, aCount);
+    }
+    const Stats& stats() const
+    {
+        return *this;
+    }
     bool empty() const
     {
         return m_Ring.isAlone();
@@ -154,32 +200,90 @@ public:
     }
 
     template <class TItem, class TRing>
-    class iterator_common : std::iterator<std::bidirectional_iterator_tag, TItem>
+    class iterator_common : ListStatsRef<Stats>
     {
     public:
-        explicit iterator_common(TRing* aRing) : m_Ring(aRing) {}
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, const Stats* aStats) : ListStatsRef<Stats>(aStats), m_Ring(aRing) {}
         TItem& operator*() const { return *item(m_Ring); }
         TItem* operator->() const { return item(m_Ring); }
         bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
         bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
-        iterator_common& operator++() { m_Ring = m_Ring->m_Neigh[1]; return *this; }
-        iterator_common operator++(int) { iterator_common aTmp = *this; m_Ring = m_Ring->m_Neigh[1]; return aTmp; }
-        iterator_common& operator--() { m_Ring = m_Ring->m_Neigh[0]; return *this; }
-        iterator_common operator--(int) { iterator_common aTmp = *this; m_Ring = m_Ring->m_Neigh[0]; return aTmp; }
+        iterator_common& operator++() { this->onStep(); m_Ring = m_Ring->m_Neigh[1]; return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { this->onStep(); m_Ring = m_Ring->m_Neigh[0]; return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
     private:
+        friend class BasicAutoList;
         TRing* m_Ring;
     };
     using iterator = iterator_common<Item, Ring>;
     using const_iterator = iterator_common<const Item, const Ring>;
 
-    iterator begin() { return iterator(m_Ring.m_Neigh[1]); }
-    iterator end() { return iterator(&m_Ring); }
-    const_iterator begin() const { return const_iterator(m_Ring.m_Neigh[1]); }
-    const_iterator end() const { return const_iterator(&m_Ring); }
+    iterator begin() { return iterator(m_Ring.m_Neigh[1], this); }
+    iterator end() { return iterator(&m_Ring, this); }
+    const_iterator begin() const { return const_iterator(m_Ring.m_Neigh[1], this); }
+    const_iterator end() const { return const_iterator(&m_Ring, this); }
+
+    // Operations below relink whole ranges at once, O(1) regardless of the
+    // range size, stats do not count the items they move.
+
+    // Moves all items of aList before aPos.
+    void splice(iterator aPos, BasicAutoList& aList)
+    {
+        if (aList.empty())
+            return;
+        Ring* sFirst = aList.m_Ring.m_Neigh[1];
+        aList.m_Ring.remove();
+        aList.m_Ring.init();
+        aPos.m_Ring->join(sFirst);
+    }
+    // Moves items [aFirst, aLast) of aList before aPos, aPos must not be
+    // in the range.
+    void splice(iterator aPos, BasicAutoList&, iterator aFirst, iterator aLast)
+    {
+        Ring* sFirst = cut(aFirst.m_Ring, aLast.m_Ring);
+        if (nullptr != sFirst)
+            aPos.m_Ring->join(sFirst);
+    }
+    // Moves items after aItem to a new list.
+    BasicAutoList splitAfter(Item& aItem)
+    {
+        BasicAutoList sList;
+        Ring* sFirst = cut((aItem.*LinkMember).m_Ring.m_Neigh[1], &m_Ring);
+        if (nullptr != sFirst)
+            sFirst->join(&sList.m_Ring);
+        return sList;
+    }
+    // Moves items [aFirst, aLast) to a new list.
+    BasicAutoList extract(iterator aFirst, iterator aLast)
+    {
+        BasicAutoList sList;
+        Ring* sFirst = cut(aFirst.m_Ring, aLast.m_Ring);
+        if (nullptr != sFirst)
+            sFirst->join(&sList.m_Ring);
+        return sList;
+    }
 
 private:
     Ring m_Ring;
 
+    // Cuts [aFirst, aLast) out to a separate ring, returns its first element
+    // or nullptr if the range is empty.
+    static Ring* cut(Ring* aFirst, Ring* aLast)
+    {
+        if (aFirst == aLast)
+            return nullptr;
+        aFirst->split(aLast);
+        return aFirst;
+    }
+
     static Item* item(Ring* aLink)
     {
         const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
@@ -190,4 +294,7 @@ private:
         const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
         return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
     }
-};
\ No newline at end of file
+};
+
+template <class Item, AutoListLink Item::*LinkMember>
+using AutoList = BasicAutoList<NoListStats, Item, LinkMember>;
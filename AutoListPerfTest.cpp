@@ -24,6 +24,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <AutoList.hpp>
+#include <HeapScenarios.hpp>
 
 #include <chrono>
 #include <iostream>
@@ -233,9 +234,163 @@ static void big_sizes()
     checkpoint("Destruction (with removal)", SIZE);
 }
 
+// Batches of items are handed from a producer queue to a consumer queue.
+static void batch_handoff()
+{
+    const size_t SIZE = 1024 * 1024;
+    const size_t BATCH = 1024;
+    const size_t ROUNDS = 16;
+    std::vector<Object> sObjects(SIZE);
+    ObjectList sProducer;
+    ObjectList sConsumer;
+    for (Object& o : sObjects)
+        sProducer.insertBack(o);
+    checkpoint("", 0);
+
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        for (size_t i = 0; i < SIZE; i += BATCH)
+        {
+            for (size_t j = 0; j < BATCH; j++)
+            {
+                Object& o = sProducer.front();
+                sProducer.removeItem(o);
+                sConsumer.insertBack(o);
+            }
+        }
+        std::swap(sProducer, sConsumer);
+    }
+    checkpoint("Batch handoff (one by one)", SIZE * ROUNDS);
+
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        for (size_t i = 0; i < SIZE; i += BATCH)
+        {
+            ObjectList::iterator sLast = sProducer.begin();
+            for (size_t j = 0; j < BATCH; j++)
+                ++sLast;
+            sConsumer.splice(sConsumer.end(), sProducer, sProducer.begin(), sLast);
+        }
+        std::swap(sProducer, sConsumer);
+    }
+    checkpoint("Batch handoff (splice, batch end is searched)", SIZE * ROUNDS);
+
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        for (size_t i = 0; i < SIZE; i += BATCH)
+        {
+            ObjectList sBatch = sProducer.splitAfter(sObjects[i + BATCH - 1]);
+            sConsumer.splice(sConsumer.end(), sProducer);
+            sProducer.splice(sProducer.end(), sBatch);
+        }
+        std::swap(sProducer, sConsumer);
+    }
+    checkpoint("Batch handoff (split and splice)", SIZE * ROUNDS);
+}
+
+template <class Heap>
+static void huge_size(const char* aHeapName)
+{
+    const size_t SIZE = 2 * 1024 * 1024;
+    const size_t COUNT = 4 * 1024 * 1024;
+    std::vector<size_t> sRandom = randomIndexes(COUNT, SIZE);
+    std::cout << "Heap: " << aHeapName << std::endl;
+    checkpoint("", 0);
+
+    {
+        Heap sObjects(SIZE);
+        checkpoint("Construction", SIZE);
+        ObjectList sList;
+
+        for (size_t i = 0; i < SIZE; i++)
+            sList.insertFront(sObjects[i]);
+        checkpoint("Addition (front)", SIZE);
+
+        for (size_t i : sRandom)
+        {
+            Object& o = sObjects[i];
+            sList.removeItem(o);
+            sList.insertFront(o);
+        }
+        checkpoint("Random relink", COUNT);
+
+        for (const Object& o : sList)
+            SideEffect += reinterpret_cast<uintptr_t>(&o) >> 4;
+        checkpoint("Traversal", SIZE);
+
+        for (size_t i = 0; i < SIZE; i++)
+            sList.removeItem(sObjects[sRandom[i]]);
+        checkpoint("Random removing", SIZE);
+
+        for (size_t i = 0; i < SIZE; i++)
+            sList.removeItem(sObjects[i]);
+        checkpoint("Removing", SIZE);
+
+        // List in random order, a half of it is removed: random items or
+        // two of every four items in list order.
+        std::mt19937 sRand(SIZE);
+        std::vector<Object*> sOrder(SIZE);
+        for (size_t i = 0; i < SIZE; i++)
+            sOrder[i] = &sObjects[i];
+        std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+        std::vector<Object*> sRandomHalf(sOrder.begin(), sOrder.begin() + SIZE / 2);
+        std::shuffle(sRandomHalf.begin(), sRandomHalf.end(), sRand);
+        const char* NAMES[2][3] = {{"Random removing (one by one)", "Random removing (batch)",
+                                    "Random removing (sorted batch)"},
+                                   {"List order removing (one by one)", "List order removing (batch)",
+                                    "List order removing (sorted batch)"}};
+        for (int sListOrder = 0; sListOrder < 2; sListOrder++)
+        {
+            for (int sBatched = 0; sBatched < 3; sBatched++)
+            {
+                for (Object* o : sOrder)
+                    sList.insertBack(*o);
+                std::vector<Object*> sListOrderHalf;
+                size_t sPos = 0;
+                for (Object& o : sList)
+                    if (sPos++ % 4 < 2)
+                        sListOrderHalf.push_back(&o);
+                std::vector<Object*> sBatch = sListOrder ? sListOrderHalf : sRandomHalf;
+                checkpoint("", 0);
+
+                if (sBatched == 2)
+                    sList.removeBatchSorted(sBatch.data(), sBatch.size());
+                else if (sBatched)
+                    sList.removeBatch(sBatch.data(), sBatch.size());
+                else
+                    for (Object* o : sBatch)
+                        sList.removeItem(*o);
+                checkpoint(NAMES[sListOrder][sBatched], sBatch.size());
+
+                for (Object* o : sOrder)
+                    if (!o->m_Link.isAlone())
+                        sList.removeItem(*o);
+                checkpoint("", 0);
+            }
+        }
+
+        for (size_t i = 0; i < SIZE; i++)
+            if (rand_bool())
+                sList.insertFront(sObjects[i]);
+            else
+                sList.insertBack(sObjects[i]);
+        checkpoint("Addition (rand)", SIZE);
+    }
+    checkpoint("Destruction (with removal)", SIZE);
+}
+
+static void huge_sizes()
+{
+    huge_size<MallocHeap<Object>>("malloc");
+    huge_size<PoolHeap<Object>>("pool");
+    huge_size<FragmentedHeap<Object>>("fragmented");
+}
+
 int main()
 {
     small_sizes();
     big_sizes();
+    batch_handoff();
+    huge_sizes();
     std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
 }
\ No newline at end of file
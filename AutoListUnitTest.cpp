@@ -25,6 +25,7 @@
  */
 #include <AutoList.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -792,6 +793,197 @@ void massive_test()
     }
 }
 
+void batch_removal()
+{
+    ANNOUNCE();
+
+    const int COUNT = 100;
+    std::vector<Object> sObjects;
+    sObjects.reserve(COUNT);
+    for (int i = 0; i < COUNT; i++)
+        sObjects.emplace_back(i);
+
+    // Ring order differs from address order.
+    ObjectList sList;
+    std::vector<int> sOrder;
+    for (int i = 0; i < COUNT; i++)
+        sOrder.push_back(i * 37 % COUNT);
+    for (int i : sOrder)
+        sList.insertBack(sObjects[i]);
+
+    // Runs of various lengths, including the first and the last items.
+    std::vector<Object*> sBatch;
+    std::vector<int> sReference;
+    for (size_t i = 0; i < sOrder.size(); i++)
+    {
+        if (i % 10 < i / 10 || i == COUNT - 1)
+            sBatch.push_back(&sObjects[sOrder[i]]);
+        else
+            sReference.push_back(sOrder[i]);
+    }
+    sList.removeBatch(sBatch.data(), sBatch.size());
+    CHECK(sList, sReference);
+    bool sAlone = true;
+    for (const Object* sObj : sBatch)
+        sAlone = sAlone && sObj->m_Link.isAlone();
+    CHECK(sAlone);
+
+    sBatch.clear();
+    for (int i : sReference)
+        sBatch.push_back(&sObjects[i]);
+    sList.removeBatch(sBatch.data(), sBatch.size());
+    CHECK(sList, {});
+    sList.removeBatch(sBatch.data(), 0);
+    CHECK(sList, {});
+
+    // Every third item in reverse list order, sorted before removal.
+    for (int i : sOrder)
+        sList.insertBack(sObjects[i]);
+    sBatch.clear();
+    sReference.clear();
+    for (size_t i = sOrder.size(); i > 0; i--)
+        if (i % 3 == 0)
+            sBatch.push_back(&sObjects[sOrder[i - 1]]);
+    for (size_t i = 0; i < sOrder.size(); i++)
+        if ((i + 1) % 3 != 0)
+            sReference.push_back(sOrder[i]);
+    sList.removeBatchSorted(sBatch.data(), sBatch.size());
+    CHECK(sList, sReference);
+    CHECK(std::is_sorted(sBatch.begin(), sBatch.end()));
+    sAlone = true;
+    for (const Object* sObj : sBatch)
+        sAlone = sAlone && sObj->m_Link.isAlone();
+    CHECK(sAlone);
+    while (!sList.empty())
+        sList.removeItem(sList.front());
+}
+
+void splicing()
+{
+    ANNOUNCE();
+
+    std::vector<Object> sObjects;
+    sObjects.reserve(8);
+    for (int i = 0; i < 8; i++)
+        sObjects.emplace_back(i);
+    ObjectList sList1;
+    ObjectList sList2;
+    for (int i = 0; i < 4; i++)
+        sList1.insertBack(sObjects[i]);
+    for (int i = 4; i < 8; i++)
+        sList2.insertBack(sObjects[i]);
+
+    sList1.splice(sList1.end(), sList2);
+    CHECK(sList1, {0, 1, 2, 3, 4, 5, 6, 7});
+    CHECK(sList2, {});
+    sList1.splice(sList1.begin(), sList2);
+    CHECK(sList1, {0, 1, 2, 3, 4, 5, 6, 7});
+
+    ObjectList::iterator sFirst = sList1.begin();
+    ++sFirst;
+    ++sFirst;
+    ObjectList::iterator sLast = sFirst;
+    ++sLast;
+    ++sLast;
+    ++sLast;
+    ObjectList sExtracted = sList1.extract(sFirst, sLast);
+    CHECK(sList1, {0, 1, 5, 6, 7});
+    CHECK(sExtracted, {2, 3, 4});
+    CHECK(sList1.extract(sList1.begin(), sList1.begin()), {});
+
+    sFirst = sExtracted.begin();
+    ++sFirst;
+    sList1.splice(sList1.begin(), sExtracted, sFirst, sExtracted.end());
+    CHECK(sList1, {3, 4, 0, 1, 5, 6, 7});
+    CHECK(sExtracted, {2});
+    sList1.splice(sList1.end(), sExtracted, sExtracted.begin(), sExtracted.begin());
+    CHECK(sExtracted, {2});
+
+    ObjectList sTail = sList1.splitAfter(sObjects[1]);
+    CHECK(sList1, {3, 4, 0, 1});
+    CHECK(sTail, {5, 6, 7});
+    CHECK(sTail.splitAfter(sObjects[7]), {});
+    CHECK(sTail, {5, 6, 7});
+    ObjectList sAll = sTail.splitAfter(sObjects[5]);
+    CHECK(sTail, {5});
+    CHECK(sAll, {6, 7});
+
+    // Within one list.
+    sFirst = sList1.begin();
+    ++sFirst;
+    sList1.splice(sList1.end(), sList1, sList1.begin(), sFirst);
+    CHECK(sList1, {4, 0, 1, 3});
+    sList1.splice(sList1.begin(), sList1, ++sList1.begin(), sList1.end());
+    CHECK(sList1, {0, 1, 3, 4});
+}
+
+struct StatsTag {};
+using CountingStats = ListStats<StatsTag>;
+
+struct CountedObject
+{
+    int m_Data;
+    CountedObject(int aId) : m_Data(aId) {}
+    BasicAutoListLink<CountingStats> m_Link;
+};
+
+using CountedList = BasicAutoList<CountingStats, CountedObject, &CountedObject::m_Link>;
+
+void stats()
+{
+    ANNOUNCE();
+
+    static_assert(sizeof(ObjectList) == sizeof(Ring), "Disabled stats must cost nothing");
+    static_assert(sizeof(ObjectList::iterator) == sizeof(Ring*), "Disabled stats must cost nothing");
+    static_assert(sizeof(AutoListLink) == sizeof(Ring), "Disabled stats must cost nothing");
+
+    CountingStats::resetStatic();
+    CountedList sList;
+    CHECK(sList.stats().inserts(), size_t(0));
+
+    CountedObject a(1);
+    CountedObject b(2);
+    CountedObject c(3);
+    sList.insertFront(a);
+    sList.insertBack(b);
+    sList.insertAfter(a, c);
+    CHECK(sList.stats().inserts(), size_t(3));
+    CHECK(sList.stats().removes(), size_t(0));
+
+    size_t sSum = 0;
+    for (const CountedObject& sObj : sList)
+        sSum += sObj.m_Data;
+    CHECK(sSum, size_t(6));
+    CHECK(sList.stats().steps(), size_t(3));
+
+    {
+        CountedObject d(a);
+        CountedObject e(4);
+        CountedObject f(5);
+        e = b;
+        f = e;
+        CHECK(CountingStats::copyJoins(), size_t(3));
+        CHECK(CountingStats::relinks(), size_t(0));
+
+        CountedObject g(std::move(f));
+        e = std::move(g);
+        CHECK(CountingStats::relinks(), size_t(2));
+    }
+
+    sList.removeItem(c);
+    sList.removeItem(b);
+    CHECK(sList.stats().removes(), size_t(2));
+    CHECK(sList.stats().fronts(), size_t(0));
+    CHECK(sList.stats().backs(), size_t(0));
+
+    CountedList sList2(sList);
+    CHECK(sList2.stats().inserts(), size_t(0));
+
+    sList.stats().reset();
+    CHECK(sList.stats().inserts(), size_t(0));
+    CHECK(sList.stats().steps(), size_t(0));
+}
+
 } // anonymous namespace
 
 int main()
@@ -803,6 +995,9 @@ int main()
     iterations();
     link_ctors();
     massive_test();
+    batch_removal();
+    splicing();
+    stats();
 
     if (rc == 0)
         std::cout << "Success" << std::endl;
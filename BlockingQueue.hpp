@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include <AutoList.hpp>
+#include <Futex.hpp>
+
+// Intrusive blocking queue (FIFO) of AutoList items for passing items
+// between threads without allocation. Waiting is futex based (see
+// Futex.hpp): an operation that doesn't have to wait takes the lock once and
+// never enters the kernel unless somebody is parked.
+//
+// Batch push and pop move whole sublists under one lock acquisition, so the
+// synchronization cost is amortized over the batch. A bounded queue blocks
+// pushers while it has aCapacity items or more; a batch is accepted as a
+// whole, so it may exceed the capacity. After close() pushes fail, and pops
+// fail once the queue is empty; blocked threads are woken up.
+//
+// An item must not be destroyed while it's in the queue (that would unlink
+// it without the lock).
+template <class Item, AutoListLink Item::*LinkMember>
+class BlockingQueue
+{
+public:
+    using List = AutoList<Item, LinkMember>;
+
+    // Zero capacity means unbounded.
+    explicit BlockingQueue(size_t aCapacity = 0) : m_Capacity(aCapacity) {}
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    // Returns false if the queue is closed.
+    bool push(Item& aItem)
+    {
+        uint32_t sWake;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            if (!waitNotFull())
+                return false;
+            m_List.insertBack(aItem);
+            ++m_Size;
+            sWake = m_NotEmpty.notify(1);
+        }
+        m_NotEmpty.wake(sWake);
+        return true;
+    }
+    // Moves all items of aItems to the queue. Returns false if the queue is
+    // closed, aItems is left untouched then.
+    bool push(List& aItems)
+    {
+        size_t sCount = 0;
+        for (auto sItr = aItems.begin(); sItr != aItems.end(); ++sItr)
+            ++sCount;
+        if (0 == sCount)
+            return !closed();
+        uint32_t sWake;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            if (!waitNotFull())
+                return false;
+            m_List.splice(m_List.end(), aItems);
+            m_Size += sCount;
+            sWake = m_NotEmpty.notify(sCount);
+        }
+        m_NotEmpty.wake(sWake);
+        return true;
+    }
+    // Doesn't block, returns false if the queue is full or closed.
+    bool tryPush(Item& aItem)
+    {
+        uint32_t sWake;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            if (m_Closed || isFull())
+                return false;
+            m_List.insertBack(aItem);
+            ++m_Size;
+            sWake = m_NotEmpty.notify(1);
+        }
+        m_NotEmpty.wake(sWake);
+        return true;
+    }
+
+    // Returns nullptr if the queue is closed and empty.
+    Item* pop()
+    {
+        Item* sItem;
+        uint32_t sWake;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            if (!waitNotEmpty())
+                return nullptr;
+            sItem = &m_List.front();
+            m_List.removeItem(*sItem);
+            --m_Size;
+            sWake = m_NotFull.notify(1);
+        }
+        m_NotFull.wake(sWake);
+        return sItem;
+    }
+    // Moves up to aMax (> 0) first items to the back of aOut, waits for at
+    // least one. Moving all the items is O(1), otherwise the cut point is
+    // found in O(aMax). Returns the number of moved items, 0 if the queue is
+    // closed and empty.
+    size_t pop(List& aOut, size_t aMax)
+    {
+        size_t sCount;
+        uint32_t sWake;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            if (!waitNotEmpty())
+                return 0;
+            if (aMax >= m_Size)
+            {
+                sCount = m_Size;
+                aOut.splice(aOut.end(), m_List);
+            }
+            else
+            {
+                sCount = aMax;
+                auto sLast = m_List.begin();
+                for (size_t i = 0; i < aMax; i++)
+                    ++sLast;
+                aOut.splice(aOut.end(), m_List, m_List.begin(), sLast);
+            }
+            m_Size -= sCount;
+            sWake = m_NotFull.notify(UINT32_MAX);
+        }
+        m_NotFull.wake(sWake);
+        return sCount;
+    }
+    // Doesn't block, returns nullptr if the queue is empty.
+    Item* tryPop()
+    {
+        Item* sItem;
+        uint32_t sWake;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            if (0 == m_Size)
+                return nullptr;
+            sItem = &m_List.front();
+            m_List.removeItem(*sItem);
+            --m_Size;
+            sWake = m_NotFull.notify(1);
+        }
+        m_NotFull.wake(sWake);
+        return sItem;
+    }
+
+    void close()
+    {
+        uint32_t sWakeEmpty;
+        uint32_t sWakeFull;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex);
+            m_Closed = true;
+            sWakeEmpty = m_NotEmpty.notify(UINT32_MAX);
+            sWakeFull = m_NotFull.notify(UINT32_MAX);
+        }
+        m_NotEmpty.wake(sWakeEmpty);
+        m_NotFull.wake(sWakeFull);
+    }
+    bool closed() const
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        return m_Closed;
+    }
+    size_t size() const
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        return m_Size;
+    }
+    size_t capacity() const
+    {
+        return m_Capacity;
+    }
+
+private:
+    mutable FutexMutex m_Mutex;
+    List m_List;
+    size_t m_Size = 0;
+    size_t m_Capacity;
+    bool m_Closed = false;
+    FutexEvent m_NotEmpty;
+    FutexEvent m_NotFull;
+
+    bool isFull() const
+    {
+        return 0 != m_Capacity && m_Size >= m_Capacity;
+    }
+    // Under the lock, returns false if the queue is closed.
+    bool waitNotFull()
+    {
+        while (!m_Closed && isFull())
+            wait(m_NotFull);
+        return !m_Closed;
+    }
+    // Under the lock, returns false if the queue is closed and empty.
+    bool waitNotEmpty()
+    {
+        while (!m_Closed && 0 == m_Size)
+            wait(m_NotEmpty);
+        return 0 != m_Size;
+    }
+    void wait(FutexEvent& aEvent)
+    {
+        uint32_t sSequence = aEvent.prepareWait();
+        m_Mutex.unlock();
+        aEvent.wait(sSequence);
+        m_Mutex.lock();
+    }
+};
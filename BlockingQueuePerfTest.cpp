@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <BlockingQueue.hpp>
+#include <LatencyHistogram.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Message
+    {
+        AutoListLink m_Link;
+        uint64_t m_Stamp;
+        uint64_t m_Payload;
+    };
+
+    using MessageList = AutoList<Message, &Message::m_Link>;
+    using FutexQueue = BlockingQueue<Message, &Message::m_Link>;
+    using Histogram = LatencyHistogram<>;
+
+    // The same queue with std::mutex and std::condition_variable.
+    class CondVarQueue
+    {
+    public:
+        explicit CondVarQueue(size_t aCapacity) : m_Capacity(aCapacity) {}
+        bool push(Message& m)
+        {
+            std::unique_lock<std::mutex> sLock(m_Mutex);
+            m_NotFull.wait(sLock, [this]() { return m_Size < m_Capacity; });
+            m_List.insertBack(m);
+            ++m_Size;
+            sLock.unlock();
+            m_NotEmpty.notify_one();
+            return true;
+        }
+        Message* pop()
+        {
+            std::unique_lock<std::mutex> sLock(m_Mutex);
+            m_NotEmpty.wait(sLock, [this]() { return m_Size != 0 || m_Closed; });
+            if (0 == m_Size)
+                return nullptr;
+            Message* m = &m_List.front();
+            m_List.removeItem(*m);
+            --m_Size;
+            sLock.unlock();
+            m_NotFull.notify_one();
+            return m;
+        }
+        void close()
+        {
+            std::lock_guard<std::mutex> sGuard(m_Mutex);
+            m_Closed = true;
+            m_NotEmpty.notify_all();
+        }
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_NotEmpty;
+        std::condition_variable m_NotFull;
+        MessageList m_List;
+        size_t m_Size = 0;
+        size_t m_Capacity;
+        bool m_Closed = false;
+    };
+
+    const size_t CAPACITY = 1024;
+    const size_t BATCH = 64;
+    const size_t COUNT = 256 * 1024;
+
+    static size_t SideEffect = 0;
+    double TicksPerNs = 1.;
+}
+
+template <class Queue>
+static void pushOne(Queue& aQueue, std::vector<Message>& aMessages)
+{
+    for (Message& m : aMessages)
+    {
+        m.m_Stamp = tscStart();
+        aQueue.push(m);
+    }
+}
+
+static void pushBatch(FutexQueue& aQueue, std::vector<Message>& aMessages)
+{
+    MessageList sBatch;
+    for (size_t i = 0; i < aMessages.size(); i += BATCH)
+    {
+        for (size_t j = i; j < i + BATCH && j < aMessages.size(); j++)
+            sBatch.insertBack(aMessages[j]);
+        uint64_t sStamp = tscStart();
+        for (Message& m : sBatch)
+            m.m_Stamp = sStamp;
+        aQueue.push(sBatch);
+    }
+}
+
+template <class Queue>
+static void popOne(Queue& aQueue, Histogram& aHist)
+{
+    while (Message* m = aQueue.pop())
+    {
+        aHist.record(tscStop() - m->m_Stamp);
+        SideEffect += m->m_Payload;
+    }
+}
+
+static void popBatch(FutexQueue& aQueue, Histogram& aHist)
+{
+    MessageList sBatch;
+    while (aQueue.pop(sBatch, BATCH) != 0)
+    {
+        uint64_t sNow = tscStop();
+        while (!sBatch.empty())
+        {
+            Message& m = sBatch.front();
+            sBatch.removeItem(m);
+            aHist.record(sNow - m.m_Stamp);
+            SideEffect += m.m_Payload;
+        }
+    }
+}
+
+template <class Queue, class Push, class Pop>
+static void run(const char* aText, size_t aProducers, size_t aConsumers, Push aPush, Pop aPop)
+{
+    std::vector<std::vector<Message>> sMessages(aProducers, std::vector<Message>(COUNT));
+    for (std::vector<Message>& sSome : sMessages)
+        for (size_t i = 0; i < COUNT; i++)
+            sSome[i].m_Payload = i;
+    Queue sQueue(CAPACITY);
+    std::vector<Histogram> sHists(aConsumers);
+
+    using namespace std::chrono;
+    high_resolution_clock::time_point sStart = high_resolution_clock::now();
+    std::vector<std::thread> sConsumers;
+    for (size_t c = 0; c < aConsumers; c++)
+        sConsumers.emplace_back([&, c]() { aPop(sQueue, sHists[c]); });
+    std::vector<std::thread> sProducers;
+    for (size_t p = 0; p < aProducers; p++)
+        sProducers.emplace_back([&, p]() { aPush(sQueue, sMessages[p]); });
+    for (std::thread& sThread : sProducers)
+        sThread.join();
+    sQueue.close();
+    for (std::thread& sThread : sConsumers)
+        sThread.join();
+    duration<double> sSpan = duration_cast<duration<double>>(high_resolution_clock::now() - sStart);
+
+    Histogram sHist;
+    for (const Histogram& h : sHists)
+        sHist.merge(h);
+    std::streamsize sPrecision = std::cout.precision();
+    std::cout << "  " << std::left << std::setw(28) << aText << std::right
+              << aProducers * COUNT / 1000000. / sSpan.count() << " Mrps, latency (ns) p50 "
+              << std::fixed << std::setprecision(1) << sHist.percentile(50.) / TicksPerNs
+              << ", p99 " << sHist.percentile(99.) / TicksPerNs
+              << std::defaultfloat << std::setprecision(sPrecision) << std::endl;
+}
+
+static void test(size_t aProducers, size_t aConsumers)
+{
+    std::cout << aProducers << " producers, " << aConsumers << " consumers, capacity " << CAPACITY << std::endl;
+    run<CondVarQueue>("condition_variable, single", aProducers, aConsumers,
+                      pushOne<CondVarQueue>, popOne<CondVarQueue>);
+    run<FutexQueue>("futex, single", aProducers, aConsumers, pushOne<FutexQueue>, popOne<FutexQueue>);
+    run<FutexQueue>("futex, batch of 64", aProducers, aConsumers, pushBatch, popBatch);
+}
+
+int main()
+{
+    TicksPerNs = tscTicksPerNs();
+    test(1, 1);
+    test(4, 1);
+    test(4, 4);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
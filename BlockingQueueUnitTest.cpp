@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <BlockingQueue.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Message
+{
+    int m_Producer;
+    int m_Seq;
+    AutoListLink m_Link;
+    Message(int aSeq = 0) : m_Producer(0), m_Seq(aSeq) {}
+};
+
+using Queue = BlockingQueue<Message, &Message::m_Link>;
+using MessageList = Queue::List;
+
+std::vector<int> seqs(const MessageList& aList)
+{
+    std::vector<int> sRes;
+    for (const Message& m : aList)
+        sRes.push_back(m.m_Seq);
+    return sRes;
+}
+
+void futex_mutex()
+{
+    ANNOUNCE();
+
+    FutexMutex sMutex;
+    CHECK(sMutex.try_lock());
+    CHECK(!sMutex.try_lock());
+    sMutex.unlock();
+
+    size_t sCounter = 0;
+    std::vector<std::thread> sThreads;
+    for (int t = 0; t < 4; t++)
+    {
+        sThreads.emplace_back([&sMutex, &sCounter]()
+        {
+            for (int i = 0; i < 100000; i++)
+            {
+                std::lock_guard<FutexMutex> sGuard(sMutex);
+                ++sCounter;
+            }
+        });
+    }
+    for (std::thread& sThread : sThreads)
+        sThread.join();
+    CHECK(sCounter, size_t(400000));
+}
+
+void simple()
+{
+    ANNOUNCE();
+
+    Message sMessages[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    Queue sQueue(4);
+    CHECK(sQueue.tryPop() == nullptr);
+    for (int i = 0; i < 4; i++)
+        CHECK(sQueue.tryPush(sMessages[i]));
+    CHECK(!sQueue.tryPush(sMessages[4]));
+    CHECK(sQueue.size(), size_t(4));
+    CHECK(sQueue.pop() == &sMessages[0]);
+    CHECK(sQueue.tryPop() == &sMessages[1]);
+    CHECK(sQueue.push(sMessages[4]));
+
+    // Batch pop takes a prefix or everything.
+    MessageList sOut;
+    CHECK(sQueue.pop(sOut, 2), size_t(2));
+    CHECK(seqs(sOut) == std::vector<int>({2, 3}));
+    CHECK(sQueue.pop(sOut, 10), size_t(1));
+    CHECK(seqs(sOut) == std::vector<int>({2, 3, 4}));
+    CHECK(sQueue.size(), size_t(0));
+
+    // Batch push is accepted as a whole even above the capacity.
+    MessageList sIn;
+    for (int i = 5; i < 8; i++)
+        sIn.insertBack(sMessages[i]);
+    CHECK(sQueue.push(sOut));
+    CHECK(sOut.empty());
+    CHECK(sQueue.push(sIn));
+    CHECK(sQueue.size(), size_t(6));
+    CHECK(!sQueue.tryPush(sMessages[0]));
+    CHECK(sQueue.pop(sOut, 100), size_t(6));
+    CHECK(seqs(sOut) == std::vector<int>({2, 3, 4, 5, 6, 7}));
+
+    // Closed queue: pushes fail, pops drain the rest.
+    CHECK(sQueue.push(sMessages[0]));
+    sQueue.close();
+    CHECK(sQueue.closed());
+    CHECK(!sQueue.push(sMessages[1]));
+    CHECK(!sQueue.push(sOut));
+    CHECK(sOut.selfCheck(), 0);
+    CHECK(seqs(sOut).size(), size_t(6));
+    CHECK(sQueue.pop() == &sMessages[0]);
+    CHECK(sQueue.pop() == nullptr);
+    CHECK(sQueue.pop(sOut, 10), size_t(0));
+}
+
+void blocking()
+{
+    ANNOUNCE();
+
+    Message sMessages[4] = {0, 1, 2, 3};
+    {
+        // A consumer waits for a producer.
+        Queue sQueue;
+        std::atomic<Message*> sGot(nullptr);
+        std::thread sConsumer([&]() { sGot = sQueue.pop(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(sGot.load() == nullptr);
+        sQueue.push(sMessages[0]);
+        sConsumer.join();
+        CHECK(sGot.load() == &sMessages[0]);
+    }
+    {
+        // A producer waits for room.
+        Queue sQueue(1);
+        sQueue.push(sMessages[0]);
+        std::atomic<bool> sPushed(false);
+        std::thread sProducer([&]() { sPushed = sQueue.push(sMessages[1]); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(!sPushed.load());
+        CHECK(sQueue.pop() == &sMessages[0]);
+        sProducer.join();
+        CHECK(sPushed.load());
+        CHECK(sQueue.pop() == &sMessages[1]);
+    }
+    {
+        // Close wakes everybody up.
+        Queue sQueue;
+        std::vector<std::thread> sConsumers;
+        std::atomic<int> sNulls(0);
+        for (int i = 0; i < 3; i++)
+            sConsumers.emplace_back([&]() { sNulls += sQueue.pop() == nullptr; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        sQueue.close();
+        for (std::thread& sThread : sConsumers)
+            sThread.join();
+        CHECK(sNulls.load(), 3);
+    }
+}
+
+// N producers and M consumers, single and batch operations mixed. Every
+// message is delivered once, messages of one producer keep their order.
+void producers_consumers(size_t aCapacity, int aProducers, int aConsumers)
+{
+    const int COUNT = 20000;
+    std::vector<std::vector<Message>> sMessages(aProducers, std::vector<Message>(COUNT));
+    Queue sQueue(aCapacity);
+    std::vector<std::vector<int>> sReceived(aProducers * aConsumers);
+    std::atomic<bool> sOk(true);
+
+    std::vector<std::thread> sConsumers;
+    for (int c = 0; c < aConsumers; c++)
+    {
+        sConsumers.emplace_back([&, c]()
+        {
+            MessageList sBatch;
+            for (size_t n = 0; ; n++)
+            {
+                if (n % 2 == 0)
+                {
+                    Message* m = sQueue.pop();
+                    if (nullptr == m)
+                        break;
+                    sReceived[c * aProducers + m->m_Producer].push_back(m->m_Seq);
+                }
+                else
+                {
+                    if (0 == sQueue.pop(sBatch, 1 + n % 7))
+                        break;
+                    while (!sBatch.empty())
+                    {
+                        Message& m = sBatch.front();
+                        sBatch.removeItem(m);
+                        sReceived[c * aProducers + m.m_Producer].push_back(m.m_Seq);
+                    }
+                }
+            }
+        });
+    }
+    std::vector<std::thread> sProducers;
+    for (int p = 0; p < aProducers; p++)
+    {
+        sProducers.emplace_back([&, p]()
+        {
+            MessageList sBatch;
+            for (int i = 0; i < COUNT; )
+            {
+                if (i % 3 == 0)
+                {
+                    Message& m = sMessages[p][i];
+                    m.m_Producer = p;
+                    m.m_Seq = i++;
+                    sOk = sOk && sQueue.push(m);
+                    continue;
+                }
+                for (int k = 0; k < 5 && i < COUNT; k++)
+                {
+                    Message& m = sMessages[p][i];
+                    m.m_Producer = p;
+                    m.m_Seq = i++;
+                    sBatch.insertBack(m);
+                }
+                sOk = sOk && sQueue.push(sBatch);
+            }
+        });
+    }
+    for (std::thread& sThread : sProducers)
+        sThread.join();
+    sQueue.close();
+    for (std::thread& sThread : sConsumers)
+        sThread.join();
+
+    for (int p = 0; p < aProducers; p++)
+    {
+        std::vector<char> sSeen(COUNT, 0);
+        for (int c = 0; c < aConsumers; c++)
+        {
+            const std::vector<int>& sSeqs = sReceived[c * aProducers + p];
+            for (size_t i = 0; i < sSeqs.size(); i++)
+            {
+                sOk = sOk && (i == 0 || sSeqs[i - 1] < sSeqs[i]);
+                sOk = sOk && sSeen[sSeqs[i]] == 0;
+                sSeen[sSeqs[i]] = 1;
+            }
+        }
+        for (char sFlag : sSeen)
+            sOk = sOk && sFlag == 1;
+    }
+    CHECK(sOk.load());
+    CHECK(sQueue.size(), size_t(0));
+}
+
+void massive()
+{
+    ANNOUNCE();
+
+    producers_consumers(0, 1, 1);
+    producers_consumers(16, 1, 1);
+    producers_consumers(16, 4, 1);
+    producers_consumers(0, 3, 3);
+    producers_consumers(8, 3, 3);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    futex_mutex();
+    simple();
+    blocking();
+    massive();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <AutoList.hpp>
+
+// Cache line aware placement of list heads and links.
+//
+// Heads of lists used by different threads must not share a cache line, or
+// every insert and remove of one thread invalidates the line for another
+// (false sharing). CacheAligned pads a class to whole cache lines, and
+// CacheAlignedArray places such objects at aligned addresses in the heap
+// (plain new and std::vector don't honor over-alignment before C++17).
+//
+// An item's link is touched on every list step, so it should be on the same
+// cache line as the fields the traversal reads. CACHE_LINE_CHECK_LINK and
+// CACHE_LINE_CHECK_NEAR check that at compile time for standard layout
+// items; offsets are taken from the start of the item, so the result is
+// exact for items placed at cache line boundaries.
+
+#ifndef LISTS_CACHE_LINE_SIZE
+#define LISTS_CACHE_LINE_SIZE 64
+#endif
+
+constexpr size_t CACHE_LINE_SIZE = LISTS_CACHE_LINE_SIZE;
+
+// Whether [aOffset, aOffset + aSize) crosses a cache line boundary.
+constexpr bool crossesCacheLine(size_t aOffset, size_t aSize)
+{
+    return aSize != 0 && aOffset / CACHE_LINE_SIZE != (aOffset + aSize - 1) / CACHE_LINE_SIZE;
+}
+
+// Whether two ranges are on one cache line together.
+constexpr bool sameCacheLine(size_t aOffset1, size_t aSize1, size_t aOffset2, size_t aSize2)
+{
+    return !crossesCacheLine(aOffset1 < aOffset2 ? aOffset1 : aOffset2,
+                             (aOffset1 + aSize1 > aOffset2 + aSize2 ? aOffset1 + aSize1 : aOffset2 + aSize2) -
+                             (aOffset1 < aOffset2 ? aOffset1 : aOffset2));
+}
+
+#define CACHE_LINE_CHECK_LINK(Type, Link) \
+    static_assert(!crossesCacheLine(offsetof(Type, Link), sizeof(Type::Link)), \
+                  #Type "::" #Link " crosses a cache line boundary")
+
+#define CACHE_LINE_CHECK_NEAR(Type, Link, Hot) \
+    static_assert(sameCacheLine(offsetof(Type, Link), sizeof(Type::Link), offsetof(Type, Hot), sizeof(Type::Hot)), \
+                  #Type "::" #Link " and " #Type "::" #Hot " are not on one cache line")
+
+// T (a class) padded and aligned to whole cache lines.
+template <class T>
+struct alignas(CACHE_LINE_SIZE) CacheAligned : T
+{
+    using T::T;
+    CacheAligned() = default;
+};
+
+// Fixed size array of T placed at a cache line boundary, elements are
+// default constructed. Use with CacheAligned elements to give every element
+// its own cache lines.
+template <class T>
+class CacheAlignedArray
+{
+public:
+    explicit CacheAlignedArray(size_t aSize) : m_Size(aSize)
+    {
+        m_Memory = ::operator new(aSize * sizeof(T) + CACHE_LINE_SIZE);
+        uintptr_t sAddr = reinterpret_cast<uintptr_t>(m_Memory);
+        sAddr = (sAddr + CACHE_LINE_SIZE - 1) & ~uintptr_t(CACHE_LINE_SIZE - 1);
+        m_Data = reinterpret_cast<T*>(sAddr);
+        for (size_t i = 0; i < aSize; i++)
+            new (m_Data + i) T();
+    }
+    ~CacheAlignedArray()
+    {
+        for (size_t i = m_Size; i > 0; i--)
+            m_Data[i - 1].~T();
+        ::operator delete(m_Memory);
+    }
+    CacheAlignedArray(const CacheAlignedArray&) = delete;
+    CacheAlignedArray& operator=(const CacheAlignedArray&) = delete;
+
+    T& operator[](size_t aIndex) { return m_Data[aIndex]; }
+    const T& operator[](size_t aIndex) const { return m_Data[aIndex]; }
+    size_t size() const { return m_Size; }
+    T* begin() { return m_Data; }
+    T* end() { return m_Data + m_Size; }
+    const T* begin() const { return m_Data; }
+    const T* end() const { return m_Data + m_Size; }
+
+private:
+    void* m_Memory;
+    T* m_Data;
+    size_t m_Size;
+};
+
+template <class Item, AutoListLink Item::*LinkMember>
+using AlignedAutoList = CacheAligned<AutoList<Item, LinkMember>>;
+
+// Heads of per thread (per shard) lists, one cache line each.
+template <class Item, AutoListLink Item::*LinkMember>
+using AutoListHeads = CacheAlignedArray<AlignedAutoList<Item, LinkMember>>;
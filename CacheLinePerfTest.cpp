@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <CacheLine.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Item
+    {
+        AutoListLink m_Link;
+        uint64_t m_Key = 0;
+    };
+    using List = AutoList<Item, &Item::m_Link>;
+
+    // The link and the key are on the same cache line.
+    struct alignas(CACHE_LINE_SIZE) NearItem
+    {
+        AutoListLink m_Link;
+        uint64_t m_Key = 0;
+        char m_Cold[4 * CACHE_LINE_SIZE - sizeof(AutoListLink) - sizeof(uint64_t)];
+    };
+    CACHE_LINE_CHECK_LINK(NearItem, m_Link);
+    CACHE_LINE_CHECK_NEAR(NearItem, m_Link, m_Key);
+
+    // The link is among cold fields, far from the key.
+    struct alignas(CACHE_LINE_SIZE) FarItem
+    {
+        AutoListLink m_Link;
+        char m_Cold[2 * CACHE_LINE_SIZE];
+        uint64_t m_Key = 0;
+        char m_Cold2[2 * CACHE_LINE_SIZE - sizeof(AutoListLink) - sizeof(uint64_t)];
+    };
+    static_assert(!sameCacheLine(offsetof(FarItem, m_Link), sizeof(FarItem::m_Link),
+                                 offsetof(FarItem, m_Key), sizeof(FarItem::m_Key)), "must be far");
+
+    static uint64_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+// Every thread rotates its own list: the front item goes to the back, so
+// each operation writes the head.
+template <class Heads>
+static void rotate(Heads& aHeads, size_t aThreads, size_t aOps, const char* aText)
+{
+    const size_t ITEMS = 64;
+    std::vector<std::vector<Item>> sItems(aThreads, std::vector<Item>(ITEMS));
+    for (size_t t = 0; t < aThreads; t++)
+        for (Item& sItem : sItems[t])
+            aHeads[t].insertBack(sItem);
+
+    std::atomic<size_t> sReady{0};
+    std::atomic<bool> sGo{false};
+    std::vector<std::thread> sThreads;
+    for (size_t t = 0; t < aThreads; t++)
+        sThreads.emplace_back([&, t]()
+        {
+            auto& sList = aHeads[t];
+            sReady.fetch_add(1);
+            while (!sGo.load())
+                std::this_thread::yield();
+            for (size_t i = 0; i < aOps; i++)
+            {
+                Item& sItem = sList.front();
+                sList.removeItem(sItem);
+                sList.insertBack(sItem);
+            }
+        });
+    while (sReady.load() != aThreads)
+        std::this_thread::yield();
+    checkpoint("", 0);
+    sGo.store(true);
+    for (std::thread& sThread : sThreads)
+        sThread.join();
+    std::string sText = std::string(aText) + ", " + std::to_string(aThreads) + " threads";
+    checkpoint(sText.c_str(), aThreads * aOps);
+    for (size_t t = 0; t < aThreads; t++)
+    {
+        SideEffect += aHeads[t].front().m_Key;
+        while (!aHeads[t].empty())
+            aHeads[t].removeItem(aHeads[t].front());
+    }
+}
+
+static void falseSharing()
+{
+    const size_t OPS = 10 * 1000 * 1000;
+    size_t sMaxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    std::cout << "Per thread lists, head size " << sizeof(List) << " vs " << sizeof(AlignedAutoList<Item, &Item::m_Link>) << std::endl;
+    for (size_t sThreads = 1; sThreads <= sMaxThreads; sThreads *= 2)
+    {
+        std::vector<List> sPacked(sThreads);
+        rotate(sPacked, sThreads, OPS, "Packed heads");
+        AutoListHeads<Item, &Item::m_Link> sAligned(sThreads);
+        rotate(sAligned, sThreads, OPS, "Aligned heads");
+    }
+}
+
+template <class T>
+static void traverse(const char* aText)
+{
+    const size_t COUNT = 1024 * 1024;
+    const size_t ROUNDS = 5;
+    CacheAlignedArray<T> sItems(COUNT);
+    std::vector<size_t> sOrder(COUNT);
+    for (size_t i = 0; i < COUNT; i++)
+        sOrder[i] = i;
+    std::shuffle(sOrder.begin(), sOrder.end(), std::mt19937(COUNT));
+    AutoList<T, &T::m_Link> sList;
+    for (size_t i : sOrder)
+    {
+        sItems[i].m_Key = i;
+        sList.insertBack(sItems[i]);
+    }
+    checkpoint("", 0);
+    for (size_t r = 0; r < ROUNDS; r++)
+        for (const T& sItem : sList)
+            SideEffect += sItem.m_Key;
+    checkpoint(aText, ROUNDS * COUNT);
+    while (!sList.empty())
+        sList.removeItem(sList.front());
+}
+
+int main()
+{
+    falseSharing();
+    std::cout << "Traversal reading one field, " << sizeof(NearItem) << " byte items" << std::endl;
+    traverse<NearItem>("Link near the field");
+    traverse<FarItem>("Link far from the field");
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
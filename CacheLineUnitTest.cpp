@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <CacheLine.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    AutoListLink m_Link;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+CACHE_LINE_CHECK_LINK(Object, m_Link);
+CACHE_LINE_CHECK_NEAR(Object, m_Link, m_Data);
+
+struct Counted
+{
+    static int s_Alive;
+    int m_Value = 7;
+    Counted() { ++s_Alive; }
+    ~Counted() { --s_Alive; }
+};
+int Counted::s_Alive = 0;
+
+bool aligned(const void* aPtr)
+{
+    return reinterpret_cast<uintptr_t>(aPtr) % CACHE_LINE_SIZE == 0;
+}
+
+void layout()
+{
+    ANNOUNCE();
+
+    CHECK(!crossesCacheLine(0, 64));
+    CHECK(crossesCacheLine(1, 64));
+    CHECK(!crossesCacheLine(48, 16));
+    CHECK(crossesCacheLine(56, 16));
+    CHECK(!crossesCacheLine(60, 0));
+    CHECK(sameCacheLine(0, 16, 48, 16));
+    CHECK(sameCacheLine(48, 16, 0, 4));
+    CHECK(!sameCacheLine(0, 16, 60, 8));
+    CHECK(!sameCacheLine(100, 4, 0, 16));
+    CHECK(sameCacheLine(130, 4, 128, 16));
+}
+
+void aligned_heads()
+{
+    ANNOUNCE();
+
+    using List = AutoList<Object, &Object::m_Link>;
+    static_assert(sizeof(AlignedAutoList<Object, &Object::m_Link>) == CACHE_LINE_SIZE, "one line per head");
+    static_assert(alignof(AlignedAutoList<Object, &Object::m_Link>) == CACHE_LINE_SIZE, "aligned head");
+
+    AlignedAutoList<Object, &Object::m_Link> sLocal;
+    CHECK(aligned(&sLocal));
+
+    AutoListHeads<Object, &Object::m_Link> sHeads(5);
+    CHECK(sHeads.size(), size_t(5));
+    std::vector<Object> sObjects(20);
+    for (size_t i = 0; i < sHeads.size(); i++)
+    {
+        CHECK(aligned(&sHeads[i]));
+        CHECK(sHeads[i].empty());
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        sObjects[i].m_Data = i;
+        sHeads[i % 5].insertBack(sObjects[i]);
+    }
+    for (size_t i = 0; i < sHeads.size(); i++)
+    {
+        std::vector<int> sData;
+        for (const Object& sObject : sHeads[i])
+            sData.push_back(sObject.m_Data);
+        CHECK(sData == std::vector<int>({int(i), int(i) + 5, int(i) + 10, int(i) + 15}));
+        CHECK(sHeads[i].selfCheck(), 0);
+    }
+
+    List sMoved(std::move(sHeads[2]));
+    CHECK(sHeads[2].empty());
+    CHECK(sMoved.front().m_Data, 2);
+    for (Object& sObject : sObjects)
+        sObject.m_Link.remove();
+}
+
+void aligned_array()
+{
+    ANNOUNCE();
+
+    {
+        CacheAlignedArray<CacheAligned<Counted>> sArray(3);
+        CHECK(Counted::s_Alive, 3);
+        int sSum = 0;
+        for (const CacheAligned<Counted>& sItem : sArray)
+        {
+            CHECK(aligned(&sItem));
+            sSum += sItem.m_Value;
+        }
+        CHECK(sSum, 21);
+    }
+    CHECK(Counted::s_Alive, 0);
+    {
+        CacheAlignedArray<Counted> sPacked(10);
+        CHECK(aligned(sPacked.begin()));
+        CHECK(sPacked.end() - sPacked.begin(), std::ptrdiff_t(10));
+    }
+    CHECK(Counted::s_Alive, 0);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    layout();
+    aligned_heads();
+    aligned_array();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
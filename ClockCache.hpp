@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <Ring.hpp>
+
+// Intrusive CLOCK and CLOCK-Pro eviction engines. Resident items form a Ring
+// that is swept by a clock hand; a cache hit only sets the reference bit of
+// the item (see touch), the hand clears the bits and evicts the first item
+// that was not referenced since the previous sweep.
+//
+// touch may be called concurrently with anything, it's a relaxed atomic
+// store that is skipped if the bit is already set, so repeated hits don't
+// dirty the cache line. All the other methods must be serialized by the
+// user. Lookup by key is not a part of the engines. An item must be removed
+// before it's destroyed.
+
+class ClockLink
+{
+public:
+    enum State : uint8_t
+    {
+        UNTRACKED,
+        COLD,
+        HOT,
+        // Non-resident cold item in its test period (CLOCK-Pro only).
+        GHOST,
+    };
+
+    ClockLink() : m_Ring(0) {}
+    ClockLink(const ClockLink&) : m_Ring(0) {}
+    ClockLink& operator=(const ClockLink&) { return *this; }
+
+    void touch()
+    {
+        if (!m_Referenced.load(std::memory_order_relaxed))
+            m_Referenced.store(true, std::memory_order_relaxed);
+    }
+    bool isTracked() const { return UNTRACKED != m_State; }
+    bool isResident() const { return COLD == m_State || HOT == m_State; }
+
+    // Must be the first member, see link() of the engines.
+    Ring m_Ring;
+    std::atomic<bool> m_Referenced{false};
+    State m_State = UNTRACKED;
+    // Cold item in its test period (CLOCK-Pro only).
+    bool m_Test = false;
+};
+
+namespace clock_details
+{
+    struct NoOp
+    {
+        template <class T>
+        void operator()(T&) const {}
+    };
+
+    // Unlinks aRing moving every hand that points to it forward.
+    template <size_t N>
+    void unlink(Ring* aRing, Ring* (&aHands)[N])
+    {
+        Ring* sNext = aRing->isAlone() ? nullptr : aRing->m_Neigh[1];
+        for (Ring*& sHand : aHands)
+            if (sHand == aRing)
+                sHand = sNext;
+        aRing->remove();
+        aRing->init();
+    }
+}
+
+// Classic CLOCK, the resident items are in the ring only. New items are
+// inserted right behind the hand, i.e. they are the last to be inspected.
+template <class Item, ClockLink Item::*LinkMember>
+class ClockCache
+{
+public:
+    // A capacity of 0 is taken as 1: insert must have something to evict.
+    explicit ClockCache(size_t aCapacity) : m_Capacity(aCapacity > 0 ? aCapacity : 1) {}
+    ClockCache(const ClockCache&) = delete;
+    ClockCache& operator=(const ClockCache&) = delete;
+
+    static void touch(Item& aItem)
+    {
+        (aItem.*LinkMember).touch();
+    }
+    static bool contains(const Item& aItem)
+    {
+        return (aItem.*LinkMember).isResident();
+    }
+    // Inserts aItem, calls aOnEvict(Item&) for an evicted item if the cache
+    // is full. Inserting a resident item is the same as touching it.
+    template <class OnEvict>
+    void insert(Item& aItem, OnEvict aOnEvict)
+    {
+        ClockLink& sLink = aItem.*LinkMember;
+        if (sLink.isResident())
+        {
+            sLink.touch();
+            return;
+        }
+        if (m_Size >= m_Capacity)
+            aOnEvict(evict());
+        sLink.m_Referenced.store(false, std::memory_order_relaxed);
+        sLink.m_State = ClockLink::COLD;
+        if (nullptr == m_Hands[0])
+            m_Hands[0] = &sLink.m_Ring;
+        else
+            m_Hands[0]->add(&sLink.m_Ring, true);
+        ++m_Size;
+    }
+    void insert(Item& aItem)
+    {
+        insert(aItem, clock_details::NoOp());
+    }
+    // Advances the hand up to the first unreferenced item and evicts it.
+    // The cache must not be empty.
+    Item& evict()
+    {
+        for (;;)
+        {
+            ClockLink* sLink = link(m_Hands[0]);
+            m_Hands[0] = m_Hands[0]->m_Neigh[1];
+            if (!sLink->m_Referenced.load(std::memory_order_relaxed))
+            {
+                removeLink(sLink);
+                return *item(sLink);
+            }
+            sLink->m_Referenced.store(false, std::memory_order_relaxed);
+        }
+    }
+    void remove(Item& aItem)
+    {
+        ClockLink& sLink = aItem.*LinkMember;
+        if (sLink.isResident())
+            removeLink(&sLink);
+    }
+    size_t size() const { return m_Size; }
+    size_t capacity() const { return m_Capacity; }
+    bool empty() const { return 0 == m_Size; }
+    int selfCheck() const
+    {
+        if (nullptr == m_Hands[0])
+            return 0 == m_Size ? 0 : 1;
+        if (m_Hands[0]->selfCheck() != 0)
+            return 1;
+        return m_Hands[0]->calcSize() == m_Size ? 0 : 2;
+    }
+
+private:
+    size_t m_Capacity;
+    size_t m_Size = 0;
+    Ring* m_Hands[1] = {nullptr};
+
+    void removeLink(ClockLink* aLink)
+    {
+        clock_details::unlink(&aLink->m_Ring, m_Hands);
+        aLink->m_State = ClockLink::UNTRACKED;
+        --m_Size;
+    }
+    static ClockLink* link(Ring* aRing)
+    {
+        return reinterpret_cast<ClockLink*>(aRing);
+    }
+    static Item* item(ClockLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
+
+// CLOCK-Pro (Jiang, Chen, Zhang, USENIX 2005). Resident items are hot or
+// cold; the ring also keeps up to capacity() ghosts - evicted cold items
+// whose test period hasn't ended. A miss on a ghost means that its reuse
+// distance is short: it's reinserted as hot and the target number of cold
+// items grows. A test period that ends without reuse shrinks the target.
+// Three hands sweep the ring: the cold hand evicts, the hot hand demotes
+// unreferenced hot items and the test hand ends test periods.
+//
+// Evicted items are reported to aOnEvict(Item&), they remain tracked as
+// ghosts; ghosts that are dropped are reported to aOnForget(Item&). Both
+// callbacks must not modify the cache.
+template <class Item, ClockLink Item::*LinkMember>
+class ClockProCache
+{
+public:
+    // A capacity of 0 is taken as 1: there must be room for a cold item.
+    explicit ClockProCache(size_t aCapacity)
+        : m_Capacity(aCapacity > 0 ? aCapacity : 1), m_MinColdTarget(m_Capacity / 100 + 1), m_ColdTarget(m_MinColdTarget) {}
+    ClockProCache(const ClockProCache&) = delete;
+    ClockProCache& operator=(const ClockProCache&) = delete;
+
+    static void touch(Item& aItem)
+    {
+        (aItem.*LinkMember).touch();
+    }
+    static bool contains(const Item& aItem)
+    {
+        return (aItem.*LinkMember).isResident();
+    }
+    // Inserts an item that is not resident (a new one or a ghost).
+    // Inserting a resident item is the same as touching it.
+    template <class OnEvict, class OnForget>
+    void insert(Item& aItem, OnEvict aOnEvict, OnForget aOnForget)
+    {
+        ClockLink& sLink = aItem.*LinkMember;
+        if (sLink.isResident())
+        {
+            sLink.touch();
+            return;
+        }
+        Events<OnEvict, OnForget> sEvents{aOnEvict, aOnForget};
+        ClockLink::State sState = ClockLink::COLD;
+        if (ClockLink::GHOST == sLink.m_State)
+        {
+            if (m_ColdTarget < m_Capacity)
+                ++m_ColdTarget;
+            unlinkLink(&sLink);
+            --m_GhostCount;
+            sState = ClockLink::HOT;
+        }
+        while (m_HotCount + m_ColdCount >= m_Capacity)
+            runHandCold(sEvents);
+        sLink.m_Referenced.store(false, std::memory_order_relaxed);
+        sLink.m_State = sState;
+        sLink.m_Test = ClockLink::COLD == sState;
+        if (ClockLink::HOT == sState)
+            ++m_HotCount;
+        else
+            ++m_ColdCount;
+        insertHead(&sLink);
+    }
+    template <class OnEvict>
+    void insert(Item& aItem, OnEvict aOnEvict)
+    {
+        insert(aItem, aOnEvict, clock_details::NoOp());
+    }
+    void insert(Item& aItem)
+    {
+        insert(aItem, clock_details::NoOp(), clock_details::NoOp());
+    }
+    // Removes a resident item or a ghost.
+    void remove(Item& aItem)
+    {
+        ClockLink& sLink = aItem.*LinkMember;
+        switch (sLink.m_State)
+        {
+        case ClockLink::UNTRACKED:
+            return;
+        case ClockLink::COLD:
+            --m_ColdCount;
+            break;
+        case ClockLink::HOT:
+            --m_HotCount;
+            break;
+        case ClockLink::GHOST:
+            --m_GhostCount;
+            break;
+        }
+        unlinkLink(&sLink);
+        sLink.m_State = ClockLink::UNTRACKED;
+    }
+    size_t size() const { return m_HotCount + m_ColdCount; }
+    size_t hotCount() const { return m_HotCount; }
+    size_t coldCount() const { return m_ColdCount; }
+    size_t ghostCount() const { return m_GhostCount; }
+    size_t coldTarget() const { return m_ColdTarget; }
+    size_t capacity() const { return m_Capacity; }
+    bool empty() const { return 0 == size(); }
+    int selfCheck() const
+    {
+        const Ring* sAny = m_Hands[HAND_HOT];
+        size_t sTotal = m_HotCount + m_ColdCount + m_GhostCount;
+        if (nullptr == sAny)
+            return 0 == sTotal ? 0 : 1;
+        if (sAny->selfCheck() != 0)
+            return 1;
+        size_t sCounts[4] = {0, 0, 0, 0};
+        const Ring* sRing = sAny;
+        do
+        {
+            ++sCounts[reinterpret_cast<const ClockLink*>(sRing)->m_State];
+            sRing = sRing->m_Neigh[1];
+        } while (sRing != sAny);
+        if (sCounts[ClockLink::UNTRACKED] != 0 || sCounts[ClockLink::COLD] != m_ColdCount ||
+            sCounts[ClockLink::HOT] != m_HotCount || sCounts[ClockLink::GHOST] != m_GhostCount)
+            return 2;
+        if (size() > m_Capacity || m_GhostCount > m_Capacity)
+            return 3;
+        return 0;
+    }
+
+private:
+    enum
+    {
+        HAND_HOT,
+        HAND_COLD,
+        HAND_TEST,
+        HAND_COUNT
+    };
+    template <class OnEvict, class OnForget>
+    struct Events
+    {
+        OnEvict& m_OnEvict;
+        OnForget& m_OnForget;
+    };
+
+    size_t m_Capacity;
+    // The cold hand passes (size + ghosts) / cold items per eviction, so
+    // the cold part is kept at about 1% at least, as HIR blocks of LIRS.
+    size_t m_MinColdTarget;
+    size_t m_ColdTarget;
+    size_t m_HotCount = 0;
+    size_t m_ColdCount = 0;
+    size_t m_GhostCount = 0;
+    Ring* m_Hands[HAND_COUNT] = {nullptr, nullptr, nullptr};
+
+    // The head of the clock is right behind the hot hand.
+    void insertHead(ClockLink* aLink)
+    {
+        if (nullptr == m_Hands[HAND_HOT])
+        {
+            for (Ring*& sHand : m_Hands)
+                sHand = &aLink->m_Ring;
+            return;
+        }
+        m_Hands[HAND_HOT]->add(&aLink->m_Ring, true);
+    }
+    void unlinkLink(ClockLink* aLink)
+    {
+        clock_details::unlink(&aLink->m_Ring, m_Hands);
+    }
+    void advance(size_t aHand)
+    {
+        m_Hands[aHand] = m_Hands[aHand]->m_Neigh[1];
+    }
+
+    // Ends the test period of a cold item without reuse.
+    void endTest(ClockLink* aLink)
+    {
+        aLink->m_Test = false;
+        if (m_ColdTarget > m_MinColdTarget)
+            --m_ColdTarget;
+    }
+
+    template <class E>
+    void runHandCold(E& aEvents)
+    {
+        ClockLink* sLink = link(m_Hands[HAND_COLD]);
+        advance(HAND_COLD);
+        if (ClockLink::COLD == sLink->m_State)
+        {
+            if (sLink->m_Referenced.load(std::memory_order_relaxed))
+            {
+                sLink->m_Referenced.store(false, std::memory_order_relaxed);
+                if (sLink->m_Test)
+                {
+                    // Reused within the test period.
+                    sLink->m_State = ClockLink::HOT;
+                    sLink->m_Test = false;
+                    --m_ColdCount;
+                    ++m_HotCount;
+                }
+                else
+                {
+                    // A new test period at the head of the clock.
+                    sLink->m_Test = true;
+                    unlinkLink(sLink);
+                    insertHead(sLink);
+                }
+            }
+            else
+            {
+                --m_ColdCount;
+                if (sLink->m_Test)
+                {
+                    sLink->m_State = ClockLink::GHOST;
+                    ++m_GhostCount;
+                    aEvents.m_OnEvict(*item(sLink));
+                    while (m_GhostCount > m_Capacity)
+                        runHandTest(aEvents);
+                }
+                else
+                {
+                    unlinkLink(sLink);
+                    sLink->m_State = ClockLink::UNTRACKED;
+                    aEvents.m_OnEvict(*item(sLink));
+                }
+            }
+        }
+        while (m_HotCount > m_Capacity - m_ColdTarget)
+            runHandHot(aEvents);
+    }
+
+    template <class E>
+    void runHandHot(E& aEvents)
+    {
+        if (m_Hands[HAND_HOT] == m_Hands[HAND_TEST])
+            runHandTest(aEvents);
+        ClockLink* sLink = link(m_Hands[HAND_HOT]);
+        advance(HAND_HOT);
+        if (ClockLink::HOT == sLink->m_State)
+        {
+            if (sLink->m_Referenced.load(std::memory_order_relaxed))
+            {
+                sLink->m_Referenced.store(false, std::memory_order_relaxed);
+            }
+            else
+            {
+                sLink->m_State = ClockLink::COLD;
+                --m_HotCount;
+                ++m_ColdCount;
+            }
+        }
+    }
+
+    template <class E>
+    void runHandTest(E& aEvents)
+    {
+        if (m_Hands[HAND_TEST] == m_Hands[HAND_COLD] && m_ColdCount != 0)
+            runHandCold(aEvents);
+        ClockLink* sLink = link(m_Hands[HAND_TEST]);
+        if (ClockLink::GHOST == sLink->m_State)
+        {
+            // Moves the test hand forward.
+            unlinkLink(sLink);
+            sLink->m_State = ClockLink::UNTRACKED;
+            --m_GhostCount;
+            endTest(sLink);
+            aEvents.m_OnForget(*item(sLink));
+            return;
+        }
+        if (ClockLink::COLD == sLink->m_State && sLink->m_Test)
+            endTest(sLink);
+        advance(HAND_TEST);
+    }
+
+    static ClockLink* link(Ring* aRing)
+    {
+        return reinterpret_cast<ClockLink*>(aRing);
+    }
+    static Item* item(ClockLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
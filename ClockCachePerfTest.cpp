@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <ClockCache.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Entry
+    {
+        ClockLink m_Clock;
+        AutoListLink m_Lru;
+        std::atomic<bool> m_Cached{false};
+    };
+
+    // Every policy is a complete thread safe cache: a hit is checked by the
+    // m_Cached flag (a stand-in for a concurrent hash table lookup), a miss
+    // takes the lock and inserts the entry.
+    class LruPolicy
+    {
+    public:
+        explicit LruPolicy(size_t aCapacity) : m_Capacity(aCapacity) {}
+        static const char* name() { return "AutoList LRU"; }
+        bool access(Entry& e)
+        {
+            // LRU has to relink the entry on every hit.
+            std::lock_guard<std::mutex> sGuard(m_Mutex);
+            if (e.m_Cached.load(std::memory_order_relaxed))
+            {
+                m_List.removeItem(e);
+                m_List.insertFront(e);
+                return true;
+            }
+            if (m_Size == m_Capacity)
+            {
+                Entry& sVictim = m_List.back();
+                m_List.removeItem(sVictim);
+                sVictim.m_Cached.store(false, std::memory_order_relaxed);
+            }
+            else
+            {
+                ++m_Size;
+            }
+            m_List.insertFront(e);
+            e.m_Cached.store(true, std::memory_order_relaxed);
+            return false;
+        }
+    private:
+        std::mutex m_Mutex;
+        AutoList<Entry, &Entry::m_Lru> m_List;
+        size_t m_Size = 0;
+        size_t m_Capacity;
+    };
+
+    template <class Cache>
+    class ClockPolicy
+    {
+    public:
+        explicit ClockPolicy(size_t aCapacity) : m_Cache(aCapacity) {}
+        bool access(Entry& e)
+        {
+            if (e.m_Cached.load(std::memory_order_acquire))
+            {
+                Cache::touch(e);
+                return true;
+            }
+            std::lock_guard<std::mutex> sGuard(m_Mutex);
+            if (Cache::contains(e))
+            {
+                Cache::touch(e);
+                return true;
+            }
+            m_Cache.insert(e, [](Entry& v) { v.m_Cached.store(false, std::memory_order_release); });
+            e.m_Cached.store(true, std::memory_order_release);
+            return false;
+        }
+    private:
+        std::mutex m_Mutex;
+        Cache m_Cache;
+    };
+
+    struct ClockCachePolicy : ClockPolicy<ClockCache<Entry, &Entry::m_Clock>>
+    {
+        using ClockPolicy::ClockPolicy;
+        static const char* name() { return "CLOCK"; }
+    };
+
+    struct ClockProCachePolicy : ClockPolicy<ClockProCache<Entry, &Entry::m_Clock>>
+    {
+        using ClockPolicy::ClockPolicy;
+        static const char* name() { return "CLOCK-Pro"; }
+    };
+
+    static size_t SideEffect = 0;
+}
+
+const size_t KEY_COUNT = 1024 * 1024;
+const size_t CAPACITY = KEY_COUNT / 16;
+const size_t TRACE_SIZE = 2 * 1024 * 1024;
+
+// Zipf-like keys (log-uniform ranks), spread over the key space. With
+// aScans every 8th access belongs to a sequential scan of the key space.
+static std::vector<uint32_t> makeTrace(unsigned aSeed, bool aScans)
+{
+    std::mt19937 sRand(aSeed);
+    std::uniform_real_distribution<double> sUniform(0., 1.);
+    std::vector<uint32_t> sTrace(TRACE_SIZE);
+    size_t sScan = aSeed * 7919;
+    for (size_t i = 0; i < TRACE_SIZE; i++)
+    {
+        size_t sRank = static_cast<size_t>(std::pow(double(KEY_COUNT), sUniform(sRand))) - 1;
+        if (aScans && i % 8 == 0)
+            sRank = sScan++;
+        sTrace[i] = (sRank * 2654435761u) & (KEY_COUNT - 1);
+    }
+    return sTrace;
+}
+
+template <class Policy>
+static void run(const std::vector<std::vector<uint32_t>>& aTraces, size_t aThreads)
+{
+    std::vector<Entry> sEntries(KEY_COUNT);
+    Policy sPolicy(CAPACITY);
+    std::atomic<size_t> sHits(0);
+    std::atomic<uint64_t> sSum(0);
+    auto sWorker = [&](size_t aIndex)
+    {
+        size_t sLocalHits = 0;
+        uint64_t sLocalSum = 0;
+        for (uint32_t k : aTraces[aIndex])
+        {
+            if (sPolicy.access(sEntries[k]))
+            {
+                ++sLocalHits;
+                sLocalSum += k;
+            }
+        }
+        sHits += sLocalHits;
+        sSum += sLocalSum;
+    };
+
+    using namespace std::chrono;
+    high_resolution_clock::time_point sStart = high_resolution_clock::now();
+    std::vector<std::thread> sThreads;
+    for (size_t i = 1; i < aThreads; i++)
+        sThreads.emplace_back(sWorker, i);
+    sWorker(0);
+    for (std::thread& sThread : sThreads)
+        sThread.join();
+    duration<double> sSpan = duration_cast<duration<double>>(high_resolution_clock::now() - sStart);
+
+    size_t sOps = aThreads * TRACE_SIZE;
+    std::cout << "  " << Policy::name() << ": " << sOps / 1000000. / sSpan.count() << " Mrps, hit rate "
+              << 100. * sHits / sOps << "%" << std::endl;
+    SideEffect += sSum;
+}
+
+static void test(bool aScans)
+{
+    std::cout << KEY_COUNT << " keys, capacity " << CAPACITY << ", zipf-like reads"
+              << (aScans ? " with scans" : "") << std::endl;
+    // At least 4 threads, so that the lock contention is visible even on
+    // a small machine.
+    size_t sMaxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    std::vector<std::vector<uint32_t>> sTraces;
+    for (size_t i = 0; i < sMaxThreads; i++)
+        sTraces.push_back(makeTrace(i + 1, aScans));
+    for (size_t sThreads = 1; sThreads <= sMaxThreads; sThreads *= 2)
+    {
+        std::cout << sThreads << " threads" << std::endl;
+        run<LruPolicy>(sTraces, sThreads);
+        run<ClockCachePolicy>(sTraces, sThreads);
+        run<ClockProCachePolicy>(sTraces, sThreads);
+    }
+}
+
+int main()
+{
+    test(false);
+    test(true);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <ClockCache.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Page
+{
+    int m_Id;
+    ClockLink m_Link;
+    Page(int aId = 0) : m_Id(aId) {}
+};
+
+using Clock = ClockCache<Page, &Page::m_Link>;
+using ClockPro = ClockProCache<Page, &Page::m_Link>;
+
+void clock_simple()
+{
+    ANNOUNCE();
+
+    Page sPages[5] = {0, 1, 2, 3, 4};
+    Clock sCache(3);
+    CHECK(sCache.empty());
+    std::vector<int> sEvicted;
+    auto sOnEvict = [&sEvicted](Page& p) { sEvicted.push_back(p.m_Id); };
+
+    for (int i = 0; i < 3; i++)
+        sCache.insert(sPages[i], sOnEvict);
+    CHECK(sCache.size(), size_t(3));
+    CHECK(sCache.selfCheck(), 0);
+    CHECK(sEvicted.empty());
+    CHECK(Clock::contains(sPages[1]));
+
+    // The oldest unreferenced page goes first.
+    sCache.insert(sPages[3], sOnEvict);
+    CHECK(sEvicted == std::vector<int>({0}));
+    CHECK(!Clock::contains(sPages[0]));
+
+    // Referenced pages get the second chance.
+    Clock::touch(sPages[1]);
+    Clock::touch(sPages[2]);
+    sCache.insert(sPages[4], sOnEvict);
+    CHECK(sEvicted == std::vector<int>({0, 3}));
+    CHECK(sCache.size(), size_t(3));
+    CHECK(sCache.selfCheck(), 0);
+
+    // The bits were cleared by the sweep.
+    sCache.insert(sPages[0], sOnEvict);
+    CHECK(sEvicted == std::vector<int>({0, 3, 1}));
+
+    sCache.remove(sPages[2]);
+    CHECK(!Clock::contains(sPages[2]));
+    CHECK(sCache.size(), size_t(2));
+    CHECK(sCache.selfCheck(), 0);
+    sCache.remove(sPages[2]);
+    CHECK(sCache.size(), size_t(2));
+    CHECK(&sCache.evict() == &sPages[4]);
+    CHECK(&sCache.evict() == &sPages[0]);
+    CHECK(sCache.empty());
+    CHECK(sCache.selfCheck(), 0);
+}
+
+// Random accesses, every page is checked to be resident exactly when the
+// cache says so and the evictions are reported once.
+template <class Cache>
+void random_workload(Cache& aCache, std::vector<Page>& aPages, size_t aCapacity, bool& aOk)
+{
+    std::vector<char> sResident(aPages.size(), 0);
+    size_t sResidentCount = 0;
+    auto sOnEvict = [&](Page& p)
+    {
+        aOk = aOk && sResident[p.m_Id] == 1;
+        sResident[p.m_Id] = 0;
+        --sResidentCount;
+    };
+    for (int sStep = 0; sStep < 100000; sStep++)
+    {
+        int i = rand() % 4 == 0 ? rand() % aPages.size() : rand() % (aPages.size() / 8);
+        Page& sPage = aPages[i];
+        if (Cache::contains(sPage))
+        {
+            aOk = aOk && sResident[i] == 1;
+            if (rand() % 64 == 0)
+            {
+                aCache.remove(sPage);
+                sResident[i] = 0;
+                --sResidentCount;
+            }
+            else
+            {
+                Cache::touch(sPage);
+            }
+        }
+        else
+        {
+            aOk = aOk && sResident[i] == 0;
+            aCache.insert(sPage, sOnEvict);
+            sResident[i] = 1;
+            ++sResidentCount;
+        }
+        aOk = aOk && aCache.size() == sResidentCount && sResidentCount <= aCapacity;
+        if (sStep % 1000 == 0)
+            aOk = aOk && aCache.selfCheck() == 0;
+    }
+    for (Page& p : aPages)
+        aCache.remove(p);
+    aOk = aOk && aCache.empty() && aCache.selfCheck() == 0;
+}
+
+void clock_massive()
+{
+    ANNOUNCE();
+
+    const size_t SIZES[] = {1, 2, 7, 100};
+    for (size_t sCapacity : SIZES)
+    {
+        std::vector<Page> sPages(1000);
+        for (size_t i = 0; i < sPages.size(); i++)
+            sPages[i].m_Id = i;
+        Clock sCache(sCapacity);
+        bool sOk = true;
+        random_workload(sCache, sPages, sCapacity, sOk);
+        CHECK(sOk);
+    }
+}
+
+void clock_pro_simple()
+{
+    ANNOUNCE();
+
+    Page sPages[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    ClockPro sCache(4);
+    std::vector<int> sEvicted;
+    std::vector<int> sForgotten;
+    auto sOnEvict = [&sEvicted](Page& p) { sEvicted.push_back(p.m_Id); };
+    auto sOnForget = [&sForgotten](Page& p) { sForgotten.push_back(p.m_Id); };
+
+    for (int i = 0; i < 4; i++)
+        sCache.insert(sPages[i], sOnEvict, sOnForget);
+    CHECK(sCache.size(), size_t(4));
+    CHECK(sCache.coldCount(), size_t(4));
+    CHECK(sCache.selfCheck(), 0);
+
+    // A new page evicts the oldest cold one, it stays as a ghost.
+    sCache.insert(sPages[4], sOnEvict, sOnForget);
+    CHECK(sEvicted == std::vector<int>({0}));
+    CHECK(!ClockPro::contains(sPages[0]));
+    CHECK(sPages[0].m_Link.isTracked());
+    CHECK(sCache.ghostCount(), size_t(1));
+    CHECK(sCache.selfCheck(), 0);
+
+    // A miss on the ghost brings it back as a hot page.
+    size_t sTarget = sCache.coldTarget();
+    sCache.insert(sPages[0], sOnEvict, sOnForget);
+    CHECK(ClockPro::contains(sPages[0]));
+    CHECK(sCache.size(), size_t(4));
+    CHECK(sCache.coldTarget() >= sTarget);
+    CHECK(sCache.selfCheck(), 0);
+
+    // A referenced cold page in its test period is promoted, the next cold
+    // page is evicted instead.
+    ClockPro::touch(sPages[2]);
+    sCache.insert(sPages[5], sOnEvict, sOnForget);
+    CHECK(ClockPro::contains(sPages[2]));
+    CHECK(!ClockPro::contains(sPages[3]));
+    CHECK(sEvicted.back(), 3);
+    CHECK(sCache.hotCount(), size_t(2));
+    CHECK(sCache.size(), size_t(4));
+    CHECK(sCache.selfCheck(), 0);
+
+    for (int i = 6; i < 8; i++)
+        sCache.insert(sPages[i], sOnEvict, sOnForget);
+    CHECK(sCache.size(), size_t(4));
+    CHECK(sCache.ghostCount() <= sCache.capacity());
+    CHECK(sCache.selfCheck(), 0);
+
+    for (Page& p : sPages)
+        sCache.remove(p);
+    CHECK(sCache.empty());
+    CHECK(sCache.ghostCount(), size_t(0));
+    for (Page& p : sPages)
+        CHECK(!p.m_Link.isTracked());
+}
+
+void clock_pro_massive()
+{
+    ANNOUNCE();
+
+    const size_t SIZES[] = {1, 2, 7, 100};
+    for (size_t sCapacity : SIZES)
+    {
+        std::vector<Page> sPages(1000);
+        for (size_t i = 0; i < sPages.size(); i++)
+            sPages[i].m_Id = i;
+        ClockPro sCache(sCapacity);
+        bool sOk = true;
+        random_workload(sCache, sPages, sCapacity, sOk);
+        CHECK(sOk);
+    }
+}
+
+void zero_capacity()
+{
+    ANNOUNCE();
+
+    Page sPages[3] = {0, 1, 2};
+    std::vector<int> sEvicted;
+    auto sOnEvict = [&sEvicted](Page& p) { sEvicted.push_back(p.m_Id); };
+    auto sOnForget = [](Page&) {};
+
+    Clock sClock(0);
+    CHECK(sClock.capacity(), size_t(1));
+    sClock.insert(sPages[0], sOnEvict);
+    sClock.insert(sPages[1], sOnEvict);
+    CHECK(sEvicted == std::vector<int>({0}));
+    CHECK(sClock.size(), size_t(1));
+    CHECK(sClock.selfCheck(), 0);
+    sClock.remove(sPages[1]);
+
+    sEvicted.clear();
+    ClockPro sClockPro(0);
+    CHECK(sClockPro.capacity(), size_t(1));
+    for (Page& p : sPages)
+        sClockPro.insert(p, sOnEvict, sOnForget);
+    CHECK(sEvicted == std::vector<int>({0, 1}));
+    CHECK(sClockPro.size(), size_t(1));
+    CHECK(sClockPro.selfCheck(), 0);
+    for (Page& p : sPages)
+        sClockPro.remove(p);
+}
+
+// A hot working set survives a long one-time scan under CLOCK-Pro.
+void clock_pro_scan()
+{
+    ANNOUNCE();
+
+    const int CAPACITY = 100;
+    const int HOT = 50;
+    std::vector<Page> sPages(10000);
+    for (size_t i = 0; i < sPages.size(); i++)
+        sPages[i].m_Id = i;
+    ClockPro sCache(CAPACITY);
+    auto sAccess = [&sCache](Page& p)
+    {
+        if (ClockPro::contains(p))
+            ClockPro::touch(p);
+        else
+            sCache.insert(p);
+    };
+    for (int sRound = 0; sRound < 20; sRound++)
+        for (int i = 0; i < HOT; i++)
+            sAccess(sPages[i]);
+    for (int i = HOT; i < 10000; i++)
+    {
+        sAccess(sPages[i]);
+        if (i % 100 == 0)
+            for (int j = 0; j < HOT; j++)
+                sAccess(sPages[j]);
+    }
+    int sHotResident = 0;
+    for (int i = 0; i < HOT; i++)
+        sHotResident += ClockPro::contains(sPages[i]);
+    CHECK(sHotResident, HOT);
+    CHECK(sCache.selfCheck(), 0);
+    for (Page& p : sPages)
+        sCache.remove(p);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    clock_simple();
+    clock_massive();
+    clock_pro_simple();
+    clock_pro_massive();
+    clock_pro_scan();
+    zero_capacity();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
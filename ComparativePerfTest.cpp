@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <OffsetAutoList.hpp>
+#include <SlightlyOrderedList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <vector>
+
+// Runs the same workloads over intrusive lists and their usual replacements
+// and prints one table of Mrps, a row per workload and list size.
+// Every container manages two arrays of items: A (primary) and B (shadow).
+
+namespace
+{
+
+size_t SideEffect = 0;
+
+struct AutoListImpl
+{
+    struct Item
+    {
+        AutoListLink m_Link;
+        uint64_t m_Value;
+    };
+    AutoList<Item, &Item::m_Link> m_List;
+    std::vector<Item> m_A;
+    std::vector<Item> m_B;
+
+    explicit AutoListImpl(size_t aSize) : m_A(aSize), m_B(aSize)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_A[i].m_Value = i;
+    }
+    void insertA(size_t i) { m_List.insertFront(m_A[i]); }
+    void relinkA(size_t i) { m_List.removeItem(m_A[i]); m_List.insertFront(m_A[i]); }
+    void copyAB(size_t i) { m_B[i] = m_A[i]; }
+    void moveAB(size_t i) { m_B[i] = std::move(m_A[i]); }
+    void removeB(size_t i) { m_List.removeItem(m_B[i]); }
+    uint64_t traverse() const
+    {
+        uint64_t sRes = 0;
+        for (const Item& sItem : m_List)
+            sRes += sItem.m_Value;
+        return sRes;
+    }
+};
+
+struct OffsetAutoListImpl
+{
+    struct Item
+    {
+        OffsetAutoListLink m_Link;
+        uint64_t m_Value;
+    };
+    OffsetAutoList<Item, &Item::m_Link> m_List;
+    std::vector<Item> m_A;
+    std::vector<Item> m_B;
+
+    explicit OffsetAutoListImpl(size_t aSize) : m_A(aSize), m_B(aSize)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_A[i].m_Value = i;
+    }
+    void insertA(size_t i) { m_List.insertFront(m_A[i]); }
+    void relinkA(size_t i) { m_List.removeItem(m_A[i]); m_List.insertFront(m_A[i]); }
+    void copyAB(size_t i) { m_B[i] = m_A[i]; }
+    void moveAB(size_t i) { m_B[i] = std::move(m_A[i]); }
+    void removeB(size_t i) { m_List.removeItem(m_B[i]); }
+    uint64_t traverse() const
+    {
+        uint64_t sRes = 0;
+        for (const Item& sItem : m_List)
+            sRes += sItem.m_Value;
+        return sRes;
+    }
+};
+
+struct SlightlyOrderedListImpl
+{
+    struct Item
+    {
+        SlightlyOrderedListLink m_Link;
+        uint64_t m_Value;
+    };
+    SlightlyOrderedList<Item, &Item::m_Link> m_List;
+    std::vector<Item> m_A;
+    std::vector<Item> m_B;
+
+    explicit SlightlyOrderedListImpl(size_t aSize) : m_A(aSize), m_B(aSize)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_A[i].m_Value = i;
+    }
+    void insertA(size_t i) { m_List.insert(m_A[i]); }
+    void relinkA(size_t i) { m_List.remove(m_A[i]); m_List.insert(m_A[i]); }
+    void copyAB(size_t i) { m_B[i].m_Value = m_A[i].m_Value; m_List.insert(m_B[i]); }
+    void moveAB(size_t i) { m_B[i].m_Value = m_A[i].m_Value; m_List.remove(m_A[i]); m_List.insert(m_B[i]); }
+    void removeB(size_t i) { m_List.remove(m_B[i]); }
+    uint64_t traverse() const
+    {
+        uint64_t sRes = 0;
+        for (const Item& sItem : m_List)
+            sRes += sItem.m_Value;
+        return sRes;
+    }
+};
+
+// Items keep an iterator to their node in the list.
+struct StdListPtrImpl
+{
+    struct Item
+    {
+        std::list<Item*>::iterator m_Pos;
+        uint64_t m_Value;
+    };
+    std::list<Item*> m_List;
+    std::vector<Item> m_A;
+    std::vector<Item> m_B;
+
+    explicit StdListPtrImpl(size_t aSize) : m_A(aSize), m_B(aSize)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_A[i].m_Value = i;
+    }
+    void insertA(size_t i) { m_A[i].m_Pos = m_List.insert(m_List.begin(), &m_A[i]); }
+    void relinkA(size_t i) { m_List.splice(m_List.begin(), m_List, m_A[i].m_Pos); }
+    void copyAB(size_t i)
+    {
+        m_B[i].m_Value = m_A[i].m_Value;
+        m_B[i].m_Pos = m_List.insert(std::next(m_A[i].m_Pos), &m_B[i]);
+    }
+    void moveAB(size_t i)
+    {
+        m_B[i].m_Value = m_A[i].m_Value;
+        m_B[i].m_Pos = m_A[i].m_Pos;
+        *m_B[i].m_Pos = &m_B[i];
+    }
+    void removeB(size_t i) { m_List.erase(m_B[i].m_Pos); }
+    uint64_t traverse() const
+    {
+        uint64_t sRes = 0;
+        for (const Item* sItem : m_List)
+            sRes += sItem->m_Value;
+        return sRes;
+    }
+};
+
+// Items live in list nodes, A and B are iterators to them.
+struct StdListImpl
+{
+    struct Item
+    {
+        uint64_t m_Value;
+    };
+    std::list<Item> m_List;
+    std::vector<std::list<Item>::iterator> m_A;
+    std::vector<std::list<Item>::iterator> m_B;
+
+    explicit StdListImpl(size_t aSize) : m_A(aSize), m_B(aSize) {}
+    void insertA(size_t i) { m_A[i] = m_List.insert(m_List.begin(), Item{i}); }
+    void relinkA(size_t i) { m_List.splice(m_List.begin(), m_List, m_A[i]); }
+    void copyAB(size_t i) { m_B[i] = m_List.insert(std::next(m_A[i]), *m_A[i]); }
+    void moveAB(size_t i) { m_B[i] = m_List.insert(m_A[i], std::move(*m_A[i])); m_List.erase(m_A[i]); }
+    void removeB(size_t i) { m_List.erase(m_B[i]); }
+    uint64_t traverse() const
+    {
+        uint64_t sRes = 0;
+        for (const Item& sItem : m_List)
+            sRes += sItem.m_Value;
+        return sRes;
+    }
+};
+
+// Unordered vector of pointers, items keep their index, removal swaps with last.
+struct VectorImpl
+{
+    struct Item
+    {
+        size_t m_Index;
+        uint64_t m_Value;
+    };
+    std::vector<Item*> m_Vector;
+    std::vector<Item> m_A;
+    std::vector<Item> m_B;
+
+    explicit VectorImpl(size_t aSize) : m_A(aSize), m_B(aSize)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_A[i].m_Value = i;
+    }
+    void push(Item& aItem)
+    {
+        aItem.m_Index = m_Vector.size();
+        m_Vector.push_back(&aItem);
+    }
+    void pop(Item& aItem)
+    {
+        Item* sLast = m_Vector.back();
+        sLast->m_Index = aItem.m_Index;
+        m_Vector[aItem.m_Index] = sLast;
+        m_Vector.pop_back();
+    }
+    void insertA(size_t i) { push(m_A[i]); }
+    void relinkA(size_t i) { pop(m_A[i]); push(m_A[i]); }
+    void copyAB(size_t i) { m_B[i].m_Value = m_A[i].m_Value; push(m_B[i]); }
+    void moveAB(size_t i)
+    {
+        m_B[i].m_Value = m_A[i].m_Value;
+        m_B[i].m_Index = m_A[i].m_Index;
+        m_Vector[m_B[i].m_Index] = &m_B[i];
+    }
+    void removeB(size_t i) { pop(m_B[i]); }
+    uint64_t traverse() const
+    {
+        uint64_t sRes = 0;
+        for (const Item* sItem : m_Vector)
+            sRes += sItem->m_Value;
+        return sRes;
+    }
+};
+
+enum Workload
+{
+    INSERT,
+    TRAVERSE,
+    RELINK,
+    COPY,
+    MOVE,
+    REMOVE,
+    WORKLOAD_COUNT
+};
+
+const char* WORKLOAD_NAMES[WORKLOAD_COUNT] = {
+    "Bulk insert",
+    "Traversal",
+    "Random relink",
+    "Copy",
+    "Move",
+    "Bulk remove",
+};
+
+const char* IMPL_NAMES[] = {
+    "AutoList",
+    "OffsetAutoList",
+    "SlightlyOrdered",
+    "list<Item*>",
+    "list<Item>",
+    "vector<Item*>",
+};
+
+const size_t IMPL_COUNT = sizeof(IMPL_NAMES) / sizeof(IMPL_NAMES[0]);
+
+class Timer
+{
+public:
+    Timer() : m_Was(std::chrono::high_resolution_clock::now()) {}
+    double mrps(size_t aOpCount)
+    {
+        using namespace std::chrono;
+        high_resolution_clock::time_point sNow = high_resolution_clock::now();
+        duration<double> sSpan = duration_cast<duration<double>>(sNow - m_Was);
+        m_Was = sNow;
+        return aOpCount / 1000000. / sSpan.count();
+    }
+private:
+    std::chrono::high_resolution_clock::time_point m_Was;
+};
+
+template <class Impl>
+void run(size_t aSize, const std::vector<size_t>& aOrder, const std::vector<size_t>& aRandom,
+         double aResults[WORKLOAD_COUNT])
+{
+    Impl sImpl(aSize);
+    const size_t TRAVERSE_COUNT = std::max<size_t>(1, 16 * 1024 * 1024 / aSize);
+
+    Timer sTimer;
+    for (size_t i : aOrder)
+        sImpl.insertA(i);
+    aResults[INSERT] = sTimer.mrps(aSize);
+
+    for (size_t i = 0; i < TRAVERSE_COUNT; i++)
+        SideEffect += sImpl.traverse();
+    aResults[TRAVERSE] = sTimer.mrps(aSize * TRAVERSE_COUNT);
+
+    for (size_t i : aRandom)
+        sImpl.relinkA(i);
+    aResults[RELINK] = sTimer.mrps(aRandom.size());
+
+    for (size_t i : aOrder)
+        sImpl.copyAB(i);
+    aResults[COPY] = sTimer.mrps(aSize);
+
+    for (size_t i : aOrder)
+        sImpl.removeB(i);
+    sTimer.mrps(aSize);
+
+    for (size_t i : aOrder)
+        sImpl.moveAB(i);
+    aResults[MOVE] = sTimer.mrps(aSize);
+
+    for (size_t i : aOrder)
+        sImpl.removeB(i);
+    aResults[REMOVE] = sTimer.mrps(aSize);
+}
+
+void compare(size_t aSize, double aResults[][WORKLOAD_COUNT][IMPL_COUNT], size_t aSizeNo)
+{
+    std::mt19937 sRand(aSize);
+    std::vector<size_t> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sOrder[i] = i;
+    std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+    std::vector<size_t> sRandom(std::max<size_t>(aSize, 1024 * 1024));
+    for (size_t& sVal : sRandom)
+        sVal = sRand() % aSize;
+
+    double sRes[IMPL_COUNT][WORKLOAD_COUNT];
+    run<AutoListImpl>(aSize, sOrder, sRandom, sRes[0]);
+    run<OffsetAutoListImpl>(aSize, sOrder, sRandom, sRes[1]);
+    run<SlightlyOrderedListImpl>(aSize, sOrder, sRandom, sRes[2]);
+    run<StdListPtrImpl>(aSize, sOrder, sRandom, sRes[3]);
+    run<StdListImpl>(aSize, sOrder, sRandom, sRes[4]);
+    run<VectorImpl>(aSize, sOrder, sRandom, sRes[5]);
+    for (size_t i = 0; i < IMPL_COUNT; i++)
+        for (size_t j = 0; j < WORKLOAD_COUNT; j++)
+            aResults[aSizeNo][j][i] = sRes[i][j];
+}
+
+} // anonymous namespace
+
+int main()
+{
+    const size_t SIZES[] = {1024, 64 * 1024, 1024 * 1024};
+    const size_t SIZE_COUNT = sizeof(SIZES) / sizeof(SIZES[0]);
+    double sResults[SIZE_COUNT][WORKLOAD_COUNT][IMPL_COUNT];
+    for (size_t i = 0; i < SIZE_COUNT; i++)
+        compare(SIZES[i], sResults, i);
+
+    std::cout << std::left << std::setw(16) << "Workload (Mrps)" << std::right << std::setw(9) << "Size";
+    for (const char* sName : IMPL_NAMES)
+        std::cout << std::setw(17) << sName;
+    std::cout << std::endl;
+    for (size_t j = 0; j < WORKLOAD_COUNT; j++)
+    {
+        for (size_t i = 0; i < SIZE_COUNT; i++)
+        {
+            std::cout << std::left << std::setw(16) << WORKLOAD_NAMES[j] << std::right << std::setw(9) << SIZES[i];
+            for (size_t k = 0; k < IMPL_COUNT; k++)
+                std::cout << std::setw(17) << std::fixed << std::setprecision(2) << sResults[i][j][k];
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
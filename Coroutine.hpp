@@ -0,0 +1,584 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+// Requires C++20, see LISTS_COROUTINES in CMakeLists.txt.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <AutoList.hpp>
+#include <BlockingQueue.hpp>
+#include <Futex.hpp>
+#include <PairingHeap.hpp>
+
+// Coroutine executors with intrusive ready and wait lists. The promise of a
+// CoTask embeds a CoroWaiter; since a suspended coroutine waits for one thing
+// at a time, that single link is enough to put it into a ready queue, a wait
+// list of an async primitive or (via the awaiter, that lives in the frame
+// too) a timer heap. Suspending and resuming never allocate, only creating
+// a coroutine allocates its frame.
+//
+// CoroLoop runs coroutines in the calling thread, CoroThreadPool runs them
+// on worker threads. AsyncMutex, AsyncEvent and AsyncSemaphore work with
+// both; a coroutine is always resumed through the executor it was spawned
+// on. Awaiting is supported in CoTask coroutines only.
+
+using CoroClock = std::chrono::steady_clock;
+
+class CoroExecutor;
+
+struct CoroWaiter
+{
+    AutoListLink m_Link;
+    std::coroutine_handle<> m_Handle;
+    CoroExecutor* m_Executor = nullptr;
+};
+
+// Sleeping coroutine, lives in the frame while it sleeps.
+struct CoroTimer
+{
+    PairingHeapLink m_HeapLink;
+    CoroClock::time_point m_Deadline;
+    CoroWaiter* m_Waiter = nullptr;
+
+    bool operator<(const CoroTimer& aTimer) const
+    {
+        return m_Deadline < aTimer.m_Deadline;
+    }
+};
+
+using CoroWaitList = AutoList<CoroWaiter, &CoroWaiter::m_Link>;
+using CoroTimerHeap = PairingHeap<CoroTimer, &CoroTimer::m_HeapLink>;
+
+// Fire-and-forget coroutine, started by CoroExecutor::spawn. Its frame is
+// destroyed when it completes; an unspawned CoTask destroys it unstarted.
+class CoTask
+{
+public:
+    struct promise_type
+    {
+        CoroWaiter m_Waiter;
+
+        CoTask get_return_object()
+        {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<promise_type> aHandle) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    CoTask(CoTask&& aTask) noexcept : m_Handle(aTask.m_Handle)
+    {
+        aTask.m_Handle = nullptr;
+    }
+    CoTask& operator=(CoTask&&) = delete;
+    ~CoTask()
+    {
+        if (m_Handle)
+            m_Handle.destroy();
+    }
+
+private:
+    friend class CoroExecutor;
+    Handle m_Handle;
+    explicit CoTask(Handle aHandle) : m_Handle(aHandle) {}
+};
+
+class CoroExecutor
+{
+public:
+    CoroExecutor() = default;
+    CoroExecutor(const CoroExecutor&) = delete;
+    CoroExecutor& operator=(const CoroExecutor&) = delete;
+    virtual ~CoroExecutor() = default;
+
+    void spawn(CoTask aTask)
+    {
+        CoTask::Handle sHandle = aTask.m_Handle;
+        aTask.m_Handle = nullptr;
+        CoroWaiter& sWaiter = sHandle.promise().m_Waiter;
+        sWaiter.m_Handle = sHandle;
+        sWaiter.m_Executor = this;
+        m_Live.fetch_add(1, std::memory_order_relaxed);
+        post(sWaiter);
+    }
+    // Number of spawned coroutines that haven't completed yet.
+    size_t live() const
+    {
+        return m_Live.load(std::memory_order_acquire);
+    }
+
+    // Queues a suspended coroutine to be resumed. The coroutine may be
+    // resumed (and even destroyed) before post returns.
+    virtual void post(CoroWaiter& aWaiter) = 0;
+    // Posts aTimer->m_Waiter at aTimer->m_Deadline.
+    virtual void addTimer(CoroTimer& aTimer) = 0;
+
+protected:
+    std::atomic<uint32_t> m_Live{0};
+
+private:
+    friend struct CoTask::promise_type::FinalAwaiter;
+    void finished()
+    {
+        if (1 == m_Live.fetch_sub(1, std::memory_order_acq_rel))
+            futexWake(&m_Live, UINT32_MAX);
+    }
+};
+
+inline void CoTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> aHandle) noexcept
+{
+    CoroExecutor* sExecutor = aHandle.promise().m_Waiter.m_Executor;
+    aHandle.destroy();
+    sExecutor->finished();
+}
+
+// Base of awaiters: the waiter of the awaiting coroutine.
+struct CoroAwaiterBase
+{
+    static CoroWaiter& waiter(CoTask::Handle aHandle)
+    {
+        return aHandle.promise().m_Waiter;
+    }
+};
+
+// co_await CoroYield() lets other ready coroutines run.
+struct CoroYield : CoroAwaiterBase
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(CoTask::Handle aHandle)
+    {
+        CoroWaiter& sWaiter = waiter(aHandle);
+        sWaiter.m_Executor->post(sWaiter);
+    }
+    void await_resume() const noexcept {}
+};
+
+// co_await CoroSleep(duration) or CoroSleep(time_point).
+struct CoroSleep : CoroAwaiterBase
+{
+    CoroTimer m_Timer;
+
+    explicit CoroSleep(CoroClock::time_point aDeadline)
+    {
+        m_Timer.m_Deadline = aDeadline;
+    }
+    template <class Rep, class Period>
+    explicit CoroSleep(std::chrono::duration<Rep, Period> aDuration)
+    {
+        m_Timer.m_Deadline = CoroClock::now() + std::chrono::duration_cast<CoroClock::duration>(aDuration);
+    }
+    bool await_ready() const
+    {
+        return m_Timer.m_Deadline <= CoroClock::now();
+    }
+    void await_suspend(CoTask::Handle aHandle)
+    {
+        CoroWaiter& sWaiter = waiter(aHandle);
+        m_Timer.m_Waiter = &sWaiter;
+        sWaiter.m_Executor->addTimer(m_Timer);
+    }
+    void await_resume() const noexcept {}
+};
+
+// Single threaded executor: run() resumes coroutines in the calling thread.
+class CoroLoop : public CoroExecutor
+{
+public:
+    ~CoroLoop()
+    {
+        // Coroutines that never completed are left where they are.
+        while (!m_Ready.empty())
+            m_Ready.removeItem(m_Ready.front());
+        while (!m_Timers.empty())
+            m_Timers.pop();
+    }
+
+    void post(CoroWaiter& aWaiter) override
+    {
+        m_Ready.insertBack(aWaiter);
+    }
+    void addTimer(CoroTimer& aTimer) override
+    {
+        m_Timers.insert(aTimer);
+    }
+
+    // Runs until there is nothing ready and no timers, coroutines blocked
+    // on primitives may remain. Returns the number of resumptions.
+    size_t run()
+    {
+        size_t sResumed = 0;
+        for (;;)
+        {
+            while (!m_Ready.empty())
+            {
+                CoroWaiter& sWaiter = m_Ready.front();
+                m_Ready.removeItem(sWaiter);
+                sWaiter.m_Handle.resume();
+                ++sResumed;
+            }
+            if (m_Timers.empty())
+                return sResumed;
+            CoroClock::time_point sDeadline = m_Timers.top().m_Deadline;
+            std::this_thread::sleep_until(sDeadline);
+            CoroClock::time_point sNow = CoroClock::now();
+            while (!m_Timers.empty() && m_Timers.top().m_Deadline <= sNow)
+            {
+                CoroTimer& sTimer = m_Timers.top();
+                m_Timers.pop();
+                post(*sTimer.m_Waiter);
+            }
+        }
+    }
+
+private:
+    CoroWaitList m_Ready;
+    CoroTimerHeap m_Timers;
+};
+
+// Multi threaded executor: the ready queue is a BlockingQueue popped by
+// aThreads workers, timers are served by a separate thread. All coroutines
+// must complete before the pool is destroyed, see wait().
+class CoroThreadPool : public CoroExecutor
+{
+public:
+    explicit CoroThreadPool(size_t aThreads = std::thread::hardware_concurrency())
+    {
+        if (0 == aThreads)
+            aThreads = 1;
+        for (size_t i = 0; i < aThreads; i++)
+            m_Workers.emplace_back([this]() { work(); });
+        m_TimerThread = std::thread([this]() { serveTimers(); });
+    }
+    ~CoroThreadPool()
+    {
+        m_Ready.close();
+        {
+            std::lock_guard<std::mutex> sGuard(m_TimerMutex);
+            m_Stop = true;
+        }
+        m_TimerCond.notify_one();
+        for (std::thread& sThread : m_Workers)
+            sThread.join();
+        m_TimerThread.join();
+    }
+
+    void post(CoroWaiter& aWaiter) override
+    {
+        m_Ready.push(aWaiter);
+    }
+    void addTimer(CoroTimer& aTimer) override
+    {
+        bool sFirst;
+        {
+            std::lock_guard<std::mutex> sGuard(m_TimerMutex);
+            m_Timers.insert(aTimer);
+            sFirst = &m_Timers.top() == &aTimer;
+        }
+        if (sFirst)
+            m_TimerCond.notify_one();
+    }
+
+    // Blocks until all spawned coroutines complete.
+    void wait()
+    {
+        for (uint32_t sLive; 0 != (sLive = m_Live.load(std::memory_order_acquire)); )
+            futexWait(&m_Live, sLive);
+    }
+
+private:
+    BlockingQueue<CoroWaiter, &CoroWaiter::m_Link> m_Ready;
+    std::vector<std::thread> m_Workers;
+    std::mutex m_TimerMutex;
+    std::condition_variable m_TimerCond;
+    CoroTimerHeap m_Timers;
+    bool m_Stop = false;
+    std::thread m_TimerThread;
+
+    void work()
+    {
+        while (CoroWaiter* sWaiter = m_Ready.pop())
+            sWaiter->m_Handle.resume();
+    }
+    void serveTimers()
+    {
+        std::unique_lock<std::mutex> sLock(m_TimerMutex);
+        while (!m_Stop)
+        {
+            if (m_Timers.empty())
+            {
+                m_TimerCond.wait(sLock);
+                continue;
+            }
+            CoroClock::time_point sDeadline = m_Timers.top().m_Deadline;
+            if (CoroClock::now() < sDeadline)
+            {
+                m_TimerCond.wait_until(sLock, sDeadline);
+                continue;
+            }
+            CoroTimer& sTimer = m_Timers.top();
+            m_Timers.pop();
+            post(*sTimer.m_Waiter);
+        }
+    }
+};
+
+// FIFO async mutex: unlock hands the ownership over to the first waiter.
+class AsyncMutex
+{
+public:
+    AsyncMutex() = default;
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    bool tryLock()
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Guard);
+        if (m_Locked)
+            return false;
+        m_Locked = true;
+        return true;
+    }
+    // co_await sMutex.lock();
+    struct LockAwaiter : CoroAwaiterBase
+    {
+        AsyncMutex& m_Mutex;
+
+        bool await_ready()
+        {
+            return m_Mutex.tryLock();
+        }
+        bool await_suspend(CoTask::Handle aHandle)
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Mutex.m_Guard);
+            if (!m_Mutex.m_Locked)
+            {
+                m_Mutex.m_Locked = true;
+                return false;
+            }
+            m_Mutex.m_Waiters.insertBack(waiter(aHandle));
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+    LockAwaiter lock()
+    {
+        return LockAwaiter{{}, *this};
+    }
+    void unlock()
+    {
+        CoroWaiter* sNext = nullptr;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Guard);
+            if (m_Waiters.empty())
+            {
+                m_Locked = false;
+                return;
+            }
+            sNext = &m_Waiters.front();
+            m_Waiters.removeItem(*sNext);
+        }
+        sNext->m_Executor->post(*sNext);
+    }
+
+private:
+    FutexMutex m_Guard;
+    bool m_Locked = false;
+    CoroWaitList m_Waiters;
+};
+
+// Manual reset event: wait() suspends until set() is called.
+class AsyncEvent
+{
+public:
+    AsyncEvent() = default;
+    AsyncEvent(const AsyncEvent&) = delete;
+    AsyncEvent& operator=(const AsyncEvent&) = delete;
+
+    bool isSet() const
+    {
+        return m_Set.load(std::memory_order_acquire);
+    }
+    // Resumes all waiters, returns their count.
+    size_t set()
+    {
+        CoroWaitList sWaiters;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Guard);
+            m_Set.store(true, std::memory_order_release);
+            sWaiters.splice(sWaiters.end(), m_Waiters);
+        }
+        size_t sCount = 0;
+        while (!sWaiters.empty())
+        {
+            CoroWaiter& sWaiter = sWaiters.front();
+            sWaiters.removeItem(sWaiter);
+            sWaiter.m_Executor->post(sWaiter);
+            ++sCount;
+        }
+        return sCount;
+    }
+    void reset()
+    {
+        m_Set.store(false, std::memory_order_release);
+    }
+
+    struct WaitAwaiter : CoroAwaiterBase
+    {
+        AsyncEvent& m_Event;
+
+        bool await_ready() const
+        {
+            return m_Event.isSet();
+        }
+        bool await_suspend(CoTask::Handle aHandle)
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Event.m_Guard);
+            if (m_Event.isSet())
+                return false;
+            m_Event.m_Waiters.insertBack(waiter(aHandle));
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+    WaitAwaiter wait()
+    {
+        return WaitAwaiter{{}, *this};
+    }
+
+private:
+    FutexMutex m_Guard;
+    std::atomic<bool> m_Set{false};
+    CoroWaitList m_Waiters;
+};
+
+// Counting semaphore, waiters get permits in FIFO order.
+class AsyncSemaphore
+{
+public:
+    explicit AsyncSemaphore(size_t aCount = 0) : m_Count(aCount) {}
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+    bool tryAcquire()
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Guard);
+        if (0 == m_Count)
+            return false;
+        --m_Count;
+        return true;
+    }
+    struct AcquireAwaiter : CoroAwaiterBase
+    {
+        AsyncSemaphore& m_Semaphore;
+
+        bool await_ready()
+        {
+            return m_Semaphore.tryAcquire();
+        }
+        bool await_suspend(CoTask::Handle aHandle)
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Semaphore.m_Guard);
+            if (0 != m_Semaphore.m_Count)
+            {
+                --m_Semaphore.m_Count;
+                return false;
+            }
+            m_Semaphore.m_Waiters.insertBack(waiter(aHandle));
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+    AcquireAwaiter acquire()
+    {
+        return AcquireAwaiter{{}, *this};
+    }
+    // Permits go to waiters first, the rest is added to the count.
+    void release(size_t aCount = 1)
+    {
+        CoroWaitList sWoken;
+        {
+            std::lock_guard<FutexMutex> sGuard(m_Guard);
+            while (0 != aCount && !m_Waiters.empty())
+            {
+                CoroWaiter& sWaiter = m_Waiters.front();
+                m_Waiters.removeItem(sWaiter);
+                sWoken.insertBack(sWaiter);
+                --aCount;
+            }
+            m_Count += aCount;
+        }
+        while (!sWoken.empty())
+        {
+            CoroWaiter& sWaiter = sWoken.front();
+            sWoken.removeItem(sWaiter);
+            sWaiter.m_Executor->post(sWaiter);
+        }
+    }
+    size_t count() const
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Guard);
+        return m_Count;
+    }
+
+private:
+    mutable FutexMutex m_Guard;
+    size_t m_Count;
+    CoroWaitList m_Waiters;
+};
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <Coroutine.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+static CoTask yielder(size_t aSteps)
+{
+    for (size_t i = 0; i < aSteps; i++)
+        co_await CoroYield();
+}
+
+static CoTask pinger(AsyncSemaphore& aMine, AsyncSemaphore& aOther, size_t aRounds)
+{
+    for (size_t i = 0; i < aRounds; i++)
+    {
+        co_await aMine.acquire();
+        aOther.release();
+    }
+}
+
+static CoTask eventWaiter(AsyncEvent& aEvent, size_t& aCounter)
+{
+    co_await aEvent.wait();
+    ++aCounter;
+}
+
+// Context switch: a yield suspends the coroutine, queues it and resumes the
+// next one; ping-pong passes control between two coroutines by semaphores.
+static void contextSwitch()
+{
+    const size_t COUNT = 1000;
+    const size_t STEPS = 1000;
+    const size_t ROUNDS = 1000000;
+    std::cout << "Context switch" << std::endl;
+
+    {
+        CoroLoop sLoop;
+        for (size_t i = 0; i < COUNT; i++)
+            sLoop.spawn(yielder(STEPS));
+        checkpoint("", 0);
+        SideEffect += sLoop.run();
+        checkpoint("Loop, yield of 1000 coroutines", COUNT * STEPS);
+    }
+    {
+        CoroLoop sLoop;
+        AsyncSemaphore sPing(1);
+        AsyncSemaphore sPong(0);
+        sLoop.spawn(pinger(sPing, sPong, ROUNDS));
+        sLoop.spawn(pinger(sPong, sPing, ROUNDS));
+        checkpoint("", 0);
+        SideEffect += sLoop.run();
+        checkpoint("Loop, semaphore ping-pong", 2 * ROUNDS);
+    }
+    {
+        CoroThreadPool sPool(1);
+        for (size_t i = 0; i < COUNT; i++)
+            sPool.spawn(yielder(STEPS / 10));
+        checkpoint("", 0);
+        sPool.wait();
+        checkpoint("Pool of 1, yield of 1000 coroutines", COUNT * STEPS / 10);
+    }
+    {
+        CoroThreadPool sPool(2);
+        AsyncSemaphore sPing(1);
+        AsyncSemaphore sPong(0);
+        sPool.spawn(pinger(sPing, sPong, ROUNDS / 10));
+        sPool.spawn(pinger(sPong, sPing, ROUNDS / 10));
+        checkpoint("", 0);
+        sPool.wait();
+        checkpoint("Pool of 2, semaphore ping-pong", 2 * ROUNDS / 10);
+    }
+
+    // The same ping-pong between two threads.
+    std::mutex sMutex;
+    std::condition_variable sCond;
+    bool sTurn = false;
+    checkpoint("", 0);
+    std::thread sOther([&]()
+    {
+        for (size_t i = 0; i < ROUNDS / 10; i++)
+        {
+            std::unique_lock<std::mutex> sLock(sMutex);
+            sCond.wait(sLock, [&]() { return sTurn; });
+            sTurn = false;
+            sCond.notify_one();
+        }
+    });
+    for (size_t i = 0; i < ROUNDS / 10; i++)
+    {
+        std::unique_lock<std::mutex> sLock(sMutex);
+        sTurn = true;
+        sCond.notify_one();
+        sCond.wait(sLock, [&]() { return !sTurn; });
+    }
+    sOther.join();
+    checkpoint("Threads, condvar ping-pong", 2 * ROUNDS / 10);
+}
+
+// Wake throughput: an event set resumes all of its waiters.
+static void wake()
+{
+    const size_t WAITERS = 100000;
+    std::cout << "Wake throughput, " << WAITERS << " waiters" << std::endl;
+
+    size_t sMaxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    for (size_t sThreads = 0; sThreads <= sMaxThreads; sThreads = sThreads == 0 ? 1 : sThreads * 2)
+    {
+        AsyncEvent sEvent;
+        size_t sCounter = 0;
+        std::string sText;
+        if (sThreads == 0)
+        {
+            CoroLoop sLoop;
+            for (size_t i = 0; i < WAITERS; i++)
+                sLoop.spawn(eventWaiter(sEvent, sCounter));
+            sLoop.run();
+            checkpoint("", 0);
+            sEvent.set();
+            sLoop.run();
+            checkpoint("Loop", WAITERS);
+        }
+        else
+        {
+            CoroThreadPool sPool(sThreads);
+            std::vector<size_t> sCounters(WAITERS);
+            for (size_t i = 0; i < WAITERS; i++)
+                sPool.spawn(eventWaiter(sEvent, sCounters[i]));
+            // Let all the waiters suspend first.
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            checkpoint("", 0);
+            sEvent.set();
+            sPool.wait();
+            sText = "Pool of " + std::to_string(sThreads);
+            checkpoint(sText.c_str(), WAITERS);
+            for (size_t sCount : sCounters)
+                sCounter += sCount;
+        }
+        SideEffect += sCounter;
+    }
+}
+
+int main()
+{
+    contextSwitch();
+    wake();
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
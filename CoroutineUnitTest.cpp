@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <Coroutine.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+CoTask yielder(std::string& aLog, char aName, int aSteps)
+{
+    for (int i = 0; i < aSteps; i++)
+    {
+        aLog += aName;
+        co_await CoroYield();
+    }
+}
+
+void loop_yield()
+{
+    ANNOUNCE();
+
+    CoroLoop sLoop;
+    std::string sLog;
+    sLoop.spawn(yielder(sLog, 'a', 3));
+    sLoop.spawn(yielder(sLog, 'b', 2));
+    sLoop.spawn(yielder(sLog, 'c', 1));
+    CHECK(sLoop.live(), size_t(3));
+    CHECK(sLog, std::string());
+    sLoop.run();
+    CHECK(sLog, std::string("abcaba"));
+    CHECK(sLoop.live(), size_t(0));
+
+    // Not spawned coroutine is destroyed unstarted.
+    {
+        CoTask sTask = yielder(sLog, 'x', 1);
+    }
+    CHECK(sLog, std::string("abcaba"));
+}
+
+CoTask locker(AsyncMutex& aMutex, std::string& aLog, char aName)
+{
+    co_await aMutex.lock();
+    aLog += aName;
+    co_await CoroYield();
+    aLog += aName;
+    aMutex.unlock();
+}
+
+void loop_mutex()
+{
+    ANNOUNCE();
+
+    CoroLoop sLoop;
+    AsyncMutex sMutex;
+    std::string sLog;
+    sLoop.spawn(locker(sMutex, sLog, 'a'));
+    sLoop.spawn(locker(sMutex, sLog, 'b'));
+    sLoop.spawn(locker(sMutex, sLog, 'c'));
+    sLoop.run();
+    CHECK(sLog, std::string("aabbcc"));
+    CHECK(sMutex.tryLock());
+    CHECK(!sMutex.tryLock());
+    sMutex.unlock();
+}
+
+CoTask eventWaiter(AsyncEvent& aEvent, int& aCounter)
+{
+    co_await aEvent.wait();
+    ++aCounter;
+}
+
+CoTask semaphoreWaiter(AsyncSemaphore& aSemaphore, std::string& aLog, char aName)
+{
+    co_await aSemaphore.acquire();
+    aLog += aName;
+}
+
+void loop_event_semaphore()
+{
+    ANNOUNCE();
+
+    CoroLoop sLoop;
+    AsyncEvent sEvent;
+    int sCounter = 0;
+    for (int i = 0; i < 5; i++)
+        sLoop.spawn(eventWaiter(sEvent, sCounter));
+    sLoop.run();
+    CHECK(sCounter, 0);
+    CHECK(sLoop.live(), size_t(5));
+    CHECK(sEvent.set(), size_t(5));
+    sLoop.run();
+    CHECK(sCounter, 5);
+    sLoop.spawn(eventWaiter(sEvent, sCounter));
+    sLoop.run();
+    CHECK(sCounter, 6);
+    sEvent.reset();
+    CHECK(!sEvent.isSet());
+
+    AsyncSemaphore sSemaphore(1);
+    std::string sLog;
+    sLoop.spawn(semaphoreWaiter(sSemaphore, sLog, 'a'));
+    sLoop.spawn(semaphoreWaiter(sSemaphore, sLog, 'b'));
+    sLoop.spawn(semaphoreWaiter(sSemaphore, sLog, 'c'));
+    sLoop.spawn(semaphoreWaiter(sSemaphore, sLog, 'd'));
+    sLoop.run();
+    CHECK(sLog, std::string("a"));
+    sSemaphore.release(2);
+    sLoop.run();
+    CHECK(sLog, std::string("abc"));
+    sSemaphore.release(3);
+    sLoop.run();
+    CHECK(sLog, std::string("abcd"));
+    CHECK(sSemaphore.count(), size_t(2));
+    CHECK(sLoop.live(), size_t(0));
+}
+
+CoTask sleeper(std::string& aLog, char aName, int aMs)
+{
+    co_await CoroSleep(std::chrono::milliseconds(aMs));
+    aLog += aName;
+}
+
+void loop_timers()
+{
+    ANNOUNCE();
+
+    CoroLoop sLoop;
+    std::string sLog;
+    sLoop.spawn(sleeper(sLog, 'c', 30));
+    sLoop.spawn(sleeper(sLog, 'a', 10));
+    sLoop.spawn(sleeper(sLog, 'b', 20));
+    sLoop.spawn(sleeper(sLog, 'z', 0));
+    CoroClock::time_point sStart = CoroClock::now();
+    sLoop.run();
+    CHECK(sLog, std::string("zabc"));
+    CHECK(CoroClock::now() - sStart >= std::chrono::milliseconds(30));
+}
+
+CoTask counter(AsyncMutex& aMutex, size_t& aShared, size_t aSteps)
+{
+    for (size_t i = 0; i < aSteps; i++)
+    {
+        co_await aMutex.lock();
+        size_t sWas = aShared;
+        if (i % 8 == 0)
+            co_await CoroYield();
+        aShared = sWas + 1;
+        aMutex.unlock();
+    }
+}
+
+CoTask pinger(AsyncSemaphore& aMine, AsyncSemaphore& aOther, size_t aRounds, size_t& aDone)
+{
+    for (size_t i = 0; i < aRounds; i++)
+    {
+        co_await aMine.acquire();
+        ++aDone;
+        aOther.release();
+    }
+}
+
+CoTask napper(std::atomic<size_t>& aDone)
+{
+    co_await CoroSleep(std::chrono::milliseconds(2));
+    co_await CoroYield();
+    co_await CoroSleep(std::chrono::milliseconds(1));
+    aDone.fetch_add(1);
+}
+
+void pool_massive()
+{
+    ANNOUNCE();
+
+    for (size_t sThreads : {1, 2, 4})
+    {
+        CoroThreadPool sPool(sThreads);
+        AsyncMutex sMutex;
+        size_t sShared = 0;
+        for (int i = 0; i < 50; i++)
+            sPool.spawn(counter(sMutex, sShared, 200));
+
+        AsyncSemaphore sPing(1);
+        AsyncSemaphore sPong(0);
+        size_t sPings = 0;
+        size_t sPongs = 0;
+        sPool.spawn(pinger(sPing, sPong, 1000, sPings));
+        sPool.spawn(pinger(sPong, sPing, 1000, sPongs));
+
+        std::atomic<size_t> sNaps{0};
+        for (int i = 0; i < 100; i++)
+            sPool.spawn(napper(sNaps));
+
+        sPool.wait();
+        CHECK(sShared, size_t(50 * 200));
+        CHECK(sPings, size_t(1000));
+        CHECK(sPongs, size_t(1000));
+        CHECK(sNaps.load(), size_t(100));
+        CHECK(sPool.live(), size_t(0));
+    }
+}
+
+} // anonymous namespace
+
+int main()
+{
+    loop_yield();
+    loop_mutex();
+    loop_event_semaphore();
+    loop_timers();
+    pool_massive();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
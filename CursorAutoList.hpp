@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include <AutoList.hpp>
+
+// AutoList with resumable cursors for incremental sweeps (expiration,
+// revalidation) from an event loop. A cursor is a hidden placeholder node
+// in the ring of the list, so it stays valid whatever items are removed
+// between and during sweep slices; advance() visits a bounded number of
+// items per call.
+//
+// Placeholders live in a fixed array of MaxCursors nodes within the list and
+// are recognized by address; iteration, front() and back() skip them. The
+// list is neither copyable nor movable since cursors refer to it.
+template <class Item, AutoListLink Item::*LinkMember, size_t MaxCursors = 4>
+class CursorAutoList
+{
+public:
+    CursorAutoList() : m_Ring(0)
+    {
+        for (Ring& sPlace : m_Places)
+            sPlace.init();
+    }
+    ~CursorAutoList()
+    {
+        for (Ring& sPlace : m_Places)
+            sPlace.remove();
+        m_Ring.remove();
+    }
+
+    CursorAutoList(const CursorAutoList&) = delete;
+    CursorAutoList& operator=(const CursorAutoList&) = delete;
+
+    void insertFront(Item& aItem)
+    {
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), false);
+    }
+    void insertBack(Item& aItem)
+    {
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), true);
+    }
+    void insertAfter(Item& aExistingItem, Item& aNewItem)
+    {
+        (aExistingItem.*LinkMember).m_Ring.add(&((aNewItem.*LinkMember).m_Ring), false);
+    }
+    void removeItem(Item& aItem)
+    {
+        (aItem.*LinkMember).remove();
+    }
+    bool empty() const
+    {
+        return &m_Ring == skip(m_Ring.m_Neigh[1], 1);
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+    Item& front()
+    {
+        return *item(skip(m_Ring.m_Neigh[1], 1));
+    }
+    const Item& front() const
+    {
+        return *item(skip(m_Ring.m_Neigh[1], 1));
+    }
+    Item& back()
+    {
+        return *item(skip(m_Ring.m_Neigh[0], 0));
+    }
+    const Item& back() const
+    {
+        return *item(skip(m_Ring.m_Neigh[0], 0));
+    }
+
+    // Position in the list between two items. A new cursor is placed at the
+    // front; items inserted to the front after that are not visited by it,
+    // items inserted to the back are. At most MaxCursors cursors may exist
+    // at once for one list: a cursor created beyond that is not valid(), it
+    // is done() and visits nothing. A cursor must be destroyed before the
+    // list.
+    class Cursor
+    {
+    public:
+        explicit Cursor(CursorAutoList& aList) : m_List(aList), m_Place(aList.acquirePlace())
+        {
+            if (nullptr != m_Place)
+                m_List.m_Ring.add(m_Place, false);
+        }
+        ~Cursor()
+        {
+            if (nullptr == m_Place)
+                return;
+            m_Place->remove();
+            m_Place->init();
+        }
+        Cursor(const Cursor&) = delete;
+        Cursor& operator=(const Cursor&) = delete;
+
+        // False if the list had no free place for the cursor.
+        bool valid() const
+        {
+            return nullptr != m_Place;
+        }
+        // Moves the cursor to the front of the list to start a new sweep.
+        void rewind()
+        {
+            if (nullptr == m_Place)
+                return;
+            m_Place->remove();
+            m_List.m_Ring.add(m_Place, false);
+        }
+        // True if there are no items after the cursor.
+        bool done() const
+        {
+            return nullptr == m_Place || &m_List.m_Ring == m_List.skip(m_Place->m_Neigh[1], 1);
+        }
+        // Calls aFn(Item&) for up to aBudget next items and moves the cursor
+        // past them. aFn may remove or insert any items, including the
+        // visited one. Returns the number of visited items, less than
+        // aBudget only if the end of the list is reached.
+        template <class Fn>
+        size_t advance(size_t aBudget, Fn&& aFn)
+        {
+            size_t sCount = 0;
+            while (nullptr != m_Place && sCount < aBudget)
+            {
+                Ring* sNext = m_Place->m_Neigh[1];
+                if (sNext == &m_List.m_Ring)
+                    break;
+                // The cursor steps over the next node before it's visited.
+                m_Place->remove();
+                sNext->add(m_Place, false);
+                if (m_List.isPlace(sNext))
+                    continue;
+                ++sCount;
+                aFn(*item(sNext));
+            }
+            return sCount;
+        }
+        // The same as advance, but the budget is time. The clock is checked
+        // every CLOCK_STRIDE items, so a slice may exceed aBudget by the time
+        // of that many aFn calls.
+        template <class Rep, class Period, class Fn>
+        size_t advanceFor(std::chrono::duration<Rep, Period> aBudget, Fn&& aFn)
+        {
+            using namespace std::chrono;
+            const steady_clock::time_point sDeadline = steady_clock::now() + duration_cast<steady_clock::duration>(aBudget);
+            size_t sCount = 0;
+            for (;;)
+            {
+                size_t sVisited = advance(CLOCK_STRIDE, aFn);
+                sCount += sVisited;
+                if (sVisited < CLOCK_STRIDE || steady_clock::now() >= sDeadline)
+                    return sCount;
+            }
+        }
+
+        static constexpr size_t CLOCK_STRIDE = 64;
+
+    private:
+        CursorAutoList& m_List;
+        Ring* m_Place;
+    };
+
+    template <class TItem, class TRing, class TList>
+    class iterator_common
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, TList* aList) : m_Ring(aRing), m_List(aList) {}
+        TItem& operator*() const { return *item(m_Ring); }
+        TItem* operator->() const { return item(m_Ring); }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
+        bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
+        iterator_common& operator++() { m_Ring = m_List->skip(m_Ring->m_Neigh[1], 1); return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { m_Ring = m_List->skip(m_Ring->m_Neigh[0], 0); return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TRing* m_Ring;
+        TList* m_List;
+    };
+    using iterator = iterator_common<Item, Ring, CursorAutoList>;
+    using const_iterator = iterator_common<const Item, const Ring, const CursorAutoList>;
+
+    iterator begin() { return iterator(skip(m_Ring.m_Neigh[1], 1), this); }
+    iterator end() { return iterator(&m_Ring, this); }
+    const_iterator begin() const { return const_iterator(skip(m_Ring.m_Neigh[1], 1), this); }
+    const_iterator end() const { return const_iterator(&m_Ring, this); }
+
+private:
+    Ring m_Ring;
+    // A place is alone when its cursor doesn't exist.
+    Ring m_Places[MaxCursors];
+
+    bool isPlace(const Ring* aRing) const
+    {
+        return reinterpret_cast<uintptr_t>(aRing) - reinterpret_cast<uintptr_t>(m_Places) <
+               MaxCursors * sizeof(Ring);
+    }
+    Ring* skip(Ring* aRing, bool aNext)
+    {
+        while (isPlace(aRing))
+            aRing = aRing->m_Neigh[aNext];
+        return aRing;
+    }
+    const Ring* skip(const Ring* aRing, bool aNext) const
+    {
+        while (isPlace(aRing))
+            aRing = aRing->m_Neigh[aNext];
+        return aRing;
+    }
+    // Free place or nullptr if MaxCursors cursors exist.
+    Ring* acquirePlace()
+    {
+        for (Ring& sPlace : m_Places)
+            if (sPlace.isAlone())
+                return &sPlace;
+        return nullptr;
+    }
+
+    static Item* item(Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+    static const Item* item(const Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
+    }
+};
+
+template <class Item, AutoListLink Item::*LinkMember, size_t MaxCursors>
+constexpr size_t CursorAutoList<Item, LinkMember, MaxCursors>::Cursor::CLOCK_STRIDE;
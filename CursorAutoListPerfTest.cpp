@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <CursorAutoList.hpp>
+#include <LatencyHistogram.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Object
+    {
+        AutoListLink m_Link;
+        uint64_t m_Deadline;
+        char m_Payload[48];
+    };
+
+    using PlainList = AutoList<Object, &Object::m_Link>;
+    using SweepList = CursorAutoList<Object, &Object::m_Link>;
+    using Histogram = LatencyHistogram<>;
+
+    static size_t SideEffect = 0;
+    double TicksPerNs = 1.;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+static void report(const Histogram& aHist)
+{
+    std::streamsize sPrecision = std::cout.precision();
+    std::cout << "  " << aHist.count() << " slices, latency (ns) p50 " << std::fixed << std::setprecision(1)
+              << aHist.percentile(50.) / TicksPerNs << ", p99 " << aHist.percentile(99.) / TicksPerNs
+              << ", max " << aHist.max() / TicksPerNs << std::defaultfloat << std::setprecision(sPrecision) << std::endl;
+}
+
+// Sweeps the whole list in slices of aBudget items, visited items with
+// a passed deadline are removed.
+template <class Fn>
+static void sweep(SweepList& aList, size_t aBudget, size_t aSize, const char* aText, Fn&& aFn)
+{
+    SweepList::Cursor sCursor(aList);
+    Histogram sHist;
+    checkpoint("", 0);
+    while (!sCursor.done())
+    {
+        uint64_t sStart = tscStart();
+        sCursor.advance(aBudget, aFn);
+        sHist.record(tscStop() - sStart);
+    }
+    std::cout << aText << " " << aBudget << ", ";
+    checkpoint("sweep", aSize);
+    report(sHist);
+}
+
+static void test(size_t aSize)
+{
+    std::cout << aSize << " items of " << sizeof(Object) << " bytes" << std::endl;
+    std::vector<size_t> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sOrder[i] = i;
+    std::mt19937 sRand(aSize);
+    std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+    std::vector<Object> sObjects(aSize);
+    for (Object& o : sObjects)
+        o.m_Deadline = sRand() % 100;
+
+    {
+        PlainList sList;
+        for (size_t i : sOrder)
+            sList.insertBack(sObjects[i]);
+        checkpoint("", 0);
+        for (Object& o : sList)
+            SideEffect += o.m_Deadline;
+        checkpoint("AutoList iteration", aSize);
+    }
+
+    SweepList sList;
+    for (size_t i : sOrder)
+        sList.insertBack(sObjects[i]);
+    checkpoint("", 0);
+    for (Object& o : sList)
+        SideEffect += o.m_Deadline;
+    checkpoint("CursorAutoList iteration", aSize);
+
+    const size_t BUDGETS[] = {64, 1024, 16384};
+    for (size_t sBudget : BUDGETS)
+        sweep(sList, sBudget, aSize, "Cursor, budget", [](Object& o) { SideEffect += o.m_Deadline; });
+
+    // Every sweep expires about 10% of the items.
+    size_t sNow = 0;
+    size_t sCount = aSize;
+    for (size_t sBudget : BUDGETS)
+    {
+        sNow += 10;
+        sweep(sList, sBudget, sCount, "Cursor with expiration, budget", [&](Object& o)
+        {
+            if (o.m_Deadline < sNow)
+            {
+                sList.removeItem(o);
+                --sCount;
+            }
+        });
+    }
+
+    SweepList::Cursor sCursor(sList);
+    Histogram sHist;
+    checkpoint("", 0);
+    while (!sCursor.done())
+    {
+        uint64_t sStart = tscStart();
+        sCursor.advanceFor(std::chrono::microseconds(50), [](Object& o) { SideEffect += o.m_Deadline; });
+        sHist.record(tscStop() - sStart);
+    }
+    std::cout << "Cursor, budget 50us, ";
+    checkpoint("sweep", sCount);
+    report(sHist);
+}
+
+int main()
+{
+    TicksPerNs = tscTicksPerNs();
+    test(1024 * 1024);
+    test(8 * 1024 * 1024);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <CursorAutoList.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    AutoListLink m_Link;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+using ObjectList = CursorAutoList<Object, &Object::m_Link>;
+using Cursor = ObjectList::Cursor;
+
+std::vector<int> sweep(Cursor& aCursor, size_t aBudget)
+{
+    std::vector<int> sRes;
+    aCursor.advance(aBudget, [&sRes](Object& o) { sRes.push_back(o.m_Data); });
+    return sRes;
+}
+
+void simple()
+{
+    ANNOUNCE();
+
+    Object sObjects[6] = {0, 1, 2, 3, 4, 5};
+    ObjectList sList;
+    {
+        // A cursor is hidden in an empty list.
+        Cursor sCursor(sList);
+        CHECK(sList, std::vector<int>());
+        CHECK(sCursor.done());
+        CHECK(sweep(sCursor, 10).empty());
+    }
+    for (int i = 0; i < 5; i++)
+        sList.insertBack(sObjects[i]);
+    CHECK(sList, {0, 1, 2, 3, 4});
+
+    Cursor sCursor(sList);
+    CHECK(!sCursor.done());
+    CHECK(sweep(sCursor, 2) == std::vector<int>({0, 1}));
+    // The cursor is invisible to iteration, front and back.
+    CHECK(sList, {0, 1, 2, 3, 4});
+
+    // Neither the last visited nor the next item is needed by the cursor.
+    sList.removeItem(sObjects[1]);
+    sList.removeItem(sObjects[2]);
+    CHECK(sList, {0, 3, 4});
+    CHECK(sweep(sCursor, 1) == std::vector<int>({3}));
+
+    // Items inserted to the back are visited, to the front are not.
+    sList.insertFront(sObjects[1]);
+    sList.insertBack(sObjects[5]);
+    CHECK(sweep(sCursor, 10) == std::vector<int>({4, 5}));
+    CHECK(sCursor.done());
+    CHECK(sweep(sCursor, 10).empty());
+
+    sCursor.rewind();
+    CHECK(sweep(sCursor, 10) == std::vector<int>({1, 0, 3, 4, 5}));
+
+    // The cursor at the end doesn't prevent emptying the list.
+    for (Object& o : sObjects)
+        sList.removeItem(o);
+    CHECK(sList, std::vector<int>());
+    CHECK(sCursor.done());
+}
+
+void removal_in_sweep()
+{
+    ANNOUNCE();
+
+    std::vector<Object> sObjects(100);
+    ObjectList sList;
+    for (int i = 0; i < 100; i++)
+    {
+        sObjects[i].m_Data = i;
+        sList.insertBack(sObjects[i]);
+    }
+
+    // Expiring: the visited item removes itself and its successor.
+    Cursor sCursor(sList);
+    std::vector<int> sVisited;
+    while (!sCursor.done())
+    {
+        sCursor.advance(7, [&](Object& o)
+        {
+            sVisited.push_back(o.m_Data);
+            sList.removeItem(o);
+            if (o.m_Data + 1 < 100)
+                sList.removeItem(sObjects[o.m_Data + 1]);
+        });
+    }
+    std::vector<int> sRef;
+    for (int i = 0; i < 100; i += 2)
+        sRef.push_back(i);
+    CHECK(sVisited == sRef);
+    CHECK(sList, std::vector<int>());
+
+    // The visited item is destroyed along with its link.
+    std::vector<Object>* sHeap = new std::vector<Object>(10);
+    for (int i = 0; i < 10; i++)
+    {
+        (*sHeap)[i].m_Data = i;
+        sList.insertBack((*sHeap)[i]);
+    }
+    sCursor.rewind();
+    sCursor.advance(5, [](Object&) {});
+    delete sHeap;
+    CHECK(sList, std::vector<int>());
+    CHECK(sCursor.done());
+}
+
+void several_cursors()
+{
+    ANNOUNCE();
+
+    Object sObjects[6] = {0, 1, 2, 3, 4, 5};
+    ObjectList sList;
+    for (Object& o : sObjects)
+        sList.insertBack(o);
+
+    Cursor sFirst(sList);
+    Cursor sSecond(sList);
+    CHECK(sweep(sFirst, 2) == std::vector<int>({0, 1}));
+    CHECK(sweep(sSecond, 1) == std::vector<int>({0}));
+    // Cursors don't count each other as items.
+    CHECK(sweep(sSecond, 2) == std::vector<int>({1, 2}));
+    CHECK(sweep(sFirst, 2) == std::vector<int>({2, 3}));
+    CHECK(sList, {0, 1, 2, 3, 4, 5});
+    {
+        Cursor sThird(sList);
+        Cursor sFourth(sList);
+        CHECK(sweep(sFourth, 10) == std::vector<int>({0, 1, 2, 3, 4, 5}));
+        CHECK(sList, {0, 1, 2, 3, 4, 5});
+    }
+    CHECK(sweep(sSecond, 10) == std::vector<int>({3, 4, 5}));
+    CHECK(sList, {0, 1, 2, 3, 4, 5});
+}
+
+// Random removals and insertions between slices; every item that stays in
+// the list all the sweep long is visited exactly once.
+void too_many_cursors()
+{
+    ANNOUNCE();
+
+    using SmallList = CursorAutoList<Object, &Object::m_Link, 2>;
+    Object sObjects[3] = {0, 1, 2};
+    SmallList sList;
+    for (Object& o : sObjects)
+        sList.insertBack(o);
+
+    SmallList::Cursor sFirst(sList);
+    CHECK(sFirst.valid());
+    {
+        SmallList::Cursor sSecond(sList);
+        CHECK(sSecond.valid());
+
+        // No place left: the cursor is invalid and visits nothing.
+        SmallList::Cursor sThird(sList);
+        CHECK(!sThird.valid());
+        CHECK(sThird.done());
+        sThird.rewind();
+        CHECK(sThird.advance(10, [](Object&) {}), size_t(0));
+        CHECK(sList, {0, 1, 2});
+        CHECK(sFirst.advance(10, [](Object&) {}), size_t(3));
+    }
+
+    // A freed place is reused.
+    SmallList::Cursor sSecond(sList);
+    CHECK(sSecond.valid());
+    CHECK(sSecond.advance(10, [](Object&) {}), size_t(3));
+}
+
+void massive()
+{
+    ANNOUNCE();
+
+    const int COUNT = 1000;
+    std::vector<Object> sObjects(COUNT);
+    ObjectList sList;
+    std::vector<char> sInList(COUNT, 0);
+    for (int i = 0; i < COUNT; i++)
+    {
+        sObjects[i].m_Data = i;
+        if (rand() % 2 == 0)
+        {
+            sList.insertBack(sObjects[i]);
+            sInList[i] = 1;
+        }
+    }
+    bool sOk = true;
+    for (int sRound = 0; sRound < 20; sRound++)
+    {
+        Cursor sCursor(sList);
+        std::vector<char> sStayed = sInList;
+        std::vector<int> sVisits(COUNT, 0);
+        while (!sCursor.done())
+        {
+            size_t sBudget = rand() % 20;
+            size_t sVisited = sCursor.advance(sBudget, [&](Object& o) { ++sVisits[o.m_Data]; });
+            sOk = sOk && (sVisited == sBudget || sCursor.done());
+            for (int k = 0; k < 10; k++)
+            {
+                int i = rand() % COUNT;
+                if (sInList[i])
+                {
+                    sList.removeItem(sObjects[i]);
+                    sInList[i] = 0;
+                    sStayed[i] = 0;
+                }
+                else
+                {
+                    sList.insertBack(sObjects[i]);
+                    sInList[i] = 1;
+                }
+            }
+        }
+        for (int i = 0; i < COUNT; i++)
+            sOk = sOk && (!sStayed[i] || sVisits[i] == 1);
+        sOk = sOk && sList.selfCheck() == 0;
+    }
+    CHECK(sOk);
+}
+
+void time_budget()
+{
+    ANNOUNCE();
+
+    std::vector<Object> sObjects(10000);
+    ObjectList sList;
+    for (Object& o : sObjects)
+        sList.insertBack(o);
+    Cursor sCursor(sList);
+    size_t sTotal = 0;
+    size_t sSlices = 0;
+    while (!sCursor.done())
+    {
+        sTotal += sCursor.advanceFor(std::chrono::microseconds(10), [](Object& o) { ++o.m_Data; });
+        ++sSlices;
+    }
+    CHECK(sTotal, size_t(10000));
+    CHECK(sSlices >= 1);
+    bool sOk = true;
+    for (const Object& o : sObjects)
+        sOk = sOk && o.m_Data == 1;
+    CHECK(sOk);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    removal_in_sweep();
+    several_cursors();
+    too_many_cursors();
+    massive();
+    time_budget();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
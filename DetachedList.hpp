@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <IndexRing.hpp>
+
+// List of items of one array whose links are not embedded into items but
+// are kept by the list in a dense array parallel to the items (structure
+// of arrays). Linking, unlinking and walking touch only the link array;
+// an item is touched only when it is dereferenced.
+//
+// The list owns links for all aCount items of the array, so an item may be
+// in any number of such lists at once, and items need no special members.
+template <class Item, class Index = uint32_t>
+class DetachedList
+{
+public:
+    static constexpr Index HEAD = IndexRing<Index>::HEAD;
+
+    // aItems is the array of aCount items, aCount <= IndexRing<Index>::CAPACITY.
+    DetachedList(Item* aItems, size_t aCount) : m_Items(aItems), m_Links(aCount)
+    {
+        m_Head.initAlone(HEAD);
+    }
+
+    DetachedList(const DetachedList& aList) : m_Items(aList.m_Items), m_Links(aList.m_Links.size())
+    {
+        m_Head.initAlone(HEAD);
+    }
+    DetachedList& operator=(const DetachedList& aList)
+    {
+        m_Items = aList.m_Items;
+        m_Links.assign(aList.m_Links.size(), IndexRing<Index>());
+        m_Head.initAlone(HEAD);
+        return *this;
+    }
+    DetachedList(DetachedList&& aList) noexcept : m_Items(aList.m_Items), m_Links(std::move(aList.m_Links))
+    {
+        m_Head.m_Neigh[0] = aList.m_Head.m_Neigh[0];
+        m_Head.m_Neigh[1] = aList.m_Head.m_Neigh[1];
+        aList.m_Head.initAlone(HEAD);
+    }
+    DetachedList& operator=(DetachedList&& aList) noexcept
+    {
+        std::swap(m_Items, aList.m_Items);
+        m_Links.swap(aList.m_Links);
+        std::swap(m_Head.m_Neigh[0], aList.m_Head.m_Neigh[0]);
+        std::swap(m_Head.m_Neigh[1], aList.m_Head.m_Neigh[1]);
+        return *this;
+    }
+
+    void insertFront(Index aIndex)
+    {
+        IndexRing<Index>::add(resolver(), HEAD, aIndex, false);
+    }
+    void insertBack(Index aIndex)
+    {
+        IndexRing<Index>::add(resolver(), HEAD, aIndex, true);
+    }
+    void insertAfter(Index aExisting, Index aNew)
+    {
+        IndexRing<Index>::add(resolver(), aExisting, aNew, false);
+    }
+    void remove(Index aIndex)
+    {
+        if (contains(aIndex))
+            IndexRing<Index>::remove(resolver(), aIndex);
+    }
+    bool contains(Index aIndex) const
+    {
+        return !m_Links[aIndex].isAlone();
+    }
+
+    void insertFront(Item& aItem) { insertFront(index(aItem)); }
+    void insertBack(Item& aItem) { insertBack(index(aItem)); }
+    void insertAfter(Item& aExistingItem, Item& aNewItem) { insertAfter(index(aExistingItem), index(aNewItem)); }
+    void removeItem(Item& aItem) { remove(index(aItem)); }
+    bool contains(const Item& aItem) const { return contains(index(aItem)); }
+
+    // Unlinks all items, O(n) in links only.
+    void clear()
+    {
+        while (!empty())
+            IndexRing<Index>::remove(resolver(), m_Head.m_Neigh[1]);
+    }
+    bool empty() const
+    {
+        return HEAD == m_Head.m_Neigh[0];
+    }
+    int selfCheck() const
+    {
+        Index sCur = HEAD;
+        for (size_t i = 0; i <= m_Links.size(); i++)
+        {
+            Index sNext = ring(sCur).m_Neigh[1];
+            if (sNext != HEAD && sNext >= m_Links.size())
+                return 1;
+            if (ring(sNext).m_Neigh[0] != sCur)
+                return 1;
+            sCur = sNext;
+            if (sCur == HEAD)
+                return 0;
+        }
+        return 1;
+    }
+    Item& front()
+    {
+        return m_Items[m_Head.m_Neigh[1]];
+    }
+    const Item& front() const
+    {
+        return m_Items[m_Head.m_Neigh[1]];
+    }
+    Item& back()
+    {
+        return m_Items[m_Head.m_Neigh[0]];
+    }
+    const Item& back() const
+    {
+        return m_Items[m_Head.m_Neigh[0]];
+    }
+    Index index(const Item& aItem) const
+    {
+        return static_cast<Index>(&aItem - m_Items);
+    }
+
+    // Iterators walk links only; index() gives the position without
+    // touching the item.
+    template <class TItem, class TList>
+    class iterator_common
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TList* aList, Index aIndex) : m_List(aList), m_Index(aIndex) {}
+        TItem& operator*() const { return m_List->m_Items[m_Index]; }
+        TItem* operator->() const { return &m_List->m_Items[m_Index]; }
+        Index index() const { return m_Index; }
+        bool operator==(const iterator_common& aItr) const { return m_Index == aItr.m_Index; }
+        bool operator!=(const iterator_common& aItr) const { return m_Index != aItr.m_Index; }
+        iterator_common& operator++() { m_Index = m_List->ring(m_Index).m_Neigh[1]; return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { m_Index = m_List->ring(m_Index).m_Neigh[0]; return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TList* m_List;
+        Index m_Index;
+    };
+    using iterator = iterator_common<Item, DetachedList>;
+    using const_iterator = iterator_common<const Item, const DetachedList>;
+
+    iterator begin() { return iterator(this, m_Head.m_Neigh[1]); }
+    iterator end() { return iterator(this, HEAD); }
+    const_iterator begin() const { return const_iterator(this, m_Head.m_Neigh[1]); }
+    const_iterator end() const { return const_iterator(this, HEAD); }
+
+private:
+    Item* m_Items;
+    std::vector<IndexRing<Index>> m_Links;
+    IndexRing<Index> m_Head;
+
+    IndexRing<Index>& ring(Index aIndex)
+    {
+        return HEAD == aIndex ? m_Head : m_Links[aIndex];
+    }
+    const IndexRing<Index>& ring(Index aIndex) const
+    {
+        return HEAD == aIndex ? m_Head : m_Links[aIndex];
+    }
+
+    struct Resolver
+    {
+        DetachedList* m_List;
+        IndexRing<Index>& operator()(Index aIndex) const { return m_List->ring(aIndex); }
+    };
+    Resolver resolver()
+    {
+        return Resolver{this};
+    }
+};
+
+template <class Item, class Index>
+constexpr Index DetachedList<Item, Index>::HEAD;
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <DetachedList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t ITEM_SIZE = 128;
+
+    struct EmbeddedObject
+    {
+        AutoListLink m_Link;
+        uint32_t m_Key;
+        char m_Cold[ITEM_SIZE - sizeof(AutoListLink) - sizeof(uint32_t)];
+    };
+
+    struct PlainObject
+    {
+        uint32_t m_Key;
+        char m_Cold[ITEM_SIZE - sizeof(uint32_t)];
+    };
+
+    using EmbeddedList = AutoList<EmbeddedObject, &EmbeddedObject::m_Link>;
+    using SoaList = DetachedList<PlainObject, uint32_t>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+struct Scenario
+{
+    size_t m_Size;
+    std::vector<uint32_t> m_Order;
+    std::vector<uint32_t> m_Random;
+
+    explicit Scenario(size_t aSize) : m_Size(aSize), m_Order(aSize), m_Random(4 * 1024 * 1024)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_Order[i] = i;
+        std::mt19937 sRand(aSize);
+        std::shuffle(m_Order.begin(), m_Order.end(), sRand);
+        for (uint32_t& sIndex : m_Random)
+            sIndex = sRand() % aSize;
+    }
+};
+
+static void embedded(const Scenario& aScenario)
+{
+    std::cout << "Embedded links, " << aScenario.m_Size << " items of " << sizeof(EmbeddedObject) << " bytes" << std::endl;
+    std::vector<EmbeddedObject> sObjects(aScenario.m_Size);
+    for (size_t i = 0; i < aScenario.m_Size; i++)
+        sObjects[i].m_Key = i;
+    EmbeddedList sList;
+    checkpoint("", 0);
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.insertBack(sObjects[i]);
+    checkpoint("Addition", aScenario.m_Size);
+
+    for (auto sItr = sList.begin(); sItr != sList.end(); ++sItr)
+        ++SideEffect;
+    checkpoint("Traversal (links only)", aScenario.m_Size);
+
+    for (const EmbeddedObject& o : sList)
+        SideEffect += o.m_Key;
+    checkpoint("Traversal (one field)", aScenario.m_Size);
+
+    for (uint32_t i : aScenario.m_Random)
+    {
+        sList.removeItem(sObjects[i]);
+        sList.insertFront(sObjects[i]);
+    }
+    checkpoint("Random relink", aScenario.m_Random.size());
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.removeItem(sObjects[i]);
+    checkpoint("Removing", aScenario.m_Size);
+}
+
+static void detached(const Scenario& aScenario)
+{
+    std::cout << "Detached links, " << aScenario.m_Size << " items of " << sizeof(PlainObject) << " bytes" << std::endl;
+    std::vector<PlainObject> sObjects(aScenario.m_Size);
+    for (size_t i = 0; i < aScenario.m_Size; i++)
+        sObjects[i].m_Key = i;
+    SoaList sList(sObjects.data(), sObjects.size());
+    checkpoint("", 0);
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.insertBack(i);
+    checkpoint("Addition", aScenario.m_Size);
+
+    for (auto sItr = sList.begin(); sItr != sList.end(); ++sItr)
+        SideEffect += sItr.index() & 1;
+    checkpoint("Traversal (links only)", aScenario.m_Size);
+
+    for (const PlainObject& o : sList)
+        SideEffect += o.m_Key;
+    checkpoint("Traversal (one field)", aScenario.m_Size);
+
+    for (uint32_t i : aScenario.m_Random)
+    {
+        sList.remove(i);
+        sList.insertFront(i);
+    }
+    checkpoint("Random relink", aScenario.m_Random.size());
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.remove(i);
+    checkpoint("Removing", aScenario.m_Size);
+}
+
+int main()
+{
+    const size_t SIZES[] = {64 * 1024, 1024 * 1024};
+    for (size_t sSize : SIZES)
+    {
+        Scenario sScenario(sSize);
+        embedded(sScenario);
+        detached(sScenario);
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <DetachedList.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+template <class Index>
+using ObjectList = DetachedList<Object, Index>;
+
+template <class Index>
+void simple()
+{
+    ANNOUNCE();
+
+    Object sObjects[6] = {0, 1, 2, 3, 4, 5};
+    ObjectList<Index> sList(sObjects, 6);
+    CHECK(sList, {});
+    CHECK(!sList.contains(sObjects[0]));
+
+    sList.insertFront(sObjects[1]);
+    sList.insertFront(sObjects[0]);
+    sList.insertBack(sObjects[3]);
+    CHECK(sList, {0, 1, 3});
+    CHECK(sList.contains(sObjects[0]));
+    sList.insertAfter(sObjects[1], sObjects[2]);
+    sList.insertAfter(Index(3), Index(5));
+    CHECK(sList, {0, 1, 2, 3, 5});
+
+    std::vector<int> sIndexes;
+    for (auto sItr = sList.begin(); sItr != sList.end(); ++sItr)
+        sIndexes.push_back(sItr.index());
+    CHECK(sIndexes == std::vector<int>({0, 1, 2, 3, 5}));
+
+    sList.removeItem(sObjects[0]);
+    CHECK(!sList.contains(sObjects[0]));
+    CHECK(sList, {1, 2, 3, 5});
+    sList.remove(Index(5));
+    CHECK(sList, {1, 2, 3});
+    sList.remove(Index(5));
+    CHECK(sList, {1, 2, 3});
+
+    ObjectList<Index> sList2(std::move(sList));
+    CHECK(sList2, {1, 2, 3});
+    sList2.insertBack(sObjects[4]);
+    CHECK(sList2, {1, 2, 3, 4});
+
+    ObjectList<Index> sList3(sList2);
+    CHECK(sList3, {});
+    sList3.insertBack(sObjects[0]);
+    CHECK(sList3, {0});
+
+    sList3 = std::move(sList2);
+    CHECK(sList3, {1, 2, 3, 4});
+
+    sList3.clear();
+    CHECK(sList3, {});
+    for (Index i = 0; i < 6; i++)
+        CHECK(!sList3.contains(i));
+}
+
+template <class Index>
+void shared_items()
+{
+    ANNOUNCE();
+
+    // One item may be in several detached lists at once.
+    std::vector<Object> sObjects(1000);
+    for (int i = 0; i < 1000; i++)
+        sObjects[i].m_Data = i;
+    ObjectList<Index> sAll(sObjects.data(), sObjects.size());
+    ObjectList<Index> sOdd(sObjects.data(), sObjects.size());
+    std::vector<int> sAllRef;
+    std::vector<int> sOddRef;
+    for (int i = 0; i < 1000; i++)
+    {
+        sAll.insertBack(sObjects[i]);
+        sAllRef.push_back(i);
+        if (i % 2 == 1)
+        {
+            sOdd.insertFront(sObjects[i]);
+            sOddRef.insert(sOddRef.begin(), i);
+        }
+    }
+    CHECK(sAll, sAllRef);
+    CHECK(sOdd, sOddRef);
+
+    for (int i = 1; i < 1000; i += 2)
+        sAll.removeItem(sObjects[i]);
+    sAllRef.clear();
+    for (int i = 0; i < 1000; i += 2)
+        sAllRef.push_back(i);
+    CHECK(sAll, sAllRef);
+    CHECK(sOdd, sOddRef);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple<uint16_t>();
+    simple<uint32_t>();
+    shared_items<uint16_t>();
+    shared_items<uint32_t>();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
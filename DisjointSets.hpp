@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include <Ring.hpp>
+
+// Intrusive disjoint sets (union-find) with union by rank and path halving.
+// Members of a set are also linked in a Ring, union joins the rings in O(1),
+// so a set can be enumerated without any extra memory.
+//
+// An item must be add()-ed before it's passed to any other method: a new
+// link is not counted in setCount() and has size 0, unite asserts that.
+
+class DisjointSetsLink
+{
+public:
+    // A new link is a singleton set that is not added yet, see m_Size.
+    DisjointSetsLink() : m_Members(0), m_Parent(this) {}
+    DisjointSetsLink(const DisjointSetsLink&) : DisjointSetsLink() {}
+    DisjointSetsLink& operator=(const DisjointSetsLink&) { return *this; }
+
+    // Must be the first member, see DisjointSets::link.
+    Ring m_Members;
+    DisjointSetsLink* m_Parent;
+    uint32_t m_Rank = 0;
+    // Valid in the root of a set only, 0 until the item is added.
+    uint32_t m_Size = 0;
+};
+
+template <class Item, DisjointSetsLink Item::*LinkMember>
+class DisjointSets
+{
+public:
+    // Makes aItem a singleton set, aItem must not be in another set of
+    // more than one item.
+    void add(Item& aItem)
+    {
+        DisjointSetsLink& sLink = aItem.*LinkMember;
+        sLink.m_Members.init();
+        sLink.m_Parent = &sLink;
+        sLink.m_Rank = 0;
+        sLink.m_Size = 1;
+        ++m_SetCount;
+    }
+    // Number of sets among added items.
+    size_t setCount() const
+    {
+        return m_SetCount;
+    }
+    // Representative of the set of aItem.
+    Item& find(Item& aItem)
+    {
+        return *item(root(&(aItem.*LinkMember)));
+    }
+    bool same(Item& a, Item& b)
+    {
+        return root(&(a.*LinkMember)) == root(&(b.*LinkMember));
+    }
+    size_t size(Item& aItem)
+    {
+        return root(&(aItem.*LinkMember))->m_Size;
+    }
+    // Merges sets of a and b, returns the representative of the result.
+    // Both items must be added.
+    Item& unite(Item& a, Item& b)
+    {
+        DisjointSetsLink* sRootA = root(&(a.*LinkMember));
+        DisjointSetsLink* sRootB = root(&(b.*LinkMember));
+        assert(0 != sRootA->m_Size && 0 != sRootB->m_Size && "unite of an item that is not added");
+        if (sRootA == sRootB)
+            return *item(sRootA);
+        if (sRootA->m_Rank < sRootB->m_Rank)
+            std::swap(sRootA, sRootB);
+        else if (sRootA->m_Rank == sRootB->m_Rank)
+            ++sRootA->m_Rank;
+        sRootB->m_Parent = sRootA;
+        sRootA->m_Size += sRootB->m_Size;
+        sRootA->m_Members.join(&sRootB->m_Members);
+        --m_SetCount;
+        return *item(sRootA);
+    }
+
+    // All members of a set, starting from the given one.
+    class Members
+    {
+    public:
+        class iterator
+        {
+        public:
+            // Spelled out instead of deriving std::iterator, deprecated in C++17.
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Item;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Item*;
+            using reference = Item&;
+
+            iterator(Ring* aRing, size_t aLeft) : m_Ring(aRing), m_Left(aLeft) {}
+            Item& operator*() const { return *item(link(m_Ring)); }
+            Item* operator->() const { return item(link(m_Ring)); }
+            bool operator==(const iterator& aItr) const { return m_Left == aItr.m_Left; }
+            bool operator!=(const iterator& aItr) const { return m_Left != aItr.m_Left; }
+            iterator& operator++() { m_Ring = m_Ring->m_Neigh[1]; --m_Left; return *this; }
+            iterator operator++(int) { iterator aTmp = *this; ++*this; return aTmp; }
+        private:
+            Ring* m_Ring;
+            size_t m_Left;
+        };
+
+        Members(Ring* aStart, size_t aSize) : m_Start(aStart), m_Size(aSize) {}
+        iterator begin() const { return iterator(m_Start, m_Size); }
+        iterator end() const { return iterator(m_Start, 0); }
+        size_t size() const { return m_Size; }
+    private:
+        Ring* m_Start;
+        size_t m_Size;
+    };
+
+    Members members(Item& aItem)
+    {
+        DisjointSetsLink* sLink = &(aItem.*LinkMember);
+        return Members(&sLink->m_Members, root(sLink)->m_Size);
+    }
+
+private:
+    size_t m_SetCount = 0;
+
+    // Path halving: every other link on the path is redirected to its
+    // grandparent.
+    static DisjointSetsLink* root(DisjointSetsLink* aLink)
+    {
+        while (aLink->m_Parent != aLink)
+        {
+            aLink->m_Parent = aLink->m_Parent->m_Parent;
+            aLink = aLink->m_Parent;
+        }
+        return aLink;
+    }
+
+    static DisjointSetsLink* link(Ring* aRing)
+    {
+        return reinterpret_cast<DisjointSetsLink*>(aRing);
+    }
+    static Item* item(DisjointSetsLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <DisjointSets.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct Node
+    {
+        DisjointSetsLink m_Link;
+    };
+
+    using Sets = DisjointSets<Node, &Node::m_Link>;
+
+    // Classic array based union-find, sets are collected to vectors.
+    class ArraySets
+    {
+    public:
+        explicit ArraySets(size_t aSize) : m_Parent(aSize), m_Rank(aSize, 0)
+        {
+            for (size_t i = 0; i < aSize; i++)
+                m_Parent[i] = i;
+        }
+        uint32_t find(uint32_t a)
+        {
+            while (m_Parent[a] != a)
+            {
+                m_Parent[a] = m_Parent[m_Parent[a]];
+                a = m_Parent[a];
+            }
+            return a;
+        }
+        void unite(uint32_t a, uint32_t b)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return;
+            if (m_Rank[a] < m_Rank[b])
+                std::swap(a, b);
+            else if (m_Rank[a] == m_Rank[b])
+                ++m_Rank[a];
+            m_Parent[b] = a;
+        }
+    private:
+        std::vector<uint32_t> m_Parent;
+        std::vector<uint32_t> m_Rank;
+    };
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+// aEdges random unions over aSize nodes, then every set is enumerated.
+static void test(size_t aSize, size_t aEdges)
+{
+    std::cout << aSize << " nodes, " << aEdges << " random edges" << std::endl;
+    std::mt19937 sRand(aSize);
+    std::vector<std::pair<uint32_t, uint32_t>> sEdges(aEdges);
+    for (auto& e : sEdges)
+        e = std::make_pair(sRand() % aSize, sRand() % aSize);
+
+    {
+        checkpoint("", 0);
+        std::vector<Node> sNodes(aSize);
+        Sets sSets;
+        for (Node& n : sNodes)
+            sSets.add(n);
+        checkpoint("DisjointSets, creation", aSize);
+
+        for (auto& e : sEdges)
+            sSets.unite(sNodes[e.first], sNodes[e.second]);
+        checkpoint("DisjointSets, union", aEdges);
+
+        for (Node& n : sNodes)
+        {
+            if (&sSets.find(n) != &n)
+                continue;
+            for (Node& m : sSets.members(n))
+                SideEffect += reinterpret_cast<uintptr_t>(&m) >> 4;
+        }
+        checkpoint("DisjointSets, enumeration of all sets", aSize);
+        SideEffect += sSets.setCount();
+    }
+
+    {
+        checkpoint("", 0);
+        ArraySets sSets(aSize);
+        checkpoint("Array union-find, creation", aSize);
+
+        for (auto& e : sEdges)
+            sSets.unite(e.first, e.second);
+        checkpoint("Array union-find, union", aEdges);
+
+        std::vector<std::vector<uint32_t>> sMembers(aSize);
+        for (size_t i = 0; i < aSize; i++)
+            sMembers[sSets.find(i)].push_back(i);
+        for (const std::vector<uint32_t>& sSet : sMembers)
+            for (uint32_t m : sSet)
+                SideEffect += m;
+        checkpoint("Array union-find, enumeration via per-set vectors", aSize);
+    }
+}
+
+int main()
+{
+    test(1024 * 1024, 512 * 1024);
+    test(8 * 1024 * 1024, 4 * 1024 * 1024);
+    test(8 * 1024 * 1024, 16 * 1024 * 1024);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <DisjointSets.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Node
+{
+    int m_Id;
+    DisjointSetsLink m_Link;
+    Node(int aId = 0) : m_Id(aId) {}
+};
+
+using Sets = DisjointSets<Node, &Node::m_Link>;
+
+std::vector<int> members(Sets& aSets, Node& aNode)
+{
+    std::vector<int> sRes;
+    for (Node& n : aSets.members(aNode))
+        sRes.push_back(n.m_Id);
+    std::sort(sRes.begin(), sRes.end());
+    return sRes;
+}
+
+void simple()
+{
+    ANNOUNCE();
+
+    Node sNodes[6] = {0, 1, 2, 3, 4, 5};
+    Sets sSets;
+    // Items are not in a set until they are added.
+    CHECK(sSets.size(sNodes[0]), size_t(0));
+    for (Node& n : sNodes)
+        sSets.add(n);
+    CHECK(sSets.setCount(), size_t(6));
+    CHECK(&sSets.find(sNodes[3]) == &sNodes[3]);
+    CHECK(sSets.size(sNodes[3]), size_t(1));
+    CHECK(members(sSets, sNodes[3]) == std::vector<int>({3}));
+    CHECK(!sSets.same(sNodes[0], sNodes[1]));
+
+    sSets.unite(sNodes[0], sNodes[1]);
+    sSets.unite(sNodes[2], sNodes[3]);
+    sSets.unite(sNodes[3], sNodes[4]);
+    CHECK(sSets.setCount(), size_t(3));
+    CHECK(sSets.same(sNodes[0], sNodes[1]));
+    CHECK(sSets.same(sNodes[2], sNodes[4]));
+    CHECK(!sSets.same(sNodes[1], sNodes[4]));
+    CHECK(sSets.size(sNodes[4]), size_t(3));
+    CHECK(members(sSets, sNodes[4]) == std::vector<int>({2, 3, 4}));
+    CHECK(sSets.members(sNodes[4]).begin()->m_Id, 4);
+
+    Node& sRoot = sSets.unite(sNodes[1], sNodes[2]);
+    CHECK(&sRoot == &sSets.find(sNodes[0]));
+    CHECK(&sRoot == &sSets.find(sNodes[4]));
+    CHECK(&sSets.unite(sNodes[0], sNodes[4]) == &sRoot);
+    CHECK(sSets.setCount(), size_t(2));
+    CHECK(sSets.size(sNodes[0]), size_t(5));
+    CHECK(members(sSets, sNodes[0]) == std::vector<int>({0, 1, 2, 3, 4}));
+    CHECK(members(sSets, sNodes[5]) == std::vector<int>({5}));
+
+    // Re-adding makes a singleton again.
+    Sets sOther;
+    sOther.add(sNodes[5]);
+    CHECK(sOther.setCount(), size_t(1));
+    CHECK(sOther.size(sNodes[5]), size_t(1));
+}
+
+// Random unions against naive labeling.
+void massive()
+{
+    ANNOUNCE();
+
+    const int COUNT = 2000;
+    std::vector<Node> sNodes(COUNT);
+    std::vector<int> sLabel(COUNT);
+    Sets sSets;
+    for (int i = 0; i < COUNT; i++)
+    {
+        sNodes[i].m_Id = i;
+        sLabel[i] = i;
+        sSets.add(sNodes[i]);
+    }
+    srand(7);
+    size_t sSetCount = COUNT;
+    bool sOk = true;
+    for (int sStep = 0; sStep < 1500; sStep++)
+    {
+        int a = rand() % COUNT;
+        int b = rand() % COUNT;
+        if (sLabel[a] != sLabel[b])
+        {
+            int sOld = sLabel[b];
+            for (int& l : sLabel)
+                if (l == sOld)
+                    l = sLabel[a];
+            --sSetCount;
+        }
+        sSets.unite(sNodes[a], sNodes[b]);
+        int c = rand() % COUNT;
+        std::vector<int> sRef;
+        for (int i = 0; i < COUNT; i++)
+            if (sLabel[i] == sLabel[c])
+                sRef.push_back(i);
+        sOk = sOk && members(sSets, sNodes[c]) == sRef;
+        sOk = sOk && sSets.size(sNodes[c]) == sRef.size();
+        sOk = sOk && sSets.same(sNodes[a], sNodes[c]) == (sLabel[a] == sLabel[c]);
+    }
+    CHECK(sOk);
+    CHECK(sSets.setCount(), sSetCount);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    massive();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include <Ring.hpp>
+
+// Intrusive Fibonacci heap. Root list and sibling lists are Rings, so meld
+// and moving children to the root list are single Ring::join calls.
+// O(1) insert, top, meld and amortized O(1) decreaseKey; amortized
+// O(log n) pop and erase.
+//
+// Less compares items, the top is the least item. A key is changed by the
+// user, then decreaseKey is called for the item; the key must not increase
+// (erase and insert the item to do that). An item must be popped or erased
+// before it's destroyed.
+
+class FibonacciHeapLink
+{
+public:
+    FibonacciHeapLink() : m_Siblings(0) {}
+    FibonacciHeapLink(const FibonacciHeapLink&) : m_Siblings(0) {}
+    FibonacciHeapLink& operator=(const FibonacciHeapLink&) { return *this; }
+    bool isAlone() const { return m_Siblings.isAlone() && nullptr == m_Parent; }
+
+    // Must be the first member, see FibonacciHeap::link.
+    Ring m_Siblings;
+    FibonacciHeapLink* m_Parent = nullptr;
+    // Any of the children, they are linked by m_Siblings.
+    FibonacciHeapLink* m_Child = nullptr;
+    uint32_t m_Degree = 0;
+    bool m_Marked = false;
+};
+
+template <class Item, FibonacciHeapLink Item::*LinkMember, class Less = std::less<Item>>
+class FibonacciHeap
+{
+public:
+    explicit FibonacciHeap(const Less& aLess = Less()) : m_Roots(0), m_Less(aLess) {}
+    ~FibonacciHeap()
+    {
+        m_Roots.remove();
+    }
+    FibonacciHeap(const FibonacciHeap&) = delete;
+    FibonacciHeap& operator=(const FibonacciHeap&) = delete;
+
+    bool empty() const
+    {
+        return 0 == m_Size;
+    }
+    size_t size() const
+    {
+        return m_Size;
+    }
+    Item& top()
+    {
+        return *item(m_Min);
+    }
+    const Item& top() const
+    {
+        return *item(m_Min);
+    }
+
+    void insert(Item& aItem)
+    {
+        FibonacciHeapLink* sLink = &(aItem.*LinkMember);
+        m_Roots.add(&sLink->m_Siblings, true);
+        updateMin(sLink);
+        ++m_Size;
+    }
+    // Moves all items of aHeap to this heap.
+    void meld(FibonacciHeap& aHeap)
+    {
+        if (aHeap.empty())
+            return;
+        Ring* sFirst = aHeap.m_Roots.m_Neigh[1];
+        aHeap.m_Roots.remove();
+        aHeap.m_Roots.init();
+        m_Roots.join(sFirst);
+        updateMin(aHeap.m_Min);
+        m_Size += aHeap.m_Size;
+        aHeap.m_Min = nullptr;
+        aHeap.m_Size = 0;
+    }
+    // The key of aItem was decreased (or left the same).
+    void decreaseKey(Item& aItem)
+    {
+        FibonacciHeapLink* sLink = &(aItem.*LinkMember);
+        FibonacciHeapLink* sParent = sLink->m_Parent;
+        if (nullptr != sParent && m_Less(aItem, *item(sParent)))
+        {
+            cut(sLink);
+            cascadingCut(sParent);
+        }
+        updateMin(sLink);
+    }
+    void pop()
+    {
+        FibonacciHeapLink* sMin = m_Min;
+        if (nullptr != sMin->m_Child)
+        {
+            FibonacciHeapLink* sChild = sMin->m_Child;
+            do
+            {
+                sChild->m_Parent = nullptr;
+                sChild->m_Marked = false;
+                sChild = link(sChild->m_Siblings.m_Neigh[1]);
+            } while (sChild != sMin->m_Child);
+            m_Roots.join(&sChild->m_Siblings);
+        }
+        sMin->m_Siblings.remove();
+        reset(sMin);
+        --m_Size;
+        consolidate();
+    }
+    void erase(Item& aItem)
+    {
+        FibonacciHeapLink* sLink = &(aItem.*LinkMember);
+        FibonacciHeapLink* sParent = sLink->m_Parent;
+        if (nullptr != sParent)
+        {
+            cut(sLink);
+            cascadingCut(sParent);
+        }
+        m_Min = sLink;
+        pop();
+    }
+
+private:
+    Ring m_Roots;
+    FibonacciHeapLink* m_Min = nullptr;
+    size_t m_Size = 0;
+    Less m_Less;
+
+    // Max degree is log_phi(n) < 1.45 * log2(n).
+    static constexpr size_t MAX_DEGREE = 96;
+
+    void updateMin(FibonacciHeapLink* aLink)
+    {
+        if (nullptr == m_Min || m_Less(*item(aLink), *item(m_Min)))
+            m_Min = aLink;
+    }
+    static void reset(FibonacciHeapLink* aLink)
+    {
+        aLink->m_Siblings.init();
+        aLink->m_Parent = nullptr;
+        aLink->m_Child = nullptr;
+        aLink->m_Degree = 0;
+        aLink->m_Marked = false;
+    }
+
+    // Moves aLink from its parent's children to the roots.
+    void cut(FibonacciHeapLink* aLink)
+    {
+        FibonacciHeapLink* sParent = aLink->m_Parent;
+        if (aLink->m_Siblings.isAlone())
+            sParent->m_Child = nullptr;
+        else if (sParent->m_Child == aLink)
+            sParent->m_Child = link(aLink->m_Siblings.m_Neigh[1]);
+        aLink->m_Siblings.remove();
+        m_Roots.add(&aLink->m_Siblings, true);
+        --sParent->m_Degree;
+        aLink->m_Parent = nullptr;
+        aLink->m_Marked = false;
+    }
+    void cascadingCut(FibonacciHeapLink* aLink)
+    {
+        for (FibonacciHeapLink* sParent = aLink->m_Parent; nullptr != sParent; sParent = aLink->m_Parent)
+        {
+            if (!aLink->m_Marked)
+            {
+                aLink->m_Marked = true;
+                return;
+            }
+            cut(aLink);
+            aLink = sParent;
+        }
+    }
+    // Makes aChild (a root) a child of aParent (a root).
+    void adopt(FibonacciHeapLink* aParent, FibonacciHeapLink* aChild)
+    {
+        aChild->m_Siblings.remove();
+        if (nullptr == aParent->m_Child)
+        {
+            aChild->m_Siblings.init();
+            aParent->m_Child = aChild;
+        }
+        else
+        {
+            aParent->m_Child->m_Siblings.add(&aChild->m_Siblings);
+        }
+        aChild->m_Parent = aParent;
+        aChild->m_Marked = false;
+        ++aParent->m_Degree;
+    }
+    // Links roots of equal degree until all degrees are distinct.
+    void consolidate()
+    {
+        FibonacciHeapLink* sByDegree[MAX_DEGREE] = {};
+        m_Min = nullptr;
+        for (Ring* sRing = m_Roots.m_Neigh[1]; sRing != &m_Roots; )
+        {
+            Ring* sNext = sRing->m_Neigh[1];
+            FibonacciHeapLink* sLink = link(sRing);
+            while (nullptr != sByDegree[sLink->m_Degree])
+            {
+                FibonacciHeapLink* sOther = sByDegree[sLink->m_Degree];
+                sByDegree[sLink->m_Degree] = nullptr;
+                if (m_Less(*item(sOther), *item(sLink)))
+                    std::swap(sLink, sOther);
+                adopt(sLink, sOther);
+            }
+            sByDegree[sLink->m_Degree] = sLink;
+            sRing = sNext;
+        }
+        for (FibonacciHeapLink* sLink : sByDegree)
+            if (nullptr != sLink)
+                updateMin(sLink);
+    }
+
+    static FibonacciHeapLink* link(Ring* aRing)
+    {
+        return reinterpret_cast<FibonacciHeapLink*>(aRing);
+    }
+    static Item* item(FibonacciHeapLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <FibonacciHeap.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const uint64_t INF = std::numeric_limits<uint64_t>::max();
+
+    // Graph in compressed sparse row form.
+    struct Graph
+    {
+        std::vector<uint32_t> m_Offsets;
+        std::vector<uint32_t> m_Targets;
+        std::vector<uint32_t> m_Weights;
+
+        size_t vertexCount() const { return m_Offsets.size() - 1; }
+        size_t edgeCount() const { return m_Targets.size(); }
+    };
+
+    // Random graph with aDegree edges per vertex and a random Hamiltonian
+    // path, so that all vertices are reachable from the first one.
+    Graph randomGraph(size_t aVertices, size_t aDegree)
+    {
+        std::mt19937 sRand(aVertices * aDegree);
+        std::vector<uint32_t> sPath(aVertices);
+        for (size_t i = 0; i < aVertices; i++)
+            sPath[i] = i;
+        std::shuffle(sPath.begin() + 1, sPath.end(), sRand);
+        std::vector<uint32_t> sNext(aVertices);
+        for (size_t i = 0; i + 1 < aVertices; i++)
+            sNext[sPath[i]] = sPath[i + 1];
+
+        Graph sGraph;
+        sGraph.m_Offsets.reserve(aVertices + 1);
+        for (size_t v = 0; v < aVertices; v++)
+        {
+            sGraph.m_Offsets.push_back(sGraph.m_Targets.size());
+            for (size_t e = 0; e < aDegree; e++)
+            {
+                bool sPathEdge = e == 0 && v != sPath[aVertices - 1];
+                sGraph.m_Targets.push_back(sPathEdge ? sNext[v] : sRand() % aVertices);
+                sGraph.m_Weights.push_back(sPathEdge ? 1000000 : 1 + sRand() % 1000);
+            }
+        }
+        sGraph.m_Offsets.push_back(sGraph.m_Targets.size());
+        return sGraph;
+    }
+
+    struct Vertex
+    {
+        uint64_t m_Dist = INF;
+        FibonacciHeapLink m_Link;
+    };
+
+    struct VertexLess
+    {
+        bool operator()(const Vertex& a, const Vertex& b) const { return a.m_Dist < b.m_Dist; }
+    };
+
+    using VertexHeap = FibonacciHeap<Vertex, &Vertex::m_Link, VertexLess>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+static uint64_t dijkstraFibonacci(const Graph& aGraph, size_t& aDecreases)
+{
+    std::vector<Vertex> sVertices(aGraph.vertexCount());
+    VertexHeap sHeap;
+    sVertices[0].m_Dist = 0;
+    sHeap.insert(sVertices[0]);
+    aDecreases = 0;
+    uint64_t sSum = 0;
+    while (!sHeap.empty())
+    {
+        Vertex& u = sHeap.top();
+        sHeap.pop();
+        sSum += u.m_Dist;
+        size_t sU = &u - sVertices.data();
+        for (uint32_t e = aGraph.m_Offsets[sU]; e < aGraph.m_Offsets[sU + 1]; e++)
+        {
+            Vertex& v = sVertices[aGraph.m_Targets[e]];
+            uint64_t sDist = u.m_Dist + aGraph.m_Weights[e];
+            if (sDist >= v.m_Dist)
+                continue;
+            bool sQueued = v.m_Dist != INF;
+            v.m_Dist = sDist;
+            if (sQueued)
+            {
+                sHeap.decreaseKey(v);
+                ++aDecreases;
+            }
+            else
+            {
+                sHeap.insert(v);
+            }
+        }
+    }
+    return sSum;
+}
+
+// Lazy deletion: a vertex is pushed again on every decrease, outdated
+// entries are skipped when popped.
+static uint64_t dijkstraPriorityQueue(const Graph& aGraph)
+{
+    using Entry = std::pair<uint64_t, uint32_t>;
+    std::vector<uint64_t> sDist(aGraph.vertexCount(), INF);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> sQueue;
+    sDist[0] = 0;
+    sQueue.push(Entry(0, 0));
+    uint64_t sSum = 0;
+    while (!sQueue.empty())
+    {
+        Entry sTop = sQueue.top();
+        sQueue.pop();
+        uint32_t sU = sTop.second;
+        if (sTop.first != sDist[sU])
+            continue;
+        sSum += sTop.first;
+        for (uint32_t e = aGraph.m_Offsets[sU]; e < aGraph.m_Offsets[sU + 1]; e++)
+        {
+            uint32_t sV = aGraph.m_Targets[e];
+            uint64_t sNewDist = sTop.first + aGraph.m_Weights[e];
+            if (sNewDist >= sDist[sV])
+                continue;
+            sDist[sV] = sNewDist;
+            sQueue.push(Entry(sNewDist, sV));
+        }
+    }
+    return sSum;
+}
+
+static void test(size_t aVertices, size_t aDegree)
+{
+    Graph sGraph = randomGraph(aVertices, aDegree);
+    std::cout << "Dijkstra, " << aVertices << " vertices, " << sGraph.edgeCount() << " edges" << std::endl;
+    checkpoint("", 0);
+
+    size_t sDecreases = 0;
+    uint64_t sFibonacci = dijkstraFibonacci(sGraph, sDecreases);
+    checkpoint("FibonacciHeap (edges)", sGraph.edgeCount());
+
+    uint64_t sQueue = dijkstraPriorityQueue(sGraph);
+    checkpoint("std::priority_queue with lazy deletion (edges)", sGraph.edgeCount());
+
+    std::cout << "Decrease key calls: " << sDecreases << std::endl;
+    if (sFibonacci != sQueue)
+        std::cout << "Results differ!" << std::endl;
+    SideEffect += sFibonacci;
+}
+
+int main()
+{
+    test(1024 * 1024, 8);
+    test(256 * 1024, 64);
+    test(16 * 1024, 1024);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <FibonacciHeap.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Node
+{
+    int m_Key;
+    FibonacciHeapLink m_Link;
+    Node(int aKey = 0) : m_Key(aKey) {}
+};
+
+struct NodeLess
+{
+    bool operator()(const Node& a, const Node& b) const { return a.m_Key < b.m_Key; }
+};
+
+using Heap = FibonacciHeap<Node, &Node::m_Link, NodeLess>;
+
+void simple()
+{
+    ANNOUNCE();
+
+    Node sNodes[5] = {50, 20, 40, 10, 30};
+    Heap sHeap;
+    CHECK(sHeap.empty());
+    for (Node& n : sNodes)
+        sHeap.insert(n);
+    CHECK(sHeap.size(), size_t(5));
+    CHECK(sHeap.top().m_Key, 10);
+
+    sHeap.pop();
+    CHECK(sNodes[3].m_Link.isAlone());
+    CHECK(sHeap.top().m_Key, 20);
+
+    // After pop the heap is consolidated, so there are children to cut.
+    sNodes[0].m_Key = 5;
+    sHeap.decreaseKey(sNodes[0]);
+    CHECK(sHeap.top().m_Key, 5);
+    sHeap.erase(sNodes[1]);
+    CHECK(sHeap.size(), size_t(3));
+
+    int sExpected[] = {5, 30, 40};
+    for (int sKey : sExpected)
+    {
+        CHECK(sHeap.top().m_Key, sKey);
+        sHeap.pop();
+    }
+    CHECK(sHeap.empty());
+    for (const Node& n : sNodes)
+        CHECK(n.m_Link.isAlone());
+}
+
+void meld()
+{
+    ANNOUNCE();
+
+    Node sNodes[6] = {6, 2, 4, 5, 1, 3};
+    Heap sHeap1;
+    Heap sHeap2;
+    for (int i = 0; i < 3; i++)
+        sHeap1.insert(sNodes[i]);
+    for (int i = 3; i < 6; i++)
+        sHeap2.insert(sNodes[i]);
+    sHeap1.pop();
+    sHeap1.meld(sHeap2);
+    CHECK(sHeap2.empty());
+    CHECK(sHeap1.size(), size_t(5));
+    sHeap1.meld(sHeap2);
+    CHECK(sHeap1.size(), size_t(5));
+    sHeap2.meld(sHeap1);
+    CHECK(sHeap1.empty());
+    for (int sKey = 1; sKey <= 6; sKey++)
+    {
+        if (sKey == 2)
+            continue;
+        CHECK(sHeap2.top().m_Key, sKey);
+        sHeap2.pop();
+    }
+    CHECK(sHeap2.empty());
+}
+
+// Random operations against std::multiset.
+void massive()
+{
+    ANNOUNCE();
+
+    const int COUNT = 1000;
+    const int OPS = 200000;
+    std::vector<Node> sNodes(COUNT);
+    std::vector<bool> sIn(COUNT, false);
+    std::multiset<std::pair<int, int>> sRef;
+    Heap sHeap;
+    srand(42);
+    bool sOk = true;
+    for (int i = 0; i < OPS && sOk; i++)
+    {
+        int sIdx = rand() % COUNT;
+        Node& n = sNodes[sIdx];
+        int sOp = rand() % 8;
+        if (!sIn[sIdx])
+        {
+            n.m_Key = rand() % 100000;
+            sHeap.insert(n);
+            sRef.insert({n.m_Key, sIdx});
+            sIn[sIdx] = true;
+        }
+        else if (sOp < 4)
+        {
+            sRef.erase(sRef.find({n.m_Key, sIdx}));
+            n.m_Key -= rand() % 1000;
+            sHeap.decreaseKey(n);
+            sRef.insert({n.m_Key, sIdx});
+        }
+        else if (sOp < 5)
+        {
+            sRef.erase(sRef.find({n.m_Key, sIdx}));
+            sHeap.erase(n);
+            sIn[sIdx] = false;
+            sOk = sOk && n.m_Link.isAlone();
+        }
+        else if (sOp < 7 && !sHeap.empty())
+        {
+            Node& sTop = sHeap.top();
+            sOk = sOk && sTop.m_Key == sRef.begin()->first;
+            int sTopIdx = static_cast<int>(&sTop - sNodes.data());
+            sRef.erase(sRef.find({sTop.m_Key, sTopIdx}));
+            sHeap.pop();
+            sIn[sTopIdx] = false;
+        }
+        sOk = sOk && sHeap.size() == sRef.size();
+        if (!sHeap.empty())
+            sOk = sOk && sHeap.top().m_Key == sRef.begin()->first;
+    }
+    CHECK(sOk);
+    while (!sHeap.empty())
+    {
+        sOk = sOk && sHeap.top().m_Key == sRef.begin()->first;
+        sRef.erase(sRef.begin());
+        sHeap.pop();
+    }
+    CHECK(sOk);
+    CHECK(sRef.empty());
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    meld();
+    massive();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Minimal futex based parking. futexWait blocks while *aWord == aExpected
+// (it may also return spuriously), futexWake wakes up to aCount waiters of
+// aWord. Both are process private. Where futexes are not available waiting
+// falls back to yielding.
+
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+inline void futexWait(std::atomic<uint32_t>* aWord, uint32_t aExpected)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(aWord), FUTEX_WAIT_PRIVATE, aExpected, nullptr, nullptr, 0);
+#else
+    if (aWord->load(std::memory_order_relaxed) == aExpected)
+        std::this_thread::yield();
+#endif
+}
+
+inline void futexWake(std::atomic<uint32_t>* aWord, uint32_t aCount)
+{
+#if defined(__linux__)
+    if (aCount > INT_MAX)
+        aCount = INT_MAX;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(aWord), FUTEX_WAKE_PRIVATE, aCount, nullptr, nullptr, 0);
+#else
+    (void)aWord;
+    (void)aCount;
+#endif
+}
+
+// Mutex of three states (Drepper, "Futexes Are Tricky"): unlocked, locked
+// and locked with possible waiters; uncontended lock and unlock are one
+// atomic operation each and never enter the kernel. A short spin precedes
+// parking. Meets BasicLockable, so std::lock_guard works with it.
+class FutexMutex
+{
+public:
+    FutexMutex() = default;
+    FutexMutex(const FutexMutex&) = delete;
+    FutexMutex& operator=(const FutexMutex&) = delete;
+
+    void lock()
+    {
+        uint32_t sState = UNLOCKED;
+        if (m_State.compare_exchange_strong(sState, LOCKED, std::memory_order_acquire))
+            return;
+        for (int i = 0; i < SPIN_COUNT; i++)
+        {
+            cpuRelax();
+            sState = UNLOCKED;
+            if (m_State.load(std::memory_order_relaxed) == UNLOCKED &&
+                m_State.compare_exchange_weak(sState, LOCKED, std::memory_order_acquire))
+                return;
+        }
+        while (m_State.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED)
+            futexWait(&m_State, CONTENDED);
+    }
+    bool try_lock()
+    {
+        uint32_t sState = UNLOCKED;
+        return m_State.compare_exchange_strong(sState, LOCKED, std::memory_order_acquire);
+    }
+    void unlock()
+    {
+        if (m_State.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+            futexWake(&m_State, 1);
+    }
+
+private:
+    enum : uint32_t
+    {
+        UNLOCKED,
+        LOCKED,
+        CONTENDED
+    };
+    static constexpr int SPIN_COUNT = 100;
+    std::atomic<uint32_t> m_State{UNLOCKED};
+};
+
+// Sequence word to wait for a change of some state guarded by a lock: a
+// waiter registers under the lock, releases the lock and waits while the
+// sequence stays the same; a notifier bumps the sequence under the lock and
+// wakes waiters after releasing it. The notifier unregisters the waiters it
+// wakes, so while they are getting scheduled further notifications don't
+// enter the kernel. A waiter that is woken without being unregistered (the
+// sequence moved because of somebody else) is just counted twice when it
+// waits again, which costs one extra wake at most.
+class FutexEvent
+{
+public:
+    // Under the lock.
+    uint32_t prepareWait()
+    {
+        ++m_Waiters;
+        return m_Sequence.load(std::memory_order_relaxed);
+    }
+    // Without the lock, after prepareWait. Returns when the sequence moves
+    // (or spuriously); the waiter must take the lock and check its
+    // condition again.
+    void wait(uint32_t aSequence)
+    {
+        for (int i = 0; i < SPIN_COUNT; i++)
+        {
+            if (m_Sequence.load(std::memory_order_acquire) != aSequence)
+                return;
+            cpuRelax();
+        }
+        futexWait(&m_Sequence, aSequence);
+    }
+    // Under the lock, returns the number of waiters to wake with wake().
+    uint32_t notify(uint32_t aCount)
+    {
+        if (0 == m_Waiters)
+            return 0;
+        uint32_t sCount = aCount < m_Waiters ? aCount : m_Waiters;
+        m_Waiters -= sCount;
+        m_Sequence.fetch_add(1, std::memory_order_release);
+        return sCount;
+    }
+    // Without the lock.
+    void wake(uint32_t aCount)
+    {
+        if (0 != aCount)
+            futexWake(&m_Sequence, aCount);
+    }
+
+private:
+    static constexpr int SPIN_COUNT = 100;
+    std::atomic<uint32_t> m_Sequence{0};
+    uint32_t m_Waiters = 0;
+};
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include <Ring.hpp>
+
+// AutoList (see AutoList.hpp) with O(1) clear(). The list has a generation
+// counter that is bumped by clear(), a link remembers the list and its
+// generation at the moment of insertion. A link with a stale generation is
+// alone: it never writes to its (former) neighbours, and it's relinked from
+// scratch by the next insertion.
+//
+// Links refer to the list object, thus the list is neither copyable nor
+// movable and must outlive the items that were ever linked to it (a list
+// and its items in one arena that is dropped at once is the typical case).
+
+class GenerationAutoListLink
+{
+public:
+    GenerationAutoListLink() : m_Ring(0) {}
+    GenerationAutoListLink(const GenerationAutoListLink& aLink)
+    {
+        if (aLink.isAlone())
+        {
+            m_Ring.init();
+        }
+        else
+        {
+            aLink.m_Ring.add(&m_Ring);
+            m_ListGeneration = aLink.m_ListGeneration;
+            m_Stamp = aLink.m_Stamp;
+        }
+    }
+    GenerationAutoListLink(GenerationAutoListLink&& aLink) noexcept : GenerationAutoListLink()
+    {
+        if (aLink.isAlone())
+            return;
+        aLink.m_Ring.add(&m_Ring);
+        aLink.m_Ring.remove();
+        aLink.m_Ring.init();
+        m_ListGeneration = aLink.m_ListGeneration;
+        m_Stamp = aLink.m_Stamp;
+        aLink.m_ListGeneration = nullptr;
+    }
+    ~GenerationAutoListLink()
+    {
+        if (!isStale())
+            m_Ring.remove();
+    }
+    GenerationAutoListLink& operator=(const GenerationAutoListLink& aLink)
+    {
+        if (this == &aLink)
+            return *this;
+        remove();
+        if (!aLink.isAlone())
+        {
+            aLink.m_Ring.add(&m_Ring, false);
+            m_ListGeneration = aLink.m_ListGeneration;
+            m_Stamp = aLink.m_Stamp;
+        }
+        return *this;
+    }
+    GenerationAutoListLink& operator=(GenerationAutoListLink&& aLink) noexcept
+    {
+        if (this == &aLink)
+            return *this;
+        remove();
+        if (!aLink.isAlone())
+        {
+            aLink.m_Ring.add(&m_Ring);
+            aLink.m_Ring.remove();
+            aLink.m_Ring.init();
+            m_ListGeneration = aLink.m_ListGeneration;
+            m_Stamp = aLink.m_Stamp;
+            aLink.m_ListGeneration = nullptr;
+        }
+        return *this;
+    }
+    bool isAlone() const
+    {
+        return isStale() || m_Ring.isAlone();
+    }
+    bool isStale() const
+    {
+        return nullptr != m_ListGeneration && *m_ListGeneration != m_Stamp;
+    }
+    void remove()
+    {
+        if (!isStale())
+            m_Ring.remove();
+        m_Ring.init();
+        m_ListGeneration = nullptr;
+    }
+    int selfCheck() const
+    {
+        return isStale() ? 0 : m_Ring.selfCheck();
+    }
+
+    mutable Ring m_Ring;
+    const uint64_t* m_ListGeneration = nullptr;
+    uint64_t m_Stamp = 0;
+};
+
+template <class Item, GenerationAutoListLink Item::*LinkMember>
+class GenerationAutoList
+{
+public:
+    GenerationAutoList() : m_Ring(0) {}
+    ~GenerationAutoList()
+    {
+        m_Ring.remove();
+    }
+
+    GenerationAutoList(const GenerationAutoList&) = delete;
+    GenerationAutoList& operator=(const GenerationAutoList&) = delete;
+
+    void insertFront(Item& aItem)
+    {
+        m_Ring.add(&prepare(aItem), false);
+    }
+    void insertBack(Item& aItem)
+    {
+        m_Ring.add(&prepare(aItem), true);
+    }
+    void insertAfter(Item& aExistingItem, Item& aNewItem)
+    {
+        (aExistingItem.*LinkMember).m_Ring.add(&prepare(aNewItem), false);
+    }
+    void removeItem(Item& aItem)
+    {
+        (aItem.*LinkMember).remove();
+    }
+    // Makes the list empty and all its items alone, O(1).
+    void clear()
+    {
+        ++m_Generation;
+        m_Ring.init();
+    }
+    uint64_t generation() const
+    {
+        return m_Generation;
+    }
+    bool empty() const
+    {
+        return m_Ring.isAlone();
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+    Item& front()
+    {
+        return *item(m_Ring.m_Neigh[1]);
+    }
+    const Item& front() const
+    {
+        return *item(m_Ring.m_Neigh[1]);
+    }
+    Item& back()
+    {
+        return *item(m_Ring.m_Neigh[0]);
+    }
+    const Item& back() const
+    {
+        return *item(m_Ring.m_Neigh[0]);
+    }
+
+    template <class TItem, class TRing>
+    class iterator_common
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing) : m_Ring(aRing) {}
+        TItem& operator*() const { return *item(m_Ring); }
+        TItem* operator->() const { return item(m_Ring); }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
+        bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
+        iterator_common& operator++() { m_Ring = m_Ring->m_Neigh[1]; return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { m_Ring = m_Ring->m_Neigh[0]; return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TRing* m_Ring;
+    };
+    using iterator = iterator_common<Item, Ring>;
+    using const_iterator = iterator_common<const Item, const Ring>;
+
+    iterator begin() { return iterator(m_Ring.m_Neigh[1]); }
+    iterator end() { return iterator(&m_Ring); }
+    const_iterator begin() const { return const_iterator(m_Ring.m_Neigh[1]); }
+    const_iterator end() const { return const_iterator(&m_Ring); }
+
+private:
+    Ring m_Ring;
+    uint64_t m_Generation = 0;
+
+    // A stale link is initialized without touching its former neighbours.
+    Ring& prepare(Item& aItem)
+    {
+        GenerationAutoListLink& sLink = aItem.*LinkMember;
+        if (sLink.isStale())
+            sLink.m_Ring.init();
+        sLink.m_ListGeneration = &m_Generation;
+        sLink.m_Stamp = m_Generation;
+        return sLink.m_Ring;
+    }
+
+    static Item* item(Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+    static const Item* item(const Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
+    }
+};
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <GenerationAutoList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Object
+    {
+        AutoListLink m_Link;
+        uint64_t m_Key;
+    };
+
+    struct GenerationObject
+    {
+        GenerationAutoListLink m_Link;
+        uint64_t m_Key;
+    };
+
+    using ObjectList = AutoList<Object, &Object::m_Link>;
+    using GenerationList = GenerationAutoList<GenerationObject, &GenerationObject::m_Link>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+static void clear(ObjectList& aList)
+{
+    while (!aList.empty())
+        aList.removeItem(aList.front());
+}
+
+static void clear(GenerationList& aList)
+{
+    aList.clear();
+}
+
+// Items are linked in random order, then the list is cleared; speed is
+// measured in items per second.
+template <class T, class List>
+static void test(const char* aName, size_t aSize, size_t aRounds)
+{
+    std::cout << aName << ", " << aSize << " items" << std::endl;
+    std::vector<T> sObjects(aSize);
+    std::vector<T*> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+    {
+        sObjects[i].m_Key = i;
+        sOrder[i] = &sObjects[i];
+    }
+    std::shuffle(sOrder.begin(), sOrder.end(), std::mt19937(aSize));
+    List sList;
+    checkpoint("", 0);
+
+    for (T* o : sOrder)
+        sList.insertBack(*o);
+    checkpoint("", 0);
+    clear(sList);
+    checkpoint("Clear", aSize);
+
+    for (size_t r = 0; r < aRounds; r++)
+    {
+        for (T* o : sOrder)
+            sList.insertBack(*o);
+        clear(sList);
+    }
+    checkpoint("Fill and clear", aSize * aRounds);
+
+    for (const T& o : sList)
+        SideEffect += o.m_Key;
+}
+
+int main()
+{
+    const size_t SIZES[] = {1024, 64 * 1024, 1024 * 1024};
+    for (size_t sSize : SIZES)
+    {
+        size_t sRounds = 4 * 1024 * 1024 / sSize;
+        test<Object, ObjectList>("AutoList", sSize, sRounds);
+        test<GenerationObject, GenerationList>("GenerationAutoList", sSize, sRounds);
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <GenerationAutoList.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    GenerationAutoListLink m_Link;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+using ObjectList = GenerationAutoList<Object, &Object::m_Link>;
+
+void simple()
+{
+    ANNOUNCE();
+
+    Object sObjects[6] = {0, 1, 2, 3, 4, 5};
+    ObjectList sList;
+    CHECK(sList, std::vector<int>());
+    for (Object& o : sObjects)
+        sList.insertBack(o);
+    CHECK(sList, {0, 1, 2, 3, 4, 5});
+    sList.removeItem(sObjects[2]);
+    CHECK(sList, {0, 1, 3, 4, 5});
+    CHECK(sObjects[2].m_Link.isAlone());
+    CHECK(!sObjects[3].m_Link.isAlone());
+
+    CHECK(sList.generation(), uint64_t(0));
+    sList.clear();
+    CHECK(sList.generation(), uint64_t(1));
+    CHECK(sList, std::vector<int>());
+    bool sAlone = true;
+    for (const Object& o : sObjects)
+        sAlone = sAlone && o.m_Link.isAlone();
+    CHECK(sAlone);
+    CHECK(sObjects[3].m_Link.isStale());
+    CHECK(!sObjects[2].m_Link.isStale());
+
+    // Stale links are relinked from scratch.
+    sList.insertFront(sObjects[3]);
+    sList.insertBack(sObjects[1]);
+    sList.insertAfter(sObjects[3], sObjects[2]);
+    CHECK(sList, {3, 2, 1});
+    CHECK(!sObjects[3].m_Link.isStale());
+
+    // Stale links do not touch their former neighbours.
+    sList.removeItem(sObjects[4]);
+    sObjects[5].m_Link.remove();
+    CHECK(sList, {3, 2, 1});
+    sList.insertBack(sObjects[4]);
+    CHECK(sList, {3, 2, 1, 4});
+
+    sList.clear();
+    sList.clear();
+    CHECK(sList, std::vector<int>());
+    for (int i = 5; i >= 0; i--)
+        sList.insertFront(sObjects[i]);
+    CHECK(sList, {0, 1, 2, 3, 4, 5});
+}
+
+void lifetime()
+{
+    ANNOUNCE();
+
+    ObjectList sList;
+    std::vector<Object*> sObjects;
+    for (int i = 0; i < 100; i++)
+    {
+        sObjects.push_back(new Object(i));
+        sList.insertBack(*sObjects.back());
+    }
+    sList.clear();
+    // Every other is freed: no stale link may be written to.
+    for (int i = 0; i < 100; i += 2)
+        delete sObjects[i];
+    for (int i = 1; i < 100; i += 2)
+        sList.insertBack(*sObjects[i]);
+    std::vector<int> sRef;
+    for (int i = 1; i < 100; i += 2)
+        sRef.push_back(i);
+    CHECK(sList, sRef);
+
+    // Copies and moves.
+    {
+        Object sCopy(*sObjects[1]);
+        CHECK(sList.front().m_Data, 1);
+        CHECK(!sCopy.m_Link.isAlone());
+        sList.clear();
+        Object sStaleCopy(*sObjects[1]);
+        CHECK(sStaleCopy.m_Link.isAlone());
+        CHECK(!sStaleCopy.m_Link.isStale());
+        sList.insertBack(sStaleCopy);
+        Object sMoved(std::move(sStaleCopy));
+        CHECK(sStaleCopy.m_Link.isAlone());
+        CHECK(sList.front().m_Data, 1);
+        CHECK(&sList.front() == &sMoved);
+        sStaleCopy = sMoved;
+        CHECK(sList.back().m_Data, 1);
+        CHECK(&sList.back() == &sStaleCopy);
+        sStaleCopy = std::move(*sObjects[3]);
+        CHECK(sStaleCopy.m_Link.isAlone());
+        CHECK(&sList.back() == &sMoved);
+    }
+    CHECK(sList, std::vector<int>());
+
+    for (int i = 1; i < 100; i += 2)
+        delete sObjects[i];
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    lifetime();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <random>
+#include <vector>
+
+// Sets of heap allocated objects for perf tests that must not fit in caches.
+// Every heap constructs aCount objects of type T and gives them out by index;
+// the heaps differ in how the objects are spread in memory.
+
+// Every object is allocated by its own new: neighbours by index are usually
+// neighbours in memory, but with allocator headers in between.
+template <class T>
+class MallocHeap
+{
+public:
+    explicit MallocHeap(size_t aCount) : m_Objects(aCount)
+    {
+        for (T*& sObject : m_Objects)
+            sObject = new T;
+    }
+    ~MallocHeap()
+    {
+        for (T* sObject : m_Objects)
+            delete sObject;
+    }
+    MallocHeap(const MallocHeap&) = delete;
+    MallocHeap& operator=(const MallocHeap&) = delete;
+
+    T& operator[](size_t aIndex) { return *m_Objects[aIndex]; }
+    size_t size() const { return m_Objects.size(); }
+
+private:
+    std::vector<T*> m_Objects;
+};
+
+// All objects are placed densely in one slab, as a pool allocator does.
+template <class T>
+class PoolHeap
+{
+public:
+    explicit PoolHeap(size_t aCount)
+        : m_Slab(static_cast<T*>(::operator new(aCount * sizeof(T)))), m_Count(aCount)
+    {
+        for (size_t i = 0; i < m_Count; i++)
+            new (m_Slab + i) T;
+    }
+    ~PoolHeap()
+    {
+        for (size_t i = 0; i < m_Count; i++)
+            m_Slab[i].~T();
+        ::operator delete(m_Slab);
+    }
+    PoolHeap(const PoolHeap&) = delete;
+    PoolHeap& operator=(const PoolHeap&) = delete;
+
+    T& operator[](size_t aIndex) { return m_Slab[aIndex]; }
+    size_t size() const { return m_Count; }
+
+private:
+    T* m_Slab;
+    size_t m_Count;
+};
+
+// Objects are allocated interleaved with garbage of random size that is freed
+// afterwards, and are given out in random order: a long running process heap.
+template <class T>
+class FragmentedHeap
+{
+public:
+    explicit FragmentedHeap(size_t aCount) : m_Objects(aCount)
+    {
+        std::mt19937 sRand(aCount);
+        std::vector<char*> sGarbage(aCount);
+        for (size_t i = 0; i < aCount; i++)
+        {
+            sGarbage[i] = new char[16 + sRand() % 112];
+            m_Objects[i] = new T;
+        }
+        for (char* sPtr : sGarbage)
+            delete[] sPtr;
+        std::shuffle(m_Objects.begin(), m_Objects.end(), sRand);
+    }
+    ~FragmentedHeap()
+    {
+        for (T* sObject : m_Objects)
+            delete sObject;
+    }
+    FragmentedHeap(const FragmentedHeap&) = delete;
+    FragmentedHeap& operator=(const FragmentedHeap&) = delete;
+
+    T& operator[](size_t aIndex) { return *m_Objects[aIndex]; }
+    size_t size() const { return m_Objects.size(); }
+
+private:
+    std::vector<T*> m_Objects;
+};
+
+// Random indexes [0, aRange) prepared in advance to keep RNG out of measurements.
+inline std::vector<size_t> randomIndexes(size_t aCount, size_t aRange)
+{
+    std::mt19937 sRand(aCount ^ aRange);
+    std::vector<size_t> sRes(aCount);
+    for (size_t& sIndex : sRes)
+        sIndex = sRand() % aRange;
+    return sRes;
+}
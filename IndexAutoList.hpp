@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <IndexRing.hpp>
+
+// Variant of AutoList (see AutoList.hpp) for items that live in one array:
+// links are pairs of indexes in that array, 2 * sizeof(Index) bytes
+// instead of two pointers. Index type may be chosen by IndexFor<Capacity>.
+//
+// Links can't unlink themselves as they don't know the array, so, like
+// SlightlyOrderedListLink, they are passive: items must be removed from
+// the list via the list, and copies of items are not in any list. The list
+// unlinks its items when destroyed (O(n)), otherwise they would keep
+// referring to HEAD, that is the head of any other list over the array.
+
+template <class Index>
+class IndexAutoListLink
+{
+public:
+    bool isAlone() const
+    {
+        return m_Ring.isAlone();
+    }
+
+    IndexRing<Index> m_Ring;
+};
+
+template <class Item, class Index, IndexAutoListLink<Index> Item::*LinkMember>
+class IndexAutoList
+{
+public:
+    static constexpr Index HEAD = IndexRing<Index>::HEAD;
+
+    // aBase is the array of items, it must have at most IndexRing<Index>::CAPACITY items.
+    explicit IndexAutoList(Item* aBase) : m_Base(aBase)
+    {
+        m_Head.initAlone(HEAD);
+    }
+    ~IndexAutoList()
+    {
+        clear();
+    }
+
+    IndexAutoList(const IndexAutoList& aList) : m_Base(aList.m_Base)
+    {
+        m_Head.initAlone(HEAD);
+    }
+    IndexAutoList& operator=(const IndexAutoList& aList)
+    {
+        clear();
+        m_Base = aList.m_Base;
+        return *this;
+    }
+
+    // Items refer to list head as HEAD, so the head is just copied.
+    IndexAutoList(IndexAutoList&& aList) noexcept : m_Base(aList.m_Base)
+    {
+        m_Head.m_Neigh[0] = aList.m_Head.m_Neigh[0];
+        m_Head.m_Neigh[1] = aList.m_Head.m_Neigh[1];
+        aList.m_Head.initAlone(HEAD);
+    }
+    IndexAutoList& operator=(IndexAutoList&& aList) noexcept
+    {
+        std::swap(m_Base, aList.m_Base);
+        std::swap(m_Head.m_Neigh[0], aList.m_Head.m_Neigh[0]);
+        std::swap(m_Head.m_Neigh[1], aList.m_Head.m_Neigh[1]);
+        return *this;
+    }
+
+    void insertFront(Item& aItem)
+    {
+        IndexRing<Index>::add(resolver(), HEAD, index(aItem), false);
+    }
+    void insertBack(Item& aItem)
+    {
+        IndexRing<Index>::add(resolver(), HEAD, index(aItem), true);
+    }
+    void insertAfter(Item& aExistingItem, Item& aNewItem)
+    {
+        IndexRing<Index>::add(resolver(), index(aExistingItem), index(aNewItem), false);
+    }
+    void removeItem(Item& aItem)
+    {
+        if (!(aItem.*LinkMember).isAlone())
+            IndexRing<Index>::remove(resolver(), index(aItem));
+    }
+    // Unlinks all items, O(n).
+    void clear()
+    {
+        while (!empty())
+            IndexRing<Index>::remove(resolver(), m_Head.m_Neigh[1]);
+    }
+    bool empty() const
+    {
+        return HEAD == m_Head.m_Neigh[0];
+    }
+    int selfCheck() const
+    {
+        Index sCur = HEAD;
+        for (size_t i = 0; i <= IndexRing<Index>::CAPACITY; i++)
+        {
+            Index sNext = ring(sCur).m_Neigh[1];
+            if (sNext != HEAD && sNext >= IndexRing<Index>::CAPACITY)
+                return 1;
+            if (ring(sNext).m_Neigh[0] != sCur)
+                return 1;
+            sCur = sNext;
+            if (sCur == HEAD)
+                return 0;
+        }
+        return 1;
+    }
+    Item& front()
+    {
+        return m_Base[m_Head.m_Neigh[1]];
+    }
+    const Item& front() const
+    {
+        return m_Base[m_Head.m_Neigh[1]];
+    }
+    Item& back()
+    {
+        return m_Base[m_Head.m_Neigh[0]];
+    }
+    const Item& back() const
+    {
+        return m_Base[m_Head.m_Neigh[0]];
+    }
+    Index index(const Item& aItem) const
+    {
+        return static_cast<Index>(&aItem - m_Base);
+    }
+
+    template <class TItem, class TList>
+    class iterator_common
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TList* aList, Index aIndex) : m_List(aList), m_Index(aIndex) {}
+        TItem& operator*() const { return m_List->m_Base[m_Index]; }
+        TItem* operator->() const { return &m_List->m_Base[m_Index]; }
+        bool operator==(const iterator_common& aItr) const { return m_Index == aItr.m_Index; }
+        bool operator!=(const iterator_common& aItr) const { return m_Index != aItr.m_Index; }
+        iterator_common& operator++() { m_Index = m_List->ring(m_Index).m_Neigh[1]; return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { m_Index = m_List->ring(m_Index).m_Neigh[0]; return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TList* m_List;
+        Index m_Index;
+    };
+    using iterator = iterator_common<Item, IndexAutoList>;
+    using const_iterator = iterator_common<const Item, const IndexAutoList>;
+
+    iterator begin() { return iterator(this, m_Head.m_Neigh[1]); }
+    iterator end() { return iterator(this, HEAD); }
+    const_iterator begin() const { return const_iterator(this, m_Head.m_Neigh[1]); }
+    const_iterator end() const { return const_iterator(this, HEAD); }
+
+private:
+    Item* m_Base;
+    IndexRing<Index> m_Head;
+
+    IndexRing<Index>& ring(Index aIndex)
+    {
+        return HEAD == aIndex ? m_Head : (m_Base[aIndex].*LinkMember).m_Ring;
+    }
+    const IndexRing<Index>& ring(Index aIndex) const
+    {
+        return HEAD == aIndex ? m_Head : (m_Base[aIndex].*LinkMember).m_Ring;
+    }
+
+    struct Resolver
+    {
+        IndexAutoList* m_List;
+        IndexRing<Index>& operator()(Index aIndex) const { return m_List->ring(aIndex); }
+    };
+    Resolver resolver()
+    {
+        return Resolver{this};
+    }
+};
+
+template <class Item, class Index, IndexAutoListLink<Index> Item::*LinkMember>
+constexpr Index IndexAutoList<Item, Index, LinkMember>::HEAD;
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <IndexAutoList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct PtrObject
+    {
+        AutoListLink m_Link;
+        uint32_t m_Value;
+    };
+
+    template <class Index>
+    struct IndexObject
+    {
+        IndexAutoListLink<Index> m_Link;
+        uint32_t m_Value;
+    };
+
+    using PtrList = AutoList<PtrObject, &PtrObject::m_Link>;
+    template <class Index>
+    using IndexList = IndexAutoList<IndexObject<Index>, Index, &IndexObject<Index>::m_Link>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+// The same scenario for both kinds of lists: items are linked in random
+// order, so that traversal jumps over the array.
+template <class List, class Object, class MakeList>
+static void scenario(const char* aName, size_t aSize, MakeList aMakeList)
+{
+    std::vector<size_t> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sOrder[i] = i;
+    std::mt19937 sRand(aSize);
+    std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+    const size_t COUNT = 4 * 1024 * 1024;
+    std::vector<size_t> sRandom(COUNT);
+    for (size_t& sIndex : sRandom)
+        sIndex = sRand() % aSize;
+    const size_t TRAVERSE_COUNT = std::max<size_t>(1, 64 * 1024 * 1024 / aSize);
+
+    std::cout << aName << ", " << aSize << " items of " << sizeof(Object) << " bytes, "
+              << aSize * sizeof(Object) / 1024 << " KiB" << std::endl;
+    std::vector<Object> sObjects(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sObjects[i].m_Value = i;
+    List sList = aMakeList(sObjects.data());
+    checkpoint("", 0);
+
+    for (size_t i : sOrder)
+        sList.insertBack(sObjects[i]);
+    checkpoint("Addition", aSize);
+
+    for (size_t i = 0; i < TRAVERSE_COUNT; i++)
+        for (const Object& o : sList)
+            SideEffect += o.m_Value;
+    checkpoint("Traversal", aSize * TRAVERSE_COUNT);
+
+    for (size_t i : sRandom)
+    {
+        sList.removeItem(sObjects[i]);
+        sList.insertFront(sObjects[i]);
+    }
+    checkpoint("Random relink", COUNT);
+
+    for (size_t i : sOrder)
+        sList.removeItem(sObjects[i]);
+    checkpoint("Removing", aSize);
+}
+
+static PtrList makePtrList(PtrObject*)
+{
+    return PtrList();
+}
+
+template <class Index>
+static IndexList<Index> makeIndexList(IndexObject<Index>* aBase)
+{
+    return IndexList<Index>(aBase);
+}
+
+int main()
+{
+    const size_t SMALL = IndexRing<uint16_t>::CAPACITY;
+    scenario<PtrList, PtrObject>("AutoList", SMALL, makePtrList);
+    scenario<IndexList<uint16_t>, IndexObject<uint16_t>>("IndexAutoList<uint16_t>", SMALL, makeIndexList<uint16_t>);
+    scenario<IndexList<uint32_t>, IndexObject<uint32_t>>("IndexAutoList<uint32_t>", SMALL, makeIndexList<uint32_t>);
+
+    const size_t BIG = 4 * 1024 * 1024;
+    scenario<PtrList, PtrObject>("AutoList", BIG, makePtrList);
+    scenario<IndexList<uint32_t>, IndexObject<uint32_t>>("IndexAutoList<uint32_t>", BIG, makeIndexList<uint32_t>);
+
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
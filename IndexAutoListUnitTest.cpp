@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <IndexAutoList.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+template <class Index>
+struct Object
+{
+    int m_Data;
+    Object(int aId = 0) : m_Data(aId) {}
+    IndexAutoListLink<Index> m_Link;
+};
+
+template <class Index>
+using ObjectList = IndexAutoList<Object<Index>, Index, &Object<Index>::m_Link>;
+
+void index_types()
+{
+    ANNOUNCE();
+
+    static_assert(std::is_same<IndexFor<100>, uint16_t>::value, "Wrong index type");
+    static_assert(std::is_same<IndexFor<65534>, uint16_t>::value, "Wrong index type");
+    static_assert(std::is_same<IndexFor<65535>, uint32_t>::value, "Wrong index type");
+    static_assert(std::is_same<IndexFor<100000>, uint32_t>::value, "Wrong index type");
+    static_assert(sizeof(IndexAutoListLink<uint16_t>) == 4, "Link must be compact");
+    static_assert(sizeof(IndexAutoListLink<uint32_t>) == 8, "Link must be compact");
+    CHECK(IndexRing<uint16_t>::CAPACITY, size_t(65534));
+}
+
+template <class Index>
+void simple()
+{
+    ANNOUNCE();
+
+    Object<Index> sObjects[6] = {0, 1, 2, 3, 4, 5};
+    ObjectList<Index> sList(sObjects);
+    CHECK(sList, {});
+    CHECK(sObjects[0].m_Link.isAlone());
+
+    sList.insertFront(sObjects[1]);
+    sList.insertFront(sObjects[0]);
+    sList.insertBack(sObjects[3]);
+    CHECK(sList, {0, 1, 3});
+    CHECK(!sObjects[0].m_Link.isAlone());
+    sList.insertAfter(sObjects[1], sObjects[2]);
+    sList.insertAfter(sObjects[3], sObjects[5]);
+    CHECK(sList, {0, 1, 2, 3, 5});
+    CHECK(sList.index(sObjects[5]), Index(5));
+
+    sList.removeItem(sObjects[0]);
+    CHECK(sObjects[0].m_Link.isAlone());
+    CHECK(sList, {1, 2, 3, 5});
+    sList.removeItem(sObjects[5]);
+    CHECK(sList, {1, 2, 3});
+    sList.removeItem(sObjects[2]);
+    CHECK(sList, {1, 3});
+    sList.removeItem(sObjects[2]);
+    CHECK(sList, {1, 3});
+
+    Object<Index> sCopy(sObjects[1]);
+    CHECK(sCopy.m_Link.isAlone());
+    CHECK(sList, {1, 3});
+
+    ObjectList<Index> sList2(std::move(sList));
+    CHECK(sList, {});
+    CHECK(sList2, {1, 3});
+    sList2.insertBack(sObjects[4]);
+    CHECK(sList2, {1, 3, 4});
+
+    sList = std::move(sList2);
+    CHECK(sList, {1, 3, 4});
+    CHECK(sList2, {});
+
+    ObjectList<Index> sList3(sList);
+    CHECK(sList3, {});
+
+    sList.clear();
+    CHECK(sList, {});
+    for (const Object<Index>& sObj : sObjects)
+        CHECK(sObj.m_Link.isAlone());
+}
+
+template <class Index>
+void two_lists()
+{
+    ANNOUNCE();
+
+    std::vector<Object<Index>> sObjects(1000);
+    for (int i = 0; i < 1000; i++)
+        sObjects[i].m_Data = i;
+    ObjectList<Index> sEven(sObjects.data());
+    ObjectList<Index> sOdd(sObjects.data());
+    std::vector<int> sEvenRef;
+    std::vector<int> sOddRef;
+    for (int i = 0; i < 1000; i++)
+    {
+        if (i % 2 == 0)
+        {
+            sEven.insertBack(sObjects[i]);
+            sEvenRef.push_back(i);
+        }
+        else
+        {
+            sOdd.insertFront(sObjects[i]);
+            sOddRef.insert(sOddRef.begin(), i);
+        }
+    }
+    CHECK(sEven, sEvenRef);
+    CHECK(sOdd, sOddRef);
+
+    for (int i = 0; i < 1000; i += 4)
+    {
+        sEven.removeItem(sObjects[i]);
+        sOdd.insertBack(sObjects[i]);
+    }
+    sEvenRef.clear();
+    for (int i = 2; i < 1000; i += 4)
+        sEvenRef.push_back(i);
+    for (int i = 0; i < 1000; i += 4)
+        sOddRef.push_back(i);
+    CHECK(sEven, sEvenRef);
+    CHECK(sOdd, sOddRef);
+}
+
+template <class Index>
+void destroyed_list()
+{
+    ANNOUNCE();
+
+    // Items of a destroyed list must not refer to HEAD of another list.
+    Object<Index> sObjects[4] = {0, 1, 2, 3};
+    {
+        ObjectList<Index> sList(sObjects);
+        sList.insertBack(sObjects[0]);
+        sList.insertBack(sObjects[1]);
+        CHECK(sList, {0, 1});
+    }
+    for (const Object<Index>& sObj : sObjects)
+        CHECK(sObj.m_Link.isAlone());
+
+    ObjectList<Index> sList2(sObjects);
+    sList2.insertBack(sObjects[2]);
+    sList2.insertBack(sObjects[3]);
+    sList2.removeItem(sObjects[0]);
+    CHECK(sList2, {2, 3});
+    sList2.insertAfter(sObjects[2], sObjects[1]);
+    sList2.insertBack(sObjects[0]);
+    CHECK(sList2, {2, 1, 3, 0});
+}
+
+} // anonymous namespace
+
+int main()
+{
+    index_types();
+    simple<uint16_t>();
+    simple<uint32_t>();
+    two_lists<uint16_t>();
+    two_lists<uint32_t>();
+    destroyed_list<uint16_t>();
+    destroyed_list<uint32_t>();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
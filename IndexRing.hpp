@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Ring whose elements are referred by indexes in some array instead of
+// pointers. Index is an unsigned integer type; two greatest values of it
+// are reserved: NIL marks an element that is not in any ring, HEAD refers
+// to an element outside of the array (e.g. list head).
+//
+// Index rings can't resolve indexes themselves, so ring operations are
+// static and take a resolver: a callable that returns IndexRing& by index.
+template <class Index>
+struct IndexRing
+{
+    static_assert(std::is_unsigned<Index>::value, "Index must be unsigned");
+
+    static constexpr Index NIL = static_cast<Index>(~Index(0));
+    static constexpr Index HEAD = static_cast<Index>(NIL - 1);
+    // Max number of elements in the array.
+    static constexpr size_t CAPACITY = HEAD;
+
+    Index m_Neigh[2]; // generally {m_Prev, m_Next}
+
+    // Initializes element that is not in ring.
+    IndexRing() : m_Neigh{NIL, NIL} {}
+    // Copy ctor/assign do not copy links, index rings can't share elements.
+    IndexRing(const IndexRing&) : m_Neigh{NIL, NIL} {}
+    IndexRing& operator=(const IndexRing&) { return *this; }
+
+    void init()
+    {
+        m_Neigh[0] = m_Neigh[1] = NIL;
+    }
+    // Initializes ring that consists of aSelf only.
+    void initAlone(Index aSelf)
+    {
+        m_Neigh[0] = m_Neigh[1] = aSelf;
+    }
+    bool isAlone() const
+    {
+        return NIL == m_Neigh[0];
+    }
+
+    // Add new element a to the ring after element aPos (if not aInverted)
+    template <class Resolver>
+    static void add(const Resolver& aRing, Index aPos, Index a, bool aInvert = false)
+    {
+        link(aRing, a, aRing(aPos).m_Neigh[!aInvert], aInvert);
+        link(aRing, aPos, a, aInvert);
+    }
+
+    // Remove element a from its ring, it becomes not in ring.
+    template <class Resolver>
+    static void remove(const Resolver& aRing, Index a)
+    {
+        IndexRing& sRing = aRing(a);
+        link(aRing, sRing.m_Neigh[0], sRing.m_Neigh[1], false);
+        sRing.init();
+    }
+
+    template <class Resolver>
+    static void link(const Resolver& aRing, Index aPrev, Index aNext, bool aInvert)
+    {
+        aRing(aPrev).m_Neigh[!aInvert] = aNext;
+        aRing(aNext).m_Neigh[aInvert] = aPrev;
+    }
+};
+
+template <class Index>
+constexpr Index IndexRing<Index>::NIL;
+template <class Index>
+constexpr Index IndexRing<Index>::HEAD;
+template <class Index>
+constexpr size_t IndexRing<Index>::CAPACITY;
+
+// The smallest index type that can address Capacity elements.
+template <size_t Capacity>
+using IndexFor = typename std::conditional<Capacity <= IndexRing<uint16_t>::CAPACITY, uint16_t,
+                 typename std::conditional<Capacity <= IndexRing<uint32_t>::CAPACITY, uint32_t,
+                 uint64_t>::type>::type;
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Traversal of many independent lists with interleaving.
+// Walking one list is a chain of dependent loads, so at most one cache miss
+// is in flight. interleavedForEach keeps Width lists open at once and
+// advances them round-robin, prefetching the next node of every list, so up
+// to Width misses overlap. When a list ends its slot is refilled with the
+// next list of the range.
+
+namespace interleaved_details
+{
+    template <class T>
+    T& list(T& aList) { return aList; }
+    template <class T>
+    T& list(T* aList) { return *aList; }
+
+    inline void prefetch(const void* aAddr)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(aAddr);
+#else
+        (void)aAddr;
+#endif
+    }
+}
+
+// Calls aFn(Item&) for every item of every list in [aFirst, aLast). The range
+// may hold lists or pointers to lists. Items of one list are visited in
+// order, while the order among lists is unspecified. aFn may remove the item
+// it's called for, but must not modify the lists otherwise.
+template <size_t Width, class ListIterator, class Fn>
+void interleavedForEach(ListIterator aFirst, ListIterator aLast, Fn&& aFn)
+{
+    static_assert(Width > 0, "At least one list must be traversed at once");
+    using List = typename std::remove_reference<decltype(interleaved_details::list(*aFirst))>::type;
+    using Iterator = decltype(std::declval<List&>().begin());
+    struct Cursor
+    {
+        Iterator m_Cur;
+        Iterator m_End;
+    };
+    // Iterators are not always default constructible, keep them in raw storage.
+    typename std::aligned_storage<sizeof(Cursor), alignof(Cursor)>::type sStorage[Width];
+    Cursor* sCursors = reinterpret_cast<Cursor*>(sStorage);
+    size_t sActive = 0;
+
+    // Opens the next nonempty list into aCursor, false if there's no more.
+    auto sOpen = [&aFirst, aLast](Cursor* aCursor, bool aConstructed)
+    {
+        for (; aFirst != aLast; ++aFirst)
+        {
+            List& sList = interleaved_details::list(*aFirst);
+            if (sList.begin() == sList.end())
+                continue;
+            if (aConstructed)
+                aCursor->~Cursor();
+            new (aCursor) Cursor{sList.begin(), sList.end()};
+            interleaved_details::prefetch(&*aCursor->m_Cur);
+            ++aFirst;
+            return true;
+        }
+        return false;
+    };
+
+    while (sActive < Width && sOpen(sCursors + sActive, false))
+        ++sActive;
+
+    while (sActive > 0)
+    {
+        for (size_t i = 0; i < sActive; )
+        {
+            Cursor& sCursor = sCursors[i];
+            Iterator sItem = sCursor.m_Cur++;
+            if (sCursor.m_Cur != sCursor.m_End)
+                interleaved_details::prefetch(&*sCursor.m_Cur);
+            aFn(*sItem);
+            if (sCursor.m_Cur != sCursor.m_End || sOpen(&sCursor, true))
+            {
+                ++i;
+                continue;
+            }
+            // Nothing to refill with, close the slot moving the last in it.
+            --sActive;
+            if (i != sActive)
+                sCursor = std::move(sCursors[sActive]);
+            sCursors[sActive].~Cursor();
+        }
+    }
+}
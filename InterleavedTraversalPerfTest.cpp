@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <InterleavedTraversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Object
+    {
+        AutoListLink m_Link;
+        uint64_t m_Key;
+        char m_Cold[48];
+    };
+
+    using ObjectList = AutoList<Object, &Object::m_Link>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+template <size_t Width>
+static void interleaved(std::vector<ObjectList>& aLists, size_t aItems)
+{
+    checkpoint("", 0);
+    interleavedForEach<Width>(aLists.begin(), aLists.end(), [](Object& o) { SideEffect += o.m_Key; });
+    std::cout << "K = " << Width << ", ";
+    checkpoint("interleaved traversal", aItems);
+}
+
+// Lists of aLength items each, all items are scattered in memory randomly.
+static void test(size_t aListCount, size_t aLength)
+{
+    const size_t sItems = aListCount * aLength;
+    std::cout << aListCount << " lists of " << aLength << " items" << std::endl;
+    std::vector<Object> sObjects(sItems);
+    std::vector<size_t> sOrder(sItems);
+    for (size_t i = 0; i < sItems; i++)
+    {
+        sObjects[i].m_Key = i;
+        sOrder[i] = i;
+    }
+    std::mt19937 sRand(sItems);
+    std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+    std::vector<ObjectList> sLists(aListCount);
+    for (size_t i = 0; i < sItems; i++)
+        sLists[i % aListCount].insertBack(sObjects[sOrder[i]]);
+
+    checkpoint("", 0);
+    for (ObjectList& sList : sLists)
+        for (Object& o : sList)
+            SideEffect += o.m_Key;
+    checkpoint("Sequential traversal", sItems);
+
+    interleaved<1>(sLists, sItems);
+    interleaved<2>(sLists, sItems);
+    interleaved<3>(sLists, sItems);
+    interleaved<4>(sLists, sItems);
+    interleaved<6>(sLists, sItems);
+    interleaved<8>(sLists, sItems);
+    interleaved<12>(sLists, sItems);
+    interleaved<16>(sLists, sItems);
+    interleaved<24>(sLists, sItems);
+    interleaved<32>(sLists, sItems);
+}
+
+int main()
+{
+    test(256, 256);
+    test(1024, 4 * 1024);
+    test(100 * 1024, 32);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
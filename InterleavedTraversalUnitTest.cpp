@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <InterleavedTraversal.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_List;
+    int m_Data;
+    AutoListLink m_Link;
+};
+
+using ObjectList = AutoList<Object, &Object::m_Link>;
+
+// List i has i % 7 items (so some are empty), m_Data enumerates items in list.
+struct Lists
+{
+    std::vector<ObjectList> m_Lists;
+    std::vector<Object> m_Objects;
+
+    explicit Lists(int aCount) : m_Lists(aCount)
+    {
+        for (int i = 0; i < aCount; i++)
+            for (int j = 0; j < i % 7; j++)
+                m_Objects.push_back(Object{i, j, AutoListLink()});
+        for (Object& o : m_Objects)
+            m_Lists[o.m_List].insertBack(o);
+    }
+};
+
+template <size_t Width>
+void visit()
+{
+    ANNOUNCE();
+
+    for (int sCount : {0, 1, 3, 50})
+    {
+        Lists sLists(sCount);
+        std::vector<int> sNext(sCount, 0);
+        size_t sVisited = 0;
+        bool sOrdered = true;
+        interleavedForEach<Width>(sLists.m_Lists.begin(), sLists.m_Lists.end(),
+                                  [&](Object& o)
+                                  {
+                                      sOrdered = sOrdered && o.m_Data == sNext[o.m_List]++;
+                                      ++sVisited;
+                                  });
+        CHECK(sOrdered);
+        CHECK(sVisited, sLists.m_Objects.size());
+        for (int i = 0; i < sCount; i++)
+            CHECK(sNext[i], i % 7);
+    }
+}
+
+void pointers()
+{
+    ANNOUNCE();
+
+    Lists sLists(20);
+    std::vector<ObjectList*> sPointers;
+    for (ObjectList& sList : sLists.m_Lists)
+        sPointers.push_back(&sList);
+    size_t sVisited = 0;
+    interleavedForEach<4>(sPointers.begin(), sPointers.end(), [&sVisited](Object&) { ++sVisited; });
+    CHECK(sVisited, sLists.m_Objects.size());
+}
+
+void removal()
+{
+    ANNOUNCE();
+
+    Lists sLists(30);
+    interleavedForEach<5>(sLists.m_Lists.begin(), sLists.m_Lists.end(),
+                          [](Object& o) { if (o.m_Data % 2 == 0) o.m_Link.remove(); });
+    bool sSelfCheck = true;
+    bool sOdd = true;
+    size_t sLeft = 0;
+    for (ObjectList& sList : sLists.m_Lists)
+    {
+        sSelfCheck = sSelfCheck && 0 == sList.selfCheck();
+        for (Object& o : sList)
+        {
+            sOdd = sOdd && o.m_Data % 2 == 1;
+            ++sLeft;
+        }
+    }
+    CHECK(sSelfCheck);
+    CHECK(sOdd);
+    size_t sExpected = 0;
+    for (const Object& o : sLists.m_Objects)
+        sExpected += o.m_Data % 2;
+    CHECK(sLeft, sExpected);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    visit<1>();
+    visit<2>();
+    visit<8>();
+    visit<32>();
+    pointers();
+    removal();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
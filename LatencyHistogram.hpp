@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Timestamp counter reading for measuring single operations.
+// tscStart() must be taken before the measured code and tscStop() after it,
+// the fences keep the measured code from leaking out of the interval.
+// On platforms without TSC a steady clock (in nanoseconds) is used instead.
+inline uint64_t tscStart()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    return __rdtsc();
+#else
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline uint64_t tscStop()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int sAux;
+    uint64_t sRes = __rdtscp(&sAux);
+    _mm_lfence();
+    return sRes;
+#else
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Cost of an empty tscStart()/tscStop() interval, the minimum of several tries.
+inline uint64_t tscOverhead()
+{
+    uint64_t sRes = UINT64_MAX;
+    for (size_t i = 0; i < 1024; i++)
+    {
+        uint64_t sStart = tscStart();
+        uint64_t sStop = tscStop();
+        if (sStop - sStart < sRes)
+            sRes = sStop - sStart;
+    }
+    return sRes;
+}
+
+// Number of ticks in a nanosecond, measured against steady clock.
+inline double tscTicksPerNs()
+{
+    using namespace std::chrono;
+    steady_clock::time_point sWas = steady_clock::now();
+    uint64_t sStart = tscStart();
+    while (steady_clock::now() - sWas < milliseconds(20))
+        ;
+    uint64_t sStop = tscStop();
+    duration<double, std::nano> sSpan = steady_clock::now() - sWas;
+    return (sStop - sStart) / sSpan.count();
+}
+
+// HDR-style histogram of non-negative integer values (e.g. ticks).
+// Values below 2^SubBits are stored exactly, greater values are stored in
+// log-linear buckets with relative precision 2^(1-SubBits).
+// Recording is a couple of arithmetic instructions and one increment.
+template <unsigned SubBits = 6>
+class LatencyHistogram
+{
+public:
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        memset(m_Counts, 0, sizeof(m_Counts));
+        m_Count = 0;
+        m_Sum = 0;
+        m_Max = 0;
+    }
+
+    void record(uint64_t aValue)
+    {
+        ++m_Counts[index(aValue)];
+        ++m_Count;
+        m_Sum += aValue;
+        if (aValue > m_Max)
+            m_Max = aValue;
+    }
+
+    void merge(const LatencyHistogram& aOther)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+            m_Counts[i] += aOther.m_Counts[i];
+        m_Count += aOther.m_Count;
+        m_Sum += aOther.m_Sum;
+        if (aOther.m_Max > m_Max)
+            m_Max = aOther.m_Max;
+    }
+
+    size_t count() const
+    {
+        return m_Count;
+    }
+    uint64_t max() const
+    {
+        return m_Max;
+    }
+    double mean() const
+    {
+        return 0 == m_Count ? 0. : static_cast<double>(m_Sum) / m_Count;
+    }
+
+    // The value that aPercent percents of recorded values are less or equal to.
+    // The result is the highest value of the found bucket, but never above max.
+    uint64_t percentile(double aPercent) const
+    {
+        if (0 == m_Count)
+            return 0;
+        size_t sRank = static_cast<size_t>(aPercent / 100. * m_Count + 0.5);
+        if (sRank == 0)
+            sRank = 1;
+        size_t sSeen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            sSeen += m_Counts[i];
+            if (sSeen >= sRank)
+            {
+                uint64_t sRes = highest(i);
+                return sRes < m_Max ? sRes : m_Max;
+            }
+        }
+        return m_Max;
+    }
+
+private:
+    static constexpr uint64_t SUB_COUNT = uint64_t(1) << SubBits;
+    static constexpr uint64_t HALF_COUNT = SUB_COUNT / 2;
+    static constexpr size_t BUCKET_COUNT = (64 - SubBits) * HALF_COUNT + SUB_COUNT;
+
+    size_t m_Counts[BUCKET_COUNT];
+    size_t m_Count;
+    uint64_t m_Sum;
+    uint64_t m_Max;
+
+    // Values [0, SUB_COUNT) are mapped to themselves, every next power of two
+    // [2^k, 2^(k+1)) is split into HALF_COUNT buckets of width 2^(k+1-SubBits).
+    static size_t index(uint64_t aValue)
+    {
+        if (aValue < SUB_COUNT)
+            return aValue;
+        unsigned sShift = 64 - SubBits - __builtin_clzll(aValue);
+        return sShift * HALF_COUNT + (aValue >> sShift);
+    }
+    static uint64_t highest(size_t aIndex)
+    {
+        if (aIndex < SUB_COUNT)
+            return aIndex;
+        unsigned sShift = aIndex / HALF_COUNT - 1;
+        uint64_t sSub = aIndex - sShift * HALF_COUNT;
+        return ((sSub + 1) << sShift) - 1;
+    }
+};
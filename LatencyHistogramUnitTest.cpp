@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <LatencyHistogram.hpp>
+
+#include <iostream>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+using Histogram = LatencyHistogram<>;
+
+void empty()
+{
+    ANNOUNCE();
+
+    Histogram sHist;
+    CHECK(sHist.count(), size_t(0));
+    CHECK(sHist.max(), uint64_t(0));
+    CHECK(sHist.percentile(50.), uint64_t(0));
+    CHECK(sHist.percentile(100.), uint64_t(0));
+}
+
+void exact_small()
+{
+    ANNOUNCE();
+
+    Histogram sHist;
+    for (uint64_t i = 1; i <= 10; i++)
+        sHist.record(i);
+    CHECK(sHist.count(), size_t(10));
+    CHECK(sHist.max(), uint64_t(10));
+    CHECK(sHist.mean() == 5.5);
+    CHECK(sHist.percentile(10.), uint64_t(1));
+    CHECK(sHist.percentile(50.), uint64_t(5));
+    CHECK(sHist.percentile(90.), uint64_t(9));
+    CHECK(sHist.percentile(100.), uint64_t(10));
+}
+
+void precision()
+{
+    ANNOUNCE();
+
+    // Every value is reported within relative precision of the histogram.
+    for (uint64_t sValue = 1; sValue < (uint64_t(1) << 40); sValue = sValue * 3 + 1)
+    {
+        Histogram sHist;
+        sHist.record(sValue);
+        sHist.record(UINT64_MAX / 2);
+        uint64_t sRes = sHist.percentile(50.);
+        CHECK(sRes >= sValue);
+        CHECK(sRes - sValue <= sValue / 32);
+    }
+
+    Histogram sHist;
+    for (uint64_t i = 1; i <= 100000; i++)
+        sHist.record(i);
+    CHECK(sHist.max(), uint64_t(100000));
+    uint64_t sP50 = sHist.percentile(50.);
+    uint64_t sP99 = sHist.percentile(99.);
+    uint64_t sP999 = sHist.percentile(99.9);
+    CHECK(sP50 >= 50000 && sP50 <= 50000 + 50000 / 32);
+    CHECK(sP99 >= 99000 && sP99 <= 99000 + 99000 / 32);
+    CHECK(sP999 >= 99900 && sP999 <= 100000);
+    CHECK(sHist.percentile(100.), uint64_t(100000));
+}
+
+void merge_reset()
+{
+    ANNOUNCE();
+
+    Histogram sHist1;
+    Histogram sHist2;
+    for (uint64_t i = 0; i < 99; i++)
+        sHist1.record(1);
+    sHist2.record(1000000);
+    sHist1.merge(sHist2);
+    CHECK(sHist1.count(), size_t(100));
+    CHECK(sHist1.max(), uint64_t(1000000));
+    CHECK(sHist1.percentile(99.), uint64_t(1));
+    CHECK(sHist1.percentile(99.9), uint64_t(1000000));
+
+    sHist1.reset();
+    CHECK(sHist1.count(), size_t(0));
+    CHECK(sHist1.max(), uint64_t(0));
+}
+
+void timer()
+{
+    ANNOUNCE();
+
+    uint64_t sStart = tscStart();
+    uint64_t sStop = tscStop();
+    CHECK(sStop >= sStart);
+    CHECK(tscTicksPerNs() > 0.);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    empty();
+    exact_small();
+    precision();
+    merge_reset();
+    timer();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <SlightlyOrderedList.hpp>
+#include <LatencyHistogram.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Object
+    {
+        AutoListLink m_Link;
+        SlightlyOrderedListLink m_OrderedLink;
+        char m_Payload[24];
+    };
+
+    using ObjectList = AutoList<Object, &Object::m_Link>;
+    using ObjectOrderedList = SlightlyOrderedList<Object, &Object::m_OrderedLink>;
+    using Histogram = LatencyHistogram<>;
+
+    uint64_t Overhead = 0;
+    double TicksPerNs = 1.;
+}
+
+#define MEASURE(aHist, ...)                         \
+    do {                                            \
+        uint64_t sStart = tscStart();               \
+        __VA_ARGS__;                                \
+        uint64_t sTicks = tscStop() - sStart;       \
+        aHist.record(sTicks > Overhead ? sTicks - Overhead : 0); \
+    } while (false)
+
+static void report(const char* aText, size_t aSize, const Histogram& aHist)
+{
+    std::cout << std::left << std::setw(24) << aText << std::right << std::setw(9) << aSize;
+    const double sPercents[] = {50., 99., 99.9};
+    for (double sPercent : sPercents)
+        std::cout << std::setw(10) << std::fixed << std::setprecision(1) << aHist.percentile(sPercent) / TicksPerNs;
+    std::cout << std::setw(12) << aHist.max() / TicksPerNs << std::endl;
+}
+
+static void header()
+{
+    std::cout << std::left << std::setw(24) << "Operation (ns)" << std::right << std::setw(9) << "Size"
+              << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(12) << "max" << std::endl;
+}
+
+static void auto_list(size_t aSize)
+{
+    std::vector<size_t> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sOrder[i] = i;
+    std::shuffle(sOrder.begin(), sOrder.end(), std::mt19937(aSize));
+
+    std::vector<Object> sObjects(aSize);
+    std::vector<Object> sCopies(aSize);
+    ObjectList sList;
+    Histogram sHist;
+
+    for (size_t i : sOrder)
+        MEASURE(sHist, sList.insertFront(sObjects[i]));
+    report("AutoList insertFront", aSize, sHist);
+
+    sHist.reset();
+    for (size_t i : sOrder)
+        MEASURE(sHist, sCopies[i] = sObjects[i]);
+    report("AutoList copy", aSize, sHist);
+
+    sHist.reset();
+    for (size_t i : sOrder)
+        MEASURE(sHist, sList.removeItem(sObjects[i]));
+    report("AutoList removeItem", aSize, sHist);
+
+    sHist.reset();
+    for (size_t i : sOrder)
+        MEASURE(sHist, sObjects[i] = std::move(sCopies[i]));
+    report("AutoList move", aSize, sHist);
+}
+
+static void slightly_ordered_list(size_t aSize)
+{
+    std::vector<size_t> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sOrder[i] = i;
+    std::shuffle(sOrder.begin(), sOrder.end(), std::mt19937(aSize));
+
+    std::vector<Object> sObjects(aSize);
+    ObjectOrderedList sList;
+    Histogram sHist;
+
+    for (size_t i : sOrder)
+        MEASURE(sHist, sList.insert(sObjects[i]));
+    report("SlightlyOrdered insert", aSize, sHist);
+
+    sHist.reset();
+    for (size_t i : sOrder)
+        MEASURE(sHist, sList.remove(sObjects[i]));
+    report("SlightlyOrdered remove", aSize, sHist);
+}
+
+int main()
+{
+    Overhead = tscOverhead();
+    TicksPerNs = tscTicksPerNs();
+    std::cout << "Timer overhead: " << Overhead << " ticks, " << TicksPerNs << " ticks/ns" << std::endl;
+
+    header();
+    const size_t SIZES[] = {1024, 64 * 1024, 4 * 1024 * 1024};
+    for (size_t sSize : SIZES)
+        auto_list(sSize);
+    for (size_t sSize : SIZES)
+        slightly_ordered_list(sSize);
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include <Ring.hpp>
+
+// AutoList (see AutoList.hpp) with deferred removal: removeItem only marks
+// the link as removed, so it writes to the item itself but not to its
+// neighbours. Marked items stay in the ring and are unlinked physically by
+// traversal of a non-const list as it passes them (the neighbours are in
+// cache at that moment anyway), or by purge() in one sweep. A run of
+// marked items is cut out with one write per side.
+//
+// A removed item may be inserted again (to any list) right away. Link
+// destructor always unlinks physically.
+
+class LazyAutoListLink
+{
+public:
+    LazyAutoListLink() : m_Ring(0), m_Removed(false) {}
+    LazyAutoListLink(const LazyAutoListLink& aLink) : m_Removed(false)
+    {
+        if (aLink.isAlone())
+            m_Ring.init();
+        else
+            aLink.m_Ring.add(&m_Ring);
+    }
+    LazyAutoListLink(LazyAutoListLink&& aLink) noexcept : m_Removed(aLink.m_Removed)
+    {
+        aLink.m_Ring.add(&m_Ring);
+        aLink.m_Ring.remove();
+        aLink.m_Ring.init();
+        aLink.m_Removed = false;
+    }
+    ~LazyAutoListLink()
+    {
+        m_Ring.remove();
+    }
+    LazyAutoListLink& operator=(const LazyAutoListLink& aLink)
+    {
+        m_Ring.remove();
+        m_Removed = false;
+        if (aLink.isAlone())
+            m_Ring.init();
+        else
+            aLink.m_Ring.add(&m_Ring, false);
+        return *this;
+    }
+    LazyAutoListLink& operator=(LazyAutoListLink&& aLink) noexcept
+    {
+        m_Ring.swap(&aLink.m_Ring);
+        bool sRemoved = m_Removed;
+        m_Removed = aLink.m_Removed;
+        aLink.m_Removed = sRemoved;
+        return *this;
+    }
+    // Not in a list, a marked link is considered alone.
+    bool isAlone() const
+    {
+        return m_Removed || m_Ring.isAlone();
+    }
+    bool isRemoved() const
+    {
+        return m_Removed;
+    }
+    // Deferred removal.
+    void remove()
+    {
+        m_Removed = !m_Ring.isAlone();
+    }
+    // Immediate removal.
+    void unlink()
+    {
+        m_Ring.remove();
+        m_Ring.init();
+        m_Removed = false;
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+
+    // The ring must be the first member, see LazyAutoList::isRemoved.
+    mutable Ring m_Ring;
+    bool m_Removed;
+};
+
+template <class Item, LazyAutoListLink Item::*LinkMember>
+class LazyAutoList
+{
+public:
+    LazyAutoList() : m_Ring(0) {}
+    ~LazyAutoList()
+    {
+        m_Ring.remove();
+    }
+
+    LazyAutoList(const LazyAutoList&) : m_Ring(0) {}
+    LazyAutoList& operator=(const LazyAutoList&)
+    {
+        m_Ring.remove();
+        m_Ring.init();
+        return *this;
+    }
+
+    LazyAutoList(LazyAutoList&& aList) noexcept
+    {
+        aList.m_Ring.add(&m_Ring);
+        aList.m_Ring.remove();
+        aList.m_Ring.init();
+    }
+    LazyAutoList& operator=(LazyAutoList&& aList) noexcept
+    {
+        m_Ring.swap(&aList.m_Ring);
+        return *this;
+    }
+
+    void insertFront(Item& aItem)
+    {
+        m_Ring.add(&prepare(aItem), false);
+    }
+    void insertBack(Item& aItem)
+    {
+        m_Ring.add(&prepare(aItem), true);
+    }
+    void insertAfter(Item& aExistingItem, Item& aNewItem)
+    {
+        (aExistingItem.*LinkMember).m_Ring.add(&prepare(aNewItem), false);
+    }
+    void removeItem(Item& aItem)
+    {
+        (aItem.*LinkMember).remove();
+    }
+    // Unlinks all removed items, returns their count. Invalidates iterators
+    // that point to removed items (they are alone after it, and ++ would
+    // never leave them), iterators to other items stay valid.
+    size_t purge()
+    {
+        size_t sCount = 0;
+        for (Ring* sRing = &m_Ring; (sRing = skip(sRing, 1, &sCount)) != &m_Ring; )
+            ;
+        return sCount;
+    }
+    bool empty() const
+    {
+        return &m_Ring == skip(&m_Ring, 1);
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+    Item& front()
+    {
+        return *item(skip(&m_Ring, 1));
+    }
+    const Item& front() const
+    {
+        return *item(skip(&m_Ring, 1));
+    }
+    Item& back()
+    {
+        return *item(skip(&m_Ring, 0));
+    }
+    const Item& back() const
+    {
+        return *item(skip(&m_Ring, 0));
+    }
+
+    // Iterator of a non-const list unlinks removed items it steps over.
+    // Removal (deferred) of the item an iterator points to is allowed, but
+    // such an iterator must be moved off it before purge() or a traversal
+    // by another iterator passes the item.
+    template <class TItem, class TRing>
+    class iterator_common
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, TRing* aHead) : m_Ring(aRing), m_Head(aHead) {}
+        TItem& operator*() const { return *item(m_Ring); }
+        TItem* operator->() const { return item(m_Ring); }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
+        bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
+        iterator_common& operator++() { m_Ring = skip(m_Ring, 1, m_Head); return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { m_Ring = skip(m_Ring, 0, m_Head); return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TRing* m_Ring;
+        TRing* m_Head;
+    };
+    using iterator = iterator_common<Item, Ring>;
+    using const_iterator = iterator_common<const Item, const Ring>;
+
+    iterator begin() { return iterator(skip(&m_Ring, 1), &m_Ring); }
+    iterator end() { return iterator(&m_Ring, &m_Ring); }
+    const_iterator begin() const { return const_iterator(skip(&m_Ring, 1), &m_Ring); }
+    const_iterator end() const { return const_iterator(&m_Ring, &m_Ring); }
+
+private:
+    Ring m_Ring;
+
+    static Ring& prepare(Item& aItem)
+    {
+        LazyAutoListLink& sLink = aItem.*LinkMember;
+        if (sLink.m_Removed)
+        {
+            sLink.m_Ring.remove();
+            sLink.m_Removed = false;
+        }
+        return sLink.m_Ring;
+    }
+    static bool isRemoved(const Ring* aRing)
+    {
+        return reinterpret_cast<const LazyAutoListLink*>(aRing)->m_Removed;
+    }
+
+    // Returns the nearest not removed neighbour (or head) of aFrom in
+    // aNext direction, unlinking all removed items in between.
+    static Ring* skip(Ring* aFrom, bool aNext, const Ring* aHead, size_t* aCount = nullptr)
+    {
+        Ring* sRing = aFrom->m_Neigh[aNext];
+        if (sRing == aHead || !isRemoved(sRing))
+            return sRing;
+        do
+        {
+            Ring* sRemoved = sRing;
+            sRing = sRing->m_Neigh[aNext];
+            sRemoved->init();
+            reinterpret_cast<LazyAutoListLink*>(sRemoved)->m_Removed = false;
+            if (nullptr != aCount)
+                ++*aCount;
+        } while (sRing != aHead && isRemoved(sRing));
+        aFrom->m_Neigh[aNext] = sRing;
+        sRing->m_Neigh[!aNext] = aFrom;
+        return sRing;
+    }
+    static const Ring* skip(const Ring* aFrom, bool aNext, const Ring* aHead)
+    {
+        const Ring* sRing = aFrom->m_Neigh[aNext];
+        while (sRing != aHead && isRemoved(sRing))
+            sRing = sRing->m_Neigh[aNext];
+        return sRing;
+    }
+    Ring* skip(Ring* aFrom, bool aNext, size_t* aCount = nullptr)
+    {
+        return skip(aFrom, aNext, &m_Ring, aCount);
+    }
+    const Ring* skip(const Ring* aFrom, bool aNext) const
+    {
+        return skip(aFrom, aNext, &m_Ring);
+    }
+
+    static Item* item(Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+    static const Item* item(const Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
+    }
+};
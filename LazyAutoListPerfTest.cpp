@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <LazyAutoList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t ITEM_SIZE = 64;
+
+    struct EagerObject
+    {
+        AutoListLink m_Link;
+        uint64_t m_Key;
+        char m_Cold[ITEM_SIZE - sizeof(AutoListLink) - sizeof(uint64_t)];
+    };
+
+    struct LazyObject
+    {
+        LazyAutoListLink m_Link;
+        uint64_t m_Key;
+        char m_Cold[ITEM_SIZE - sizeof(LazyAutoListLink) - sizeof(uint64_t)];
+    };
+
+    using EagerList = AutoList<EagerObject, &EagerObject::m_Link>;
+    using LazyList = LazyAutoList<LazyObject, &LazyObject::m_Link>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+struct Scenario
+{
+    size_t m_Size;
+    std::vector<size_t> m_Order;
+    std::vector<size_t> m_Victims;
+
+    // Items are linked in random order, aShare of them is removed in a burst.
+    Scenario(size_t aSize, double aShare) : m_Size(aSize), m_Order(aSize)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_Order[i] = i;
+        std::mt19937 sRand(aSize);
+        std::shuffle(m_Order.begin(), m_Order.end(), sRand);
+        m_Victims.assign(m_Order.begin(), m_Order.begin() + size_t(aSize * aShare));
+        std::shuffle(m_Order.begin(), m_Order.end(), sRand);
+    }
+};
+
+static void purge(EagerList&)
+{
+}
+
+static void purge(LazyList& aList)
+{
+    SideEffect += aList.purge();
+}
+
+template <class Object, class List>
+static void run(const char* aName, const Scenario& aScenario, bool aPurge)
+{
+    std::vector<Object> sObjects(aScenario.m_Size);
+    for (size_t i = 0; i < aScenario.m_Size; i++)
+        sObjects[i].m_Key = i;
+    List sList;
+    for (size_t i : aScenario.m_Order)
+        sList.insertBack(sObjects[i]);
+    checkpoint("", 0);
+
+    for (size_t i : aScenario.m_Victims)
+        sList.removeItem(sObjects[i]);
+    std::cout << aName << ", ";
+    checkpoint("removal burst", aScenario.m_Victims.size());
+
+    if (aPurge)
+    {
+        purge(sList);
+        std::cout << aName << ", ";
+        checkpoint("purge", aScenario.m_Size);
+    }
+
+    for (Object& o : sList)
+        SideEffect += o.m_Key;
+    std::cout << aName << ", ";
+    checkpoint("first traversal", aScenario.m_Size);
+
+    for (Object& o : sList)
+        SideEffect += o.m_Key;
+    std::cout << aName << ", ";
+    checkpoint("next traversal", aScenario.m_Size - aScenario.m_Victims.size());
+}
+
+int main()
+{
+    const size_t SIZE = 1024 * 1024;
+    const double SHARES[] = {0.01, 0.1, 0.5};
+    for (double sShare : SHARES)
+    {
+        Scenario sScenario(SIZE, sShare);
+        std::cout << "Removing " << sScenario.m_Victims.size() << " of " << SIZE << " items" << std::endl;
+        run<EagerObject, EagerList>("AutoList", sScenario, false);
+        run<LazyObject, LazyList>("LazyAutoList", sScenario, false);
+        run<LazyObject, LazyList>("LazyAutoList with purge", sScenario, true);
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <LazyAutoList.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    LazyAutoListLink m_Link;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+using ObjectList = LazyAutoList<Object, &Object::m_Link>;
+
+void simple()
+{
+    ANNOUNCE();
+
+    Object sObjects[6] = {0, 1, 2, 3, 4, 5};
+    ObjectList sList;
+    CHECK(sList, std::vector<int>());
+    for (Object& o : sObjects)
+        sList.insertBack(o);
+    CHECK(sList, {0, 1, 2, 3, 4, 5});
+
+    sList.removeItem(sObjects[0]);
+    sList.removeItem(sObjects[2]);
+    sList.removeItem(sObjects[3]);
+    sObjects[5].m_Link.remove();
+    CHECK(sObjects[2].m_Link.isRemoved());
+    CHECK(sObjects[2].m_Link.isAlone());
+    CHECK(!sObjects[1].m_Link.isAlone());
+    // Const traversal only skips.
+    CHECK(sList, {1, 4});
+    CHECK(!sObjects[2].m_Link.m_Ring.isAlone());
+
+    // Non-const traversal unlinks.
+    std::vector<int> sVisited;
+    for (Object& o : sList)
+        sVisited.push_back(o.m_Data);
+    CHECK(sVisited == std::vector<int>({1, 4}));
+    CHECK(sObjects[2].m_Link.m_Ring.isAlone());
+    CHECK(!sObjects[2].m_Link.isRemoved());
+    CHECK(sObjects[3].m_Link.m_Ring.isAlone());
+    CHECK(sObjects[5].m_Link.m_Ring.isAlone());
+    // The first removed one is unlinked by begin().
+    CHECK(sObjects[0].m_Link.m_Ring.isAlone());
+    CHECK(sList, {1, 4});
+
+    // Removed item is not linked by removal of an alone item.
+    sList.removeItem(sObjects[2]);
+    CHECK(!sObjects[2].m_Link.isRemoved());
+
+    sList.removeItem(sObjects[1]);
+    sList.removeItem(sObjects[4]);
+    CHECK(sList, std::vector<int>());
+    CHECK(sList.purge(), size_t(2));
+    CHECK(sList.purge(), size_t(0));
+    CHECK(sList, std::vector<int>());
+    for (const Object& o : sObjects)
+        CHECK(o.m_Link.m_Ring.isAlone() && !o.m_Link.isRemoved());
+}
+
+void reinsert()
+{
+    ANNOUNCE();
+
+    Object sObjects[4] = {0, 1, 2, 3};
+    ObjectList sList1, sList2;
+    for (Object& o : sObjects)
+        sList1.insertBack(o);
+
+    // Removed items may be inserted again right away, to any list.
+    sList1.removeItem(sObjects[1]);
+    sList1.removeItem(sObjects[2]);
+    sList1.insertFront(sObjects[1]);
+    sList2.insertBack(sObjects[2]);
+    CHECK(sList1, {1, 0, 3});
+    CHECK(sList2, {2});
+    sList1.removeItem(sObjects[3]);
+    sList1.insertAfter(sObjects[1], sObjects[3]);
+    CHECK(sList1, {1, 3, 0});
+    CHECK(sList1.purge(), size_t(0));
+
+    // Destruction and immediate removal of removed item.
+    {
+        Object sTmp(7);
+        sList2.insertFront(sTmp);
+        sList2.removeItem(sTmp);
+        CHECK(sList2, {2});
+    }
+    CHECK(sList2, {2});
+    sList2.removeItem(sObjects[2]);
+    sObjects[2].m_Link.unlink();
+    CHECK(sList2, std::vector<int>());
+    CHECK(sList2.purge(), size_t(0));
+}
+
+void iteration()
+{
+    ANNOUNCE();
+
+    const int COUNT = 100;
+    std::vector<Object> sObjects(COUNT);
+    ObjectList sList;
+    for (int i = 0; i < COUNT; i++)
+    {
+        sObjects[i].m_Data = i;
+        sList.insertBack(sObjects[i]);
+    }
+
+    // Removal of current item while iterating.
+    for (Object& o : sList)
+        if (o.m_Data % 3 != 0)
+            sList.removeItem(o);
+    std::vector<int> sRef;
+    for (int i = 0; i < COUNT; i += 3)
+        sRef.push_back(i);
+    CHECK(sList, sRef);
+
+    // Backward traversal unlinks too.
+    for (int i = 0; i < COUNT; i += 6)
+        sList.removeItem(sObjects[i]);
+    size_t sLeft = 0;
+    for (auto sItr = sList.end(); sItr != sList.begin(); --sItr)
+        ++sLeft;
+    CHECK(sLeft, size_t(17));
+    CHECK(sList.purge(), size_t(0));
+    CHECK(sList.front().m_Data, 3);
+    CHECK(sList.back().m_Data, 99);
+
+    // Moves of removed links.
+    sList.removeItem(sObjects[99]);
+    ObjectList sMoved(std::move(sList));
+    CHECK(sList, std::vector<int>());
+    Object sCopy(sObjects[99]);
+    CHECK(sCopy.m_Link.m_Ring.isAlone());
+    Object sMovedItem(std::move(sObjects[99]));
+    CHECK(sMovedItem.m_Link.isRemoved());
+    CHECK(!sObjects[99].m_Link.isRemoved());
+    CHECK(sMoved.purge(), size_t(1));
+    CHECK(sMoved.back().m_Data, 93);
+
+    // An iterator on a removed item is moved off it before purge(), an
+    // iterator on a live item survives purge().
+    auto sLive = sMoved.begin();
+    auto sDead = sLive;
+    ++sDead;
+    sMoved.removeItem(*sDead);
+    ++sDead;
+    sMoved.removeItem(sObjects[27]);
+    CHECK(sMoved.purge(), size_t(2));
+    CHECK(sLive->m_Data, 3);
+    CHECK(sDead->m_Data, 15);
+    ++sLive;
+    CHECK(sLive->m_Data, 15);
+    ++sDead;
+    CHECK(sDead->m_Data, 21);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    reinsert();
+    iteration();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Statistics policies of Ring based containers.
+//
+// A container calls onInsert/onRemove on every insertion and removal,
+// onStep on every iterator increment/decrement and onFront/onBack when it
+// decides where to put a new item. A link calls static onCopyJoin when a
+// copy of a linked item joins its list and static onRelink when a moved
+// item takes the place of another one.
+//
+// Per container counters are stored in the container itself (the policy
+// is its base class, so an empty policy costs nothing); per link counters
+// have no container to live in and are static.
+
+// Default policy: counts nothing and compiles to nothing.
+struct NoListStats
+{
+    void onInsert() const {}
+    void onRemove() const {}
+    void onStep() const {}
+    void onFront() const {}
+    void onBack() const {}
+    static void onCopyJoin() {}
+    static void onRelink() {}
+};
+
+// Counting policy. Per container counters are plain (a container is not
+// thread safe anyway), static counters are shared by all containers with
+// the same Tag and are relaxed atomics.
+template <class Tag = void>
+class ListStats
+{
+public:
+    void onInsert() const { ++m_Inserts; }
+    void onRemove() const { ++m_Removes; }
+    void onStep() const { ++m_Steps; }
+    void onFront() const { ++m_Fronts; }
+    void onBack() const { ++m_Backs; }
+    static void onCopyJoin() { s_CopyJoins.fetch_add(1, std::memory_order_relaxed); }
+    static void onRelink() { s_Relinks.fetch_add(1, std::memory_order_relaxed); }
+
+    size_t inserts() const { return m_Inserts; }
+    size_t removes() const { return m_Removes; }
+    size_t steps() const { return m_Steps; }
+    size_t fronts() const { return m_Fronts; }
+    size_t backs() const { return m_Backs; }
+    static size_t copyJoins() { return s_CopyJoins.load(std::memory_order_relaxed); }
+    static size_t relinks() { return s_Relinks.load(std::memory_order_relaxed); }
+
+    void reset() const
+    {
+        m_Inserts = m_Removes = m_Steps = m_Fronts = m_Backs = 0;
+    }
+    static void resetStatic()
+    {
+        s_CopyJoins.store(0, std::memory_order_relaxed);
+        s_Relinks.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    mutable size_t m_Inserts = 0;
+    mutable size_t m_Removes = 0;
+    mutable size_t m_Steps = 0;
+    mutable size_t m_Fronts = 0;
+    mutable size_t m_Backs = 0;
+    static std::atomic<size_t> s_CopyJoins;
+    static std::atomic<size_t> s_Relinks;
+};
+
+template <class Tag>
+std::atomic<size_t> ListStats<Tag>::s_CopyJoins{0};
+template <class Tag>
+std::atomic<size_t> ListStats<Tag>::s_Relinks{0};
+
+// What an iterator keeps to report its steps: a pointer to container's
+// stats, or nothing if the policy has no state.
+template <class Stats, bool Empty = std::is_empty<Stats>::value>
+class ListStatsRef
+{
+public:
+    explicit ListStatsRef(const Stats* aStats) : m_Stats(aStats) {}
+    void onStep() const { m_Stats->onStep(); }
+private:
+    const Stats* m_Stats;
+};
+
+template <class Stats>
+class ListStatsRef<Stats, true>
+{
+public:
+    explicit ListStatsRef(const Stats*) {}
+    void onStep() const { Stats().onStep(); }
+};
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include <ListStats.hpp>
+#include <OffsetRing.hpp>
+#include <RingBatch.hpp>
+
+// Position independent variant of AutoList (see AutoList.hpp): links and
+// list heads are based on OffsetRing, so a memory region that contains a
+// list head and all its items may be mapped at any address. Zero filled
+// memory is a valid set of alone links and empty lists.
+// The code mirrors AutoList.hpp member by member on purpose: a common link
+// policy would hide Ring::m_Neigh behind an accessor in every list of the
+// library. Keep the API of both files in sync.
+
+// Stats is a statistics policy (see ListStats.hpp), only its static
+// onCopyJoin and onRelink are used by the link.
+template <class Stats>
+class BasicOffsetAutoListLink
+{
+public:
+    BasicOffsetAutoListLink() : m_Ring(0) {}
+    BasicOffsetAutoListLink(const BasicOffsetAutoListLink& aLink)
+    {
+        if (aLink.isAlone())
+        {
+            m_Ring.init();
+        }
+        else
+        {
+            aLink.m_Ring.add(&m_Ring);
+            Stats::onCopyJoin();
+        }
+    }
+    BasicOffsetAutoListLink(BasicOffsetAutoListLink&& aLink) noexcept
+    {
+        aLink.m_Ring.add(&m_Ring);
+        aLink.m_Ring.remove();
+        aLink.m_Ring.init();
+        Stats::onRelink();
+    }
+    ~BasicOffsetAutoListLink()
+    {
+        m_Ring.remove();
+    }
+    BasicOffsetAutoListLink& operator=(const BasicOffsetAutoListLink& aLink)
+    {
+        m_Ring.remove();
+        if (aLink.isAlone())
+        {
+            m_Ring.init();
+        }
+        else
+        {
+            aLink.m_Ring.add(&m_Ring, false);
+            Stats::onCopyJoin();
+        }
+        return *this;
+    }
+    BasicOffsetAutoListLink& operator=(BasicOffsetAutoListLink&& aLink) noexcept
+    {
+        m_Ring.swap(&aLink.m_Ring);
+        Stats::onRelink();
+        return *this;
+    }
+    bool isAlone() const
+    {
+        return m_Ring.isAlone();
+    }
+    void remove()
+    {
+        m_Ring.remove();
+        m_Ring.init();
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+
+    mutable OffsetRing m_Ring;
+};
+
+using OffsetAutoListLink = BasicOffsetAutoListLink<NoListStats>;
+
+// Stats is a statistics policy (see ListStats.hpp), stats are kept with
+// the list object and are not transferred by copy or move.
+template <class Stats, class Item, BasicOffsetAutoListLink<Stats> Item::*LinkMember>
+class BasicOffsetAutoList : private Stats
+{
+public:
+    BasicOffsetAutoList() : m_Ring(0) {}
+    ~BasicOffsetAutoList()
+    {
+        m_Ring.remove();
+    }
+
+    BasicOffsetAutoList(const BasicOffsetAutoList&) : m_Ring(0) {}
+    BasicOffsetAutoList& operator=(const BasicOffsetAutoList&)
+    {
+        m_Ring.remove();
+        m_Ring.init();
+        return *this;
+    }
+
+    BasicOffsetAutoList(BasicOffsetAutoList&& aList) noexcept
+    {
+        aList.m_Ring.add(&m_Ring);
+        aList.m_Ring.remove();
+        aList.m_Ring.init();
+    }
+    BasicOffsetAutoList& operator=(BasicOffsetAutoList&& aList) noexcept
+    {
+        m_Ring.swap(&aList.m_Ring);
+        return *this;
+    }
+
+    void insertFront(Item& aItem)
+    {
+        Stats::onInsert();
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), false);
+    }
+    void insertBack(Item& aItem)
+    {
+        Stats::onInsert();
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), true);
+    }
+    void insertAfter(Item& aExistingItem, Item& aNewItem)
+    {
+        Stats::onInsert();
+        (aExistingItem.*LinkMember).m_Ring.add(&((aNewItem.*LinkMember).m_Ring), false);
+    }
+    void removeItem(Item& aItem)
+    {
+        Stats::onRemove();
+        (aItem.*LinkMember).remove();
+    }
+    // Removes aCount items at once, faster than one by one if the items are
+    // given in list order (see removeRingBatch).
+    void removeBatch(Item* const* aItems, size_t aCount)
+    {
+        for (size_t i = 0; i < aCount; i++)
+            Stats::onRemove();
+        removeRingBatch(aItems, aCount, [](Item* aItem) { return &(aItem->*LinkMember).m_Ring; });
+    }
+    // The same as removeBatch, but first sorts aItems by address (see
+    // sortRingBatch), for batches that are collected in random order.
+    void removeBatchSorted(Item** aItems, size_t aCount)
+    {
+        sortRingBatch(aItems, aCount);
+        removeBatch(aItems, aCount);
+    }
+    const Stats& stats() const
+    {
+        return *this;
+    }
+    bool empty() const
+    {
+        return m_Ring.isAlone();
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+    Item& front()
+    {
+        return *item(m_Ring.neigh(1));
+    }
+    const Item& front() const
+    {
+        return *item(m_Ring.neigh(1));
+    }
+    Item& back()
+    {
+        return *item(m_Ring.neigh(0));
+    }
+    const Item& back() const
+    {
+        return *item(m_Ring.neigh(0));
+    }
+
+    template <class TItem, class TRing>
+    class iterator_common : ListStatsRef<Stats>
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, const Stats* aStats) : ListStatsRef<Stats>(aStats), m_Ring(aRing) {}
+        TItem& operator*() const { return *item(m_Ring); }
+        TItem* operator->() const { return item(m_Ring); }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
+        bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
+        iterator_common& operator++() { this->onStep(); m_Ring = m_Ring->neigh(1); return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { this->onStep(); m_Ring = m_Ring->neigh(0); return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        friend class BasicOffsetAutoList;
+        TRing* m_Ring;
+    };
+    using iterator = iterator_common<Item, OffsetRing>;
+    using const_iterator = iterator_common<const Item, const OffsetRing>;
+
+    iterator begin() { return iterator(m_Ring.neigh(1), this); }
+    iterator end() { return iterator(&m_Ring, this); }
+    const_iterator begin() const { return const_iterator(m_Ring.neigh(1), this); }
+    const_iterator end() const { return const_iterator(&m_Ring, this); }
+
+    // Operations below relink whole ranges at once, O(1) regardless of the
+    // range size, stats do not count the items they move.
+
+    // Moves all items of aList before aPos.
+    void splice(iterator aPos, BasicOffsetAutoList& aList)
+    {
+        if (aList.empty())
+            return;
+        OffsetRing* sFirst = aList.m_Ring.neigh(1);
+        aList.m_Ring.remove();
+        aList.m_Ring.init();
+        aPos.m_Ring->join(sFirst);
+    }
+    // Moves items [aFirst, aLast) of aList before aPos, aPos must not be
+    // in the range.
+    void splice(iterator aPos, BasicOffsetAutoList&, iterator aFirst, iterator aLast)
+    {
+        OffsetRing* sFirst = cut(aFirst.m_Ring, aLast.m_Ring);
+        if (nullptr != sFirst)
+            aPos.m_Ring->join(sFirst);
+    }
+    // Moves items after aItem to a new list.
+    BasicOffsetAutoList splitAfter(Item& aItem)
+    {
+        BasicOffsetAutoList sList;
+        OffsetRing* sFirst = cut((aItem.*LinkMember).m_Ring.neigh(1), &m_Ring);
+        if (nullptr != sFirst)
+            sFirst->join(&sList.m_Ring);
+        return sList;
+    }
+    // Moves items [aFirst, aLast) to a new list.
+    BasicOffsetAutoList extract(iterator aFirst, iterator aLast)
+    {
+        BasicOffsetAutoList sList;
+        OffsetRing* sFirst = cut(aFirst.m_Ring, aLast.m_Ring);
+        if (nullptr != sFirst)
+            sFirst->join(&sList.m_Ring);
+        return sList;
+    }
+
+private:
+    OffsetRing m_Ring;
+
+    // Cuts [aFirst, aLast) out to a separate ring, returns its first element
+    // or nullptr if the range is empty.
+    static OffsetRing* cut(OffsetRing* aFirst, OffsetRing* aLast)
+    {
+        if (aFirst == aLast)
+            return nullptr;
+        aFirst->split(aLast);
+        return aFirst;
+    }
+
+    static Item* item(OffsetRing* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+    static const Item* item(const OffsetRing* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
+    }
+};
+
+template <class Item, OffsetAutoListLink Item::*LinkMember>
+using OffsetAutoList = BasicOffsetAutoList<NoListStats, Item, LinkMember>;
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <OffsetAutoList.hpp>
+
+#include <cstring>
+#include <new>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+struct Object
+{
+    int m_Data;
+    Object(int aId = 0) : m_Data(aId) {}
+    OffsetAutoListLink m_Link;
+};
+
+using ObjectList = OffsetAutoList<Object, &Object::m_Link>;
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+void check(const ObjectList& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = false;
+    if (aList.empty() != (aArr.size() == 0))
+        sFailed = true;
+
+    int sFirst = 0 == aArr.size() ? 0 : *aArr.begin();
+    int sLast = 0;
+    auto sItr1 = aList.begin();
+    auto sItr2 = aArr.begin();
+    for (; sItr1 != aList.end() && sItr2 != aArr.end(); ++sItr1, ++sItr2)
+    {
+        if (sItr1->m_Data != *sItr2)
+            sFailed = true;
+        sLast = *sItr2;
+    }
+    if (sItr1 != aList.end() || sItr2 != aArr.end())
+        sFailed = true;
+    if (!aList.empty() && aList.front().m_Data != sFirst)
+        sFailed = true;
+    if (!aList.empty() && aList.back().m_Data != sLast)
+        sFailed = true;
+
+    if (aArr.begin() != aArr.end())
+    {
+        sItr1 = aList.end();
+        --sItr1;
+        sItr2 = aArr.end();
+        --sItr2;
+        for (; sItr1 != aList.begin() && sItr2 != aArr.begin(); --sItr1, --sItr2)
+        {
+            if (sItr1->m_Data != *sItr2)
+                sFailed = true;
+        }
+        if (sItr1 != aList.begin() || sItr2 != aArr.begin())
+            sFailed = true;
+    }
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        bool sFirst = true;
+        for (const Object& sObj : aList)
+        {
+            if (!sFirst)
+                std::cerr << ", " << sObj.m_Data;
+            else
+                std::cerr << sObj.m_Data;
+            sFirst = false;
+        }
+        std::cerr << "} expected to be {";
+        sFirst = true;
+        for (int sVal : aArr)
+        {
+            if (!sFirst)
+                std::cerr << ", " << sVal;
+            else
+                std::cerr << sVal;
+            sFirst = false;
+        }
+
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+
+void simple()
+{
+    ANNOUNCE();
+
+    ObjectList sList;
+    CHECK(sList.selfCheck(), 0);
+    CHECK(sList, {});
+
+    Object a(1);
+    Object b(2);
+    Object c(3);
+    sList.insertFront(b);
+    sList.insertBack(c);
+    sList.insertFront(a);
+    CHECK(sList.selfCheck(), 0);
+    CHECK(sList, {1, 2, 3});
+
+    Object d(4);
+    sList.insertAfter(b, d);
+    CHECK(sList, {1, 2, 4, 3});
+
+    sList.removeItem(b);
+    CHECK(b.m_Link.isAlone());
+    CHECK(sList, {1, 4, 3});
+
+    c.m_Link.remove();
+    CHECK(sList, {1, 4});
+
+    {
+        Object e(d);
+        CHECK(sList, {1, 4, 4});
+        Object f(std::move(a));
+        CHECK(a.m_Link.isAlone());
+        CHECK(sList, {1, 4, 4});
+        CHECK(sList.selfCheck(), 0);
+    }
+    CHECK(sList, {4});
+
+    ObjectList sList2(std::move(sList));
+    CHECK(sList, {});
+    CHECK(sList2, {4});
+    sList = std::move(sList2);
+    CHECK(sList, {4});
+    CHECK(sList2, {});
+}
+
+struct Segment
+{
+    ObjectList m_Lists[2];
+    Object m_Objects[16];
+};
+
+void relocation()
+{
+    ANNOUNCE();
+
+    // Zero filled memory is a segment of empty lists and alone objects.
+    alignas(Segment) char sZeroes[sizeof(Segment)];
+    memset(sZeroes, 0, sizeof(sZeroes));
+    Segment* sZero = reinterpret_cast<Segment*>(sZeroes);
+    CHECK(sZero->m_Lists[0], {});
+    CHECK(sZero->m_Lists[1], {});
+    CHECK(sZero->m_Objects[7].m_Link.isAlone());
+
+    alignas(Segment) char sFrom[sizeof(Segment)];
+    alignas(Segment) char sTo[sizeof(Segment)];
+    Segment* sSegment = new (sFrom) Segment;
+    for (int i = 0; i < 16; i++)
+    {
+        sSegment->m_Objects[i].m_Data = i;
+        if (i % 2 == 0)
+            sSegment->m_Lists[0].insertBack(sSegment->m_Objects[i]);
+        else
+            sSegment->m_Lists[1].insertFront(sSegment->m_Objects[i]);
+    }
+    CHECK(sSegment->m_Lists[0], {0, 2, 4, 6, 8, 10, 12, 14});
+    CHECK(sSegment->m_Lists[1], {15, 13, 11, 9, 7, 5, 3, 1});
+
+    // "Unmap" and "map back" at another address.
+    memcpy(sTo, sFrom, sizeof(Segment));
+    memset(sFrom, 0xff, sizeof(Segment));
+    Segment* sMapped = reinterpret_cast<Segment*>(sTo);
+    CHECK(sMapped->m_Lists[0].selfCheck(), 0);
+    CHECK(sMapped->m_Lists[1].selfCheck(), 0);
+    CHECK(sMapped->m_Lists[0], {0, 2, 4, 6, 8, 10, 12, 14});
+    CHECK(sMapped->m_Lists[1], {15, 13, 11, 9, 7, 5, 3, 1});
+
+    sMapped->m_Lists[0].removeItem(sMapped->m_Objects[4]);
+    sMapped->m_Lists[1].insertBack(sMapped->m_Objects[4]);
+    CHECK(sMapped->m_Lists[0], {0, 2, 6, 8, 10, 12, 14});
+    CHECK(sMapped->m_Lists[1], {15, 13, 11, 9, 7, 5, 3, 1, 4});
+    sMapped->~Segment();
+}
+
+void ranges()
+{
+    ANNOUNCE();
+
+    Object sObjects[8];
+    ObjectList sList1;
+    ObjectList sList2;
+    for (int i = 0; i < 8; i++)
+    {
+        sObjects[i].m_Data = i;
+        (i < 4 ? sList1 : sList2).insertBack(sObjects[i]);
+    }
+
+    sList1.splice(sList1.end(), sList2);
+    CHECK(sList1, {0, 1, 2, 3, 4, 5, 6, 7});
+    CHECK(sList2, {});
+
+    auto sFirst = sList1.begin();
+    ++sFirst;
+    auto sLast = sFirst;
+    ++++sLast;
+    ObjectList sExtracted = sList1.extract(sFirst, sLast);
+    CHECK(sExtracted, {1, 2});
+    CHECK(sList1, {0, 3, 4, 5, 6, 7});
+
+    sList1.splice(sList1.begin(), sExtracted, sExtracted.begin(), sExtracted.end());
+    CHECK(sList1, {1, 2, 0, 3, 4, 5, 6, 7});
+    CHECK(sExtracted, {});
+
+    ObjectList sTail = sList1.splitAfter(sObjects[3]);
+    CHECK(sList1, {1, 2, 0, 3});
+    CHECK(sTail, {4, 5, 6, 7});
+    CHECK(sTail.splitAfter(sObjects[7]), {});
+
+    Object* sBatch[] = {&sObjects[5], &sObjects[6], &sObjects[1]};
+    sTail.removeBatch(sBatch, 2);
+    CHECK(sTail, {4, 7});
+    sList1.removeBatchSorted(sBatch + 2, 1);
+    CHECK(sList1, {2, 0, 3});
+    CHECK(sList1.selfCheck(), 0);
+    CHECK(sTail.selfCheck(), 0);
+}
+
+struct CountedObject
+{
+    BasicOffsetAutoListLink<ListStats<>> m_Link;
+};
+
+void stats()
+{
+    ANNOUNCE();
+
+    using CountedList = BasicOffsetAutoList<ListStats<>, CountedObject, &CountedObject::m_Link>;
+    CountedObject sObjects[4];
+    CountedList sList;
+    for (CountedObject& sObj : sObjects)
+        sList.insertBack(sObj);
+    sList.removeItem(sObjects[0]);
+    size_t sCount = 0;
+    for (auto sItr = sList.begin(); sItr != sList.end(); ++sItr)
+        ++sCount;
+    CHECK(sCount, size_t(3));
+    CHECK(sList.stats().inserts(), size_t(4));
+    CHECK(sList.stats().removes(), size_t(1));
+    CHECK(sList.stats().steps(), size_t(3));
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    relocation();
+    ranges();
+    stats();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Ring that stores offsets of its neighbours relative to itself instead of
+// pointers. A set of rings copied or mapped to another address as a whole
+// (shared memory, mmap-ed file) stays valid. Zero filled memory is a set
+// of alone rings.
+struct OffsetRing
+{
+    intptr_t m_Offset[2]; // generally {m_Prev, m_Next}
+
+    // Makes uninitialized structure.
+    OffsetRing() = default;
+    // Initializes alone ring.
+    OffsetRing(int) : m_Offset{0, 0} {}
+
+    // Copy ctor/assign are not actually implemented and do nothing.
+    OffsetRing(const OffsetRing&) {}
+    void operator=(const OffsetRing&) {}
+
+    void init()
+    {
+        m_Offset[0] = m_Offset[1] = 0;
+    };
+
+    OffsetRing* neigh(bool aNext)
+    {
+        return reinterpret_cast<OffsetRing*>(reinterpret_cast<uintptr_t>(this) + m_Offset[aNext]);
+    }
+    const OffsetRing* neigh(bool aNext) const
+    {
+        return reinterpret_cast<const OffsetRing*>(reinterpret_cast<uintptr_t>(this) + m_Offset[aNext]);
+    }
+
+    // Add new element a to the ring after this (if not aInverted)
+    void add(OffsetRing* a, bool aInvert = false)
+    {
+        link(a, neigh(!aInvert), aInvert);
+        link(this, a, aInvert);
+    }
+
+    void remove()
+    {
+        link(neigh(0), neigh(1), false);
+    }
+
+    // Add ring a to the ring after this ring and it's elements (if not aInverted)
+    void join(OffsetRing* a, bool aInvert = false)
+    {
+        OffsetRing* s = a->neigh(aInvert);
+        link(neigh(aInvert), a, aInvert);
+        link(s, this, aInvert);
+    }
+
+    // Leave in this ring element from this up to element a (if not aInverted)
+    // All other elements forms another ring (with element a).
+    void split(OffsetRing* a, bool aInvert = false)
+    {
+        OffsetRing* s = a->neigh(aInvert);
+        link(neigh(aInvert), a, aInvert);
+        link(s, this, aInvert);
+    }
+
+    void swap(OffsetRing* a)
+    {
+        join(a, false);
+        split(a, true);
+    }
+
+    bool isAlone() const
+    {
+        return 0 == m_Offset[0];
+    }
+
+    size_t calcSize() const
+    {
+        size_t sRes = 1;
+        for (const OffsetRing* sRing = neigh(0); this != sRing; sRing = sRing->neigh(0))
+            ++sRes;
+        return sRes;
+    }
+
+    int selfCheck() const
+    {
+        const OffsetRing* sRing = this;
+        do {
+            if (sRing != sRing->neigh(1)->neigh(0))
+                return 1;
+            sRing = sRing->neigh(1);
+        } while (sRing != this);
+        return 0;
+    }
+
+private:
+    static void link(OffsetRing* aPrev, OffsetRing* aNext, bool aInvert)
+    {
+        intptr_t sOffset = reinterpret_cast<uintptr_t>(aNext) - reinterpret_cast<uintptr_t>(aPrev);
+        aPrev->m_Offset[!aInvert] = sOffset;
+        aNext->m_Offset[aInvert] = -sOffset;
+    }
+};
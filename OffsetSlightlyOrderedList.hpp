@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <ListStats.hpp>
+#include <OffsetRing.hpp>
+#include <RingBatch.hpp>
+
+// Position independent variant of SlightlyOrderedList (see
+// SlightlyOrderedList.hpp). Item addresses are accounted relative to the
+// list head, so the list may be mapped at any address together with its
+// items. Zero filled memory is a valid set of alone links and empty lists.
+// Like OffsetAutoList.hpp, this file mirrors its pointer based original on
+// purpose; keep the API of both files in sync.
+
+class OffsetSlightlyOrderedListLink
+{
+public:
+    OffsetSlightlyOrderedListLink() : m_Ring(0) {}
+    ~OffsetSlightlyOrderedListLink() { }
+    OffsetSlightlyOrderedListLink(const OffsetSlightlyOrderedListLink&) : m_Ring(0) {}
+    OffsetSlightlyOrderedListLink& operator=(const OffsetSlightlyOrderedListLink&) { return *this; }
+    bool isAlone() const { return m_Ring.isAlone(); }
+
+    OffsetRing m_Ring;
+};
+
+// Stats is a statistics policy (see ListStats.hpp), stats are kept with
+// the list object and are not transferred by copy or move.
+template <class Item, OffsetSlightlyOrderedListLink Item::*LinkMember, size_t ItemSize = sizeof(Item),
+          class Stats = NoListStats>
+class OffsetSlightlyOrderedList : private Stats
+{
+public:
+    OffsetSlightlyOrderedList() : m_Ring(0) {}
+    ~OffsetSlightlyOrderedList() { }
+
+    OffsetSlightlyOrderedList(const OffsetSlightlyOrderedList&) : m_Ring(0) {}
+    OffsetSlightlyOrderedList& operator=(const OffsetSlightlyOrderedList&)
+    {
+        m_Ring.remove();
+        m_Ring.init();
+        m_AddrSum = 0;
+        m_Size = 0;
+        return *this;
+    }
+
+    // Relative addresses are rebased to the new head; the result is
+    // approximate, which is enough for the heuristic.
+    OffsetSlightlyOrderedList(OffsetSlightlyOrderedList&& aList) noexcept
+    {
+        aList.m_Ring.add(&m_Ring);
+        aList.m_Ring.remove();
+        aList.m_Ring.init();
+        std::swap(m_AddrSum, aList.m_AddrSum);
+        std::swap(m_Size, aList.m_Size);
+        m_AddrSum += static_cast<intptr_t>(m_Size) * relative(&aList);
+    }
+    OffsetSlightlyOrderedList& operator=(OffsetSlightlyOrderedList&& aList) noexcept
+    {
+        m_Ring.swap(&aList.m_Ring);
+        std::swap(m_AddrSum, aList.m_AddrSum);
+        std::swap(m_Size, aList.m_Size);
+        m_AddrSum += static_cast<intptr_t>(m_Size) * relative(&aList);
+        aList.m_AddrSum += static_cast<intptr_t>(aList.m_Size) * aList.relative(this);
+        return *this;
+    }
+
+    void insert(Item& aItem)
+    {
+        intptr_t sAddr = relative(&aItem);
+        m_AddrSum += sAddr;
+        ++m_Size;
+        bool sBack = sAddr * static_cast<intptr_t>(m_Size) > m_AddrSum;
+        Stats::onInsert();
+        if (sBack)
+            Stats::onBack();
+        else
+            Stats::onFront();
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), sBack);
+    }
+    void remove(Item& aItem)
+    {
+        m_AddrSum -= relative(&aItem);
+        if (0 == --m_Size)
+            m_AddrSum = 0;
+        Stats::onRemove();
+        (aItem.*LinkMember).m_Ring.remove();
+        (aItem.*LinkMember).m_Ring.init();
+    }
+    // Removes aCount items at once, faster than one by one if the items are
+    // given in list order (see removeRingBatch).
+    void removeBatch(Item* const* aItems, size_t aCount)
+    {
+        for (size_t i = 0; i < aCount; i++)
+        {
+            m_AddrSum -= relative(aItems[i]);
+            Stats::onRemove();
+        }
+        m_Size -= aCount;
+        if (0 == m_Size)
+            m_AddrSum = 0;
+        removeRingBatch(aItems, aCount, [](Item* aItem) { return &(aItem->*LinkMember).m_Ring; });
+    }
+    // The same as removeBatch, but first sorts aItems by address (see
+    // sortRingBatch), for batches that are collected in random order.
+    void removeBatchSorted(Item** aItems, size_t aCount)
+    {
+        sortRingBatch(aItems, aCount);
+        removeBatch(aItems, aCount);
+    }
+    const Stats& stats() const
+    {
+        return *this;
+    }
+    bool empty() const
+    {
+        return m_Ring.isAlone();
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+    Item& front()
+    {
+        return *item(m_Ring.neigh(1));
+    }
+    const Item& front() const
+    {
+        return *item(m_Ring.neigh(1));
+    }
+    Item& back()
+    {
+        return *item(m_Ring.neigh(0));
+    }
+    const Item& back() const
+    {
+        return *item(m_Ring.neigh(0));
+    }
+
+    template <class TItem, class TRing>
+    class iterator_common : ListStatsRef<Stats>
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, const Stats* aStats) : ListStatsRef<Stats>(aStats), m_Ring(aRing) {}
+        TItem& operator*() const { return *item(m_Ring); }
+        TItem* operator->() const { return item(m_Ring); }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
+        bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
+        iterator_common& operator++() { this->onStep(); m_Ring = m_Ring->neigh(1); return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { this->onStep(); m_Ring = m_Ring->neigh(0); return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TRing* m_Ring;
+    };
+    using iterator = iterator_common<Item, OffsetRing>;
+    using const_iterator = iterator_common<const Item, const OffsetRing>;
+
+    iterator begin() { return iterator(m_Ring.neigh(1), this); }
+    iterator end() { return iterator(&m_Ring, this); }
+    const_iterator begin() const { return const_iterator(m_Ring.neigh(1), this); }
+    const_iterator end() const { return const_iterator(&m_Ring, this); }
+
+private:
+    OffsetRing m_Ring;
+    intptr_t m_AddrSum = 0;
+    size_t m_Size = 0;
+    static constexpr int log2(size_t n)
+    {
+        return ( n == 1 ? 0 : 1 + log2(n / 2));
+    }
+    static constexpr intptr_t ADDR_UNIT = intptr_t(1) << log2(ItemSize);
+
+    // Address of aPtr relative to this head in ItemSize units.
+    intptr_t relative(const void* aPtr) const
+    {
+        return static_cast<intptr_t>(reinterpret_cast<uintptr_t>(aPtr) - reinterpret_cast<uintptr_t>(this)) / ADDR_UNIT;
+    }
+
+    static Item* item(OffsetRing* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+    static const Item* item(const OffsetRing* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
+    }
+};
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Compact binary trace of list operations.
+//
+// File layout: 32 byte header {magic "LSTTRACE", version, object count,
+// list count, record count} followed by records. Every record is one byte
+// of operation (low 4 bits) and flags, an optional LEB128 list id (only when
+// it differs from the previous record's one), then zigzag LEB128 deltas of
+// object ids from the previous object id. Sequential ids cost one byte.
+
+enum TraceOp : uint8_t
+{
+    TRACE_INSERT_FRONT, // id
+    TRACE_INSERT_BACK,  // id
+    TRACE_REMOVE,       // id
+    TRACE_RELINK_FRONT, // id: remove and insert to front
+    TRACE_RELINK_BACK,  // id: remove and insert to back
+    TRACE_COPY,         // id, id2: id2 becomes a copy of id (linked next to it)
+    TRACE_MOVE,         // id, id2: id2 takes place of id, id becomes unlinked
+    TRACE_TRAVERSE,     // walk the whole list
+    TRACE_OP_COUNT
+};
+
+struct TraceRecord
+{
+    TraceOp m_Op;
+    uint32_t m_List;
+    uint64_t m_Id;
+    uint64_t m_Id2;
+};
+
+struct TraceHeader
+{
+    char m_Magic[8];
+    uint32_t m_Version;
+    uint32_t m_ListCount;
+    uint64_t m_ObjectCount;
+    uint64_t m_RecordCount;
+};
+
+static_assert(sizeof(TraceHeader) == 32, "Trace header must be packed");
+
+class TraceWriter
+{
+public:
+    TraceWriter() = default;
+    ~TraceWriter()
+    {
+        close();
+    }
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Returns false if the file cannot be created.
+    bool open(const char* aPath)
+    {
+        close();
+        m_File = fopen(aPath, "wb");
+        if (nullptr == m_File)
+            return false;
+        m_Header = TraceHeader{{'L', 'S', 'T', 'T', 'R', 'A', 'C', 'E'}, VERSION, 0, 0, 0};
+        m_List = 0;
+        m_LastId = 0;
+        m_Failed = 1 != fwrite(&m_Header, sizeof(m_Header), 1, m_File);
+        return !m_Failed;
+    }
+
+    // Flushes the records and finalizes the header. Returns false if any IO
+    // since open failed.
+    bool close()
+    {
+        if (nullptr == m_File)
+            return true;
+        bool sOk = flush() && !m_Failed;
+        sOk = sOk && 0 == fseek(m_File, 0, SEEK_SET);
+        sOk = sOk && 1 == fwrite(&m_Header, sizeof(m_Header), 1, m_File);
+        sOk = (0 == fclose(m_File)) && sOk;
+        m_File = nullptr;
+        return sOk;
+    }
+
+    void insertFront(uint64_t aId, uint32_t aList = 0) { write(TRACE_INSERT_FRONT, aList, aId); }
+    void insertBack(uint64_t aId, uint32_t aList = 0) { write(TRACE_INSERT_BACK, aList, aId); }
+    void remove(uint64_t aId, uint32_t aList = 0) { write(TRACE_REMOVE, aList, aId); }
+    void relinkFront(uint64_t aId, uint32_t aList = 0) { write(TRACE_RELINK_FRONT, aList, aId); }
+    void relinkBack(uint64_t aId, uint32_t aList = 0) { write(TRACE_RELINK_BACK, aList, aId); }
+    void copy(uint64_t aFrom, uint64_t aTo, uint32_t aList = 0) { write(TRACE_COPY, aList, aFrom, aTo); }
+    void move(uint64_t aFrom, uint64_t aTo, uint32_t aList = 0) { write(TRACE_MOVE, aList, aFrom, aTo); }
+    void traverse(uint32_t aList = 0) { write(TRACE_TRAVERSE, aList); }
+
+    void write(const TraceRecord& aRecord)
+    {
+        write(aRecord.m_Op, aRecord.m_List, aRecord.m_Id, aRecord.m_Id2);
+    }
+
+private:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+    static constexpr size_t MAX_RECORD_SIZE = 1 + 5 + 10 + 10;
+    static constexpr uint8_t LIST_FLAG = 0x10;
+
+    FILE* m_File = nullptr;
+    // Latched by a failed write, reported by close.
+    bool m_Failed = false;
+    TraceHeader m_Header;
+    uint32_t m_List = 0;
+    uint64_t m_LastId = 0;
+    size_t m_Used = 0;
+    uint8_t m_Buffer[BUFFER_SIZE];
+
+    // Records written to a writer that is not open are dropped.
+    void write(TraceOp aOp, uint32_t aList, uint64_t aId = 0, uint64_t aId2 = 0)
+    {
+        assert(nullptr != m_File && "the trace is not open");
+        if (nullptr == m_File)
+            return;
+        if (m_Used + MAX_RECORD_SIZE > BUFFER_SIZE)
+            flush();
+        uint8_t sOp = aOp;
+        if (aList != m_List)
+            sOp |= LIST_FLAG;
+        m_Buffer[m_Used++] = sOp;
+        if (aList != m_List)
+        {
+            putVarint(aList);
+            m_List = aList;
+            if (aList >= m_Header.m_ListCount)
+                m_Header.m_ListCount = aList + 1;
+        }
+        if (0 == m_Header.m_ListCount)
+            m_Header.m_ListCount = 1;
+        if (aOp != TRACE_TRAVERSE)
+            putId(aId);
+        if (aOp == TRACE_COPY || aOp == TRACE_MOVE)
+            putId(aId2);
+        ++m_Header.m_RecordCount;
+    }
+    void putId(uint64_t aId)
+    {
+        int64_t sDelta = static_cast<int64_t>(aId - m_LastId);
+        putVarint((static_cast<uint64_t>(sDelta) << 1) ^ static_cast<uint64_t>(sDelta >> 63));
+        m_LastId = aId;
+        if (aId >= m_Header.m_ObjectCount)
+            m_Header.m_ObjectCount = aId + 1;
+    }
+    void putVarint(uint64_t aValue)
+    {
+        while (aValue >= 0x80)
+        {
+            m_Buffer[m_Used++] = static_cast<uint8_t>(aValue | 0x80);
+            aValue >>= 7;
+        }
+        m_Buffer[m_Used++] = static_cast<uint8_t>(aValue);
+    }
+    bool flush()
+    {
+        bool sOk = 0 == m_Used || 1 == fwrite(m_Buffer, m_Used, 1, m_File);
+        m_Used = 0;
+        if (!sOk)
+            m_Failed = true;
+        return sOk;
+    }
+};
+
+// Reads the whole trace into memory so that replay measures lists, not IO.
+class TraceReader
+{
+public:
+    TraceReader() = default;
+    ~TraceReader()
+    {
+        delete[] m_Data;
+    }
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    // Returns false if the file cannot be read or is not a trace, the reader
+    // is empty then.
+    bool open(const char* aPath)
+    {
+        delete[] m_Data;
+        m_Data = nullptr;
+        m_Size = 0;
+        rewind();
+        FILE* sFile = fopen(aPath, "rb");
+        if (nullptr == sFile)
+            return false;
+        bool sOk = 1 == fread(&m_Header, sizeof(m_Header), 1, sFile) &&
+                   0 == memcmp(m_Header.m_Magic, "LSTTRACE", 8) &&
+                   VERSION == m_Header.m_Version;
+        long sStart = ftell(sFile);
+        sOk = sOk && 0 == fseek(sFile, 0, SEEK_END);
+        long sEnd = ftell(sFile);
+        sOk = sOk && sStart >= 0 && sEnd >= sStart && 0 == fseek(sFile, sStart, SEEK_SET);
+        if (sOk)
+        {
+            m_Size = sEnd - sStart;
+            m_Data = new uint8_t[m_Size];
+            sOk = 0 == m_Size || 1 == fread(m_Data, m_Size, 1, sFile);
+            if (!sOk)
+            {
+                delete[] m_Data;
+                m_Data = nullptr;
+                m_Size = 0;
+            }
+        }
+        fclose(sFile);
+        return sOk;
+    }
+
+    void rewind()
+    {
+        m_Pos = 0;
+        m_List = 0;
+        m_LastId = 0;
+    }
+
+    const TraceHeader& header() const
+    {
+        return m_Header;
+    }
+    // Size of the records in bytes, every record takes one at least.
+    size_t dataSize() const
+    {
+        return m_Size;
+    }
+
+    // Returns false at the end of trace or on a broken record.
+    bool next(TraceRecord& aRecord)
+    {
+        if (m_Pos >= m_Size)
+            return false;
+        uint8_t sOp = m_Data[m_Pos++];
+        if ((sOp & 0x0f) >= TRACE_OP_COUNT)
+            return false;
+        aRecord.m_Op = static_cast<TraceOp>(sOp & 0x0f);
+        if (sOp & 0x10)
+        {
+            uint64_t sList;
+            if (!getVarint(sList))
+                return false;
+            m_List = static_cast<uint32_t>(sList);
+        }
+        aRecord.m_List = m_List;
+        aRecord.m_Id = aRecord.m_Id2 = 0;
+        if (aRecord.m_Op != TRACE_TRAVERSE && !getId(aRecord.m_Id))
+            return false;
+        if ((aRecord.m_Op == TRACE_COPY || aRecord.m_Op == TRACE_MOVE) && !getId(aRecord.m_Id2))
+            return false;
+        return true;
+    }
+
+private:
+    static constexpr uint32_t VERSION = 1;
+
+    TraceHeader m_Header;
+    uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+    size_t m_Pos = 0;
+    uint32_t m_List = 0;
+    uint64_t m_LastId = 0;
+
+    bool getId(uint64_t& aId)
+    {
+        uint64_t sZigzag;
+        if (!getVarint(sZigzag))
+            return false;
+        m_LastId += (sZigzag >> 1) ^ (~(sZigzag & 1) + 1);
+        aId = m_LastId;
+        return true;
+    }
+    bool getVarint(uint64_t& aValue)
+    {
+        aValue = 0;
+        for (unsigned sShift = 0; sShift < 64 && m_Pos < m_Size; sShift += 7)
+        {
+            uint8_t sByte = m_Data[m_Pos++];
+            aValue |= static_cast<uint64_t>(sByte & 0x7f) << sShift;
+            if (0 == (sByte & 0x80))
+                return true;
+        }
+        return false;
+    }
+};
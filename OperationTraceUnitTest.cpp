@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <OperationTrace.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+const char* PATH = "OperationTraceUnitTest.trace";
+
+void empty_trace()
+{
+    ANNOUNCE();
+
+    {
+        TraceWriter sWriter;
+        CHECK(sWriter.open(PATH));
+        CHECK(sWriter.close());
+    }
+    TraceReader sReader;
+    CHECK(sReader.open(PATH));
+    CHECK(sReader.header().m_RecordCount, uint64_t(0));
+    CHECK(sReader.header().m_ObjectCount, uint64_t(0));
+    TraceRecord sRecord;
+    CHECK(!sReader.next(sRecord));
+}
+
+void round_trip()
+{
+    ANNOUNCE();
+
+    std::vector<TraceRecord> sRecords = {
+        {TRACE_INSERT_FRONT, 0, 0, 0},
+        {TRACE_INSERT_FRONT, 0, 1, 0},
+        {TRACE_INSERT_BACK, 0, 2, 0},
+        {TRACE_RELINK_FRONT, 0, 0, 0},
+        {TRACE_RELINK_BACK, 3, 1000000007, 0},
+        {TRACE_COPY, 3, 5, 4},
+        {TRACE_MOVE, 0, 4, UINT64_MAX / 3},
+        {TRACE_TRAVERSE, 0, 0, 0},
+        {TRACE_TRAVERSE, 7, 0, 0},
+        {TRACE_REMOVE, 7, 2, 0},
+        {TRACE_REMOVE, 0, 1, 0},
+    };
+    {
+        TraceWriter sWriter;
+        CHECK(sWriter.open(PATH));
+        for (const TraceRecord& sRecord : sRecords)
+            sWriter.write(sRecord);
+        CHECK(sWriter.close());
+    }
+
+    TraceReader sReader;
+    CHECK(sReader.open(PATH));
+    CHECK(sReader.header().m_RecordCount, uint64_t(sRecords.size()));
+    CHECK(sReader.header().m_ObjectCount, UINT64_MAX / 3 + 1);
+    CHECK(sReader.header().m_ListCount, uint32_t(8));
+    for (int sPass = 0; sPass < 2; sPass++)
+    {
+        TraceRecord sRecord;
+        for (const TraceRecord& sExpected : sRecords)
+        {
+            CHECK(sReader.next(sRecord));
+            CHECK(int(sRecord.m_Op), int(sExpected.m_Op));
+            CHECK(sRecord.m_List, sExpected.m_List);
+            CHECK(sRecord.m_Id, sExpected.m_Id);
+            CHECK(sRecord.m_Id2, sExpected.m_Id2);
+        }
+        CHECK(!sReader.next(sRecord));
+        sReader.rewind();
+    }
+}
+
+void compactness()
+{
+    ANNOUNCE();
+
+    const size_t COUNT = 1000000;
+    {
+        TraceWriter sWriter;
+        CHECK(sWriter.open(PATH));
+        for (size_t i = 0; i < COUNT; i++)
+            sWriter.insertBack(i);
+        CHECK(sWriter.close());
+    }
+
+    FILE* sFile = fopen(PATH, "rb");
+    CHECK(nullptr != sFile);
+    fseek(sFile, 0, SEEK_END);
+    CHECK(size_t(ftell(sFile)), sizeof(TraceHeader) + 2 * COUNT);
+    fclose(sFile);
+
+    TraceReader sReader;
+    CHECK(sReader.open(PATH));
+    TraceRecord sRecord;
+    size_t sCount = 0;
+    while (sReader.next(sRecord))
+    {
+        if (sRecord.m_Op != TRACE_INSERT_BACK || sRecord.m_Id != sCount)
+            break;
+        ++sCount;
+    }
+    CHECK(sCount, COUNT);
+}
+
+void broken()
+{
+    ANNOUNCE();
+
+    TraceReader sReader;
+    CHECK(!sReader.open("nonexistent/path.trace"));
+
+    FILE* sFile = fopen(PATH, "wb");
+    fputs("definitely not a trace file", sFile);
+    fclose(sFile);
+    CHECK(!sReader.open(PATH));
+}
+
+void failed_reopen()
+{
+    ANNOUNCE();
+
+    {
+        TraceWriter sWriter;
+        CHECK(sWriter.open(PATH));
+        for (uint64_t i = 0; i < 100; i++)
+            sWriter.insertBack(i);
+        CHECK(sWriter.close());
+    }
+    std::vector<char> sValid;
+    FILE* sFile = fopen(PATH, "rb");
+    for (int c = fgetc(sFile); c != EOF; c = fgetc(sFile))
+        sValid.push_back(char(c));
+    fclose(sFile);
+
+    // A failed open leaves the reader empty, not with the previous data.
+    TraceReader sReader;
+    TraceRecord sRecord;
+    CHECK(sReader.open(PATH));
+    CHECK(sReader.next(sRecord));
+    CHECK(!sReader.open("nonexistent/path.trace"));
+    CHECK(sReader.dataSize(), size_t(0));
+    CHECK(!sReader.next(sRecord));
+
+    // The same for a file truncated in the middle of the header.
+    CHECK(sReader.open(PATH));
+    sFile = fopen(PATH, "wb");
+    fwrite(sValid.data(), sizeof(TraceHeader) / 2, 1, sFile);
+    fclose(sFile);
+    CHECK(!sReader.open(PATH));
+    CHECK(sReader.dataSize(), size_t(0));
+    CHECK(!sReader.next(sRecord));
+}
+
+void write_error()
+{
+    ANNOUNCE();
+
+    // Every write to /dev/full fails; the failure of a flush in the middle
+    // of the trace must be reported by close.
+    FILE* sFull = fopen("/dev/full", "wb");
+    if (nullptr == sFull)
+        return;
+    fclose(sFull);
+    TraceWriter sWriter;
+    sWriter.open("/dev/full");
+    for (uint64_t i = 0; i < 1000000; i++)
+        sWriter.insertBack(i * 1000);
+    CHECK(!sWriter.close());
+    // Closed and not open writers are fine to close.
+    CHECK(sWriter.close());
+}
+
+} // anonymous namespace
+
+int main()
+{
+    empty_trace();
+    round_trip();
+    compactness();
+    broken();
+    failed_reopen();
+    write_error();
+    remove(PATH);
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
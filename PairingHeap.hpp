@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include <Ring.hpp>
+
+// Intrusive pairing heap. Children of a node are kept in a Ring of siblings,
+// so a node is cut from its parent in O(1) by decreaseKey or erase.
+// O(1) insert, top, meld and decreaseKey; amortized O(log n) pop and erase
+// with two-pass pairing.
+//
+// Less compares items, the top is the least item. A key is changed by the
+// user, then decreaseKey is called for the item; the key must not increase
+// (erase and insert the item to do that). An item must be popped or erased
+// before it's destroyed.
+
+class PairingHeapLink
+{
+public:
+    PairingHeapLink() : m_Siblings(0) {}
+    PairingHeapLink(const PairingHeapLink&) : m_Siblings(0) {}
+    PairingHeapLink& operator=(const PairingHeapLink&) { return *this; }
+    bool isAlone() const { return m_Siblings.isAlone() && nullptr == m_Parent && nullptr == m_Child; }
+
+    // Must be the first member, see PairingHeap::link.
+    Ring m_Siblings;
+    PairingHeapLink* m_Parent = nullptr;
+    // The first child, the rest follow it in m_Siblings.
+    PairingHeapLink* m_Child = nullptr;
+};
+
+template <class Item, PairingHeapLink Item::*LinkMember, class Less = std::less<Item>>
+class PairingHeap
+{
+public:
+    explicit PairingHeap(const Less& aLess = Less()) : m_Less(aLess) {}
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+
+    bool empty() const
+    {
+        return nullptr == m_Root;
+    }
+    size_t size() const
+    {
+        return m_Size;
+    }
+    Item& top()
+    {
+        return *item(m_Root);
+    }
+    const Item& top() const
+    {
+        return *item(m_Root);
+    }
+
+    void insert(Item& aItem)
+    {
+        m_Root = meld(m_Root, &(aItem.*LinkMember));
+        ++m_Size;
+    }
+    // Moves all items of aHeap to this heap.
+    void meld(PairingHeap& aHeap)
+    {
+        m_Root = meld(m_Root, aHeap.m_Root);
+        m_Size += aHeap.m_Size;
+        aHeap.m_Root = nullptr;
+        aHeap.m_Size = 0;
+    }
+    // The key of aItem was decreased (or left the same).
+    void decreaseKey(Item& aItem)
+    {
+        PairingHeapLink* sLink = &(aItem.*LinkMember);
+        if (sLink == m_Root)
+            return;
+        if (!m_Less(aItem, *item(sLink->m_Parent)))
+            return;
+        cut(sLink);
+        m_Root = meld(m_Root, sLink);
+    }
+    void pop()
+    {
+        PairingHeapLink* sRoot = m_Root;
+        m_Root = combineChildren(sRoot);
+        sRoot->m_Child = nullptr;
+        --m_Size;
+    }
+    void erase(Item& aItem)
+    {
+        PairingHeapLink* sLink = &(aItem.*LinkMember);
+        if (sLink == m_Root)
+        {
+            pop();
+            return;
+        }
+        cut(sLink);
+        m_Root = meld(m_Root, combineChildren(sLink));
+        sLink->m_Child = nullptr;
+        --m_Size;
+    }
+
+private:
+    PairingHeapLink* m_Root = nullptr;
+    size_t m_Size = 0;
+    Less m_Less;
+
+    // Melds two trees (either may be null), both roots must be alone.
+    PairingHeapLink* meld(PairingHeapLink* a, PairingHeapLink* b)
+    {
+        if (nullptr == a)
+            return b;
+        if (nullptr == b)
+            return a;
+        if (m_Less(*item(b), *item(a)))
+            std::swap(a, b);
+        // The newest child goes first.
+        if (nullptr != a->m_Child)
+            a->m_Child->m_Siblings.add(&b->m_Siblings, true);
+        a->m_Child = b;
+        b->m_Parent = a;
+        return a;
+    }
+    // Detaches the subtree of aLink (not a root) from its parent.
+    static void cut(PairingHeapLink* aLink)
+    {
+        PairingHeapLink* sParent = aLink->m_Parent;
+        if (sParent->m_Child == aLink)
+            sParent->m_Child = aLink->m_Siblings.isAlone() ? nullptr : link(aLink->m_Siblings.m_Neigh[1]);
+        aLink->m_Siblings.remove();
+        aLink->m_Siblings.init();
+        aLink->m_Parent = nullptr;
+    }
+    static PairingHeapLink* popChild(PairingHeapLink* aParent)
+    {
+        PairingHeapLink* sChild = aParent->m_Child;
+        cut(sChild);
+        return sChild;
+    }
+    // Two-pass pairing: children are melded in pairs from the first to the
+    // last, then the pairs are melded from the last to the first. Returns
+    // the new root of the children, aLink is left without children.
+    PairingHeapLink* combineChildren(PairingHeapLink* aLink)
+    {
+        if (nullptr == aLink->m_Child)
+            return nullptr;
+        Ring sPairs(0);
+        while (nullptr != aLink->m_Child)
+        {
+            PairingHeapLink* a = popChild(aLink);
+            PairingHeapLink* b = nullptr == aLink->m_Child ? nullptr : popChild(aLink);
+            sPairs.add(&meld(a, b)->m_Siblings, true);
+        }
+        PairingHeapLink* sResult = link(sPairs.m_Neigh[0]);
+        sResult->m_Siblings.remove();
+        sResult->m_Siblings.init();
+        while (!sPairs.isAlone())
+        {
+            PairingHeapLink* sPair = link(sPairs.m_Neigh[0]);
+            sPair->m_Siblings.remove();
+            sPair->m_Siblings.init();
+            sResult = meld(sResult, sPair);
+        }
+        return sResult;
+    }
+
+    static PairingHeapLink* link(Ring* aRing)
+    {
+        return reinterpret_cast<PairingHeapLink*>(aRing);
+    }
+    static Item* item(PairingHeapLink* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+};
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <FibonacciHeap.hpp>
+#include <PairingHeap.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct Task
+    {
+        uint64_t m_Key = 0;
+        PairingHeapLink m_PairingLink;
+        FibonacciHeapLink m_FibonacciLink;
+        size_t m_Index = 0;
+    };
+
+    struct TaskLess
+    {
+        bool operator()(const Task& a, const Task& b) const { return a.m_Key < b.m_Key; }
+    };
+
+    // Intrusive binary heap: a task knows its position in the array.
+    class BinaryHeap
+    {
+    public:
+        bool empty() const { return m_Tasks.empty(); }
+        Task& top() { return *m_Tasks.front(); }
+        void insert(Task& aTask)
+        {
+            aTask.m_Index = m_Tasks.size();
+            m_Tasks.push_back(&aTask);
+            siftUp(aTask.m_Index);
+        }
+        void pop()
+        {
+            place(m_Tasks.back(), 0);
+            m_Tasks.pop_back();
+            if (!m_Tasks.empty())
+                siftDown(0);
+        }
+        void decreaseKey(Task& aTask)
+        {
+            siftUp(aTask.m_Index);
+        }
+    private:
+        std::vector<Task*> m_Tasks;
+
+        void place(Task* aTask, size_t aIndex)
+        {
+            m_Tasks[aIndex] = aTask;
+            aTask->m_Index = aIndex;
+        }
+        void siftUp(size_t aIndex)
+        {
+            Task* sTask = m_Tasks[aIndex];
+            while (aIndex > 0 && sTask->m_Key < m_Tasks[(aIndex - 1) / 2]->m_Key)
+            {
+                place(m_Tasks[(aIndex - 1) / 2], aIndex);
+                aIndex = (aIndex - 1) / 2;
+            }
+            place(sTask, aIndex);
+        }
+        void siftDown(size_t aIndex)
+        {
+            Task* sTask = m_Tasks[aIndex];
+            size_t sSize = m_Tasks.size();
+            for (size_t sChild = 2 * aIndex + 1; sChild < sSize; sChild = 2 * aIndex + 1)
+            {
+                if (sChild + 1 < sSize && m_Tasks[sChild + 1]->m_Key < m_Tasks[sChild]->m_Key)
+                    ++sChild;
+                if (!(m_Tasks[sChild]->m_Key < sTask->m_Key))
+                    break;
+                place(m_Tasks[sChild], aIndex);
+                aIndex = sChild;
+            }
+            place(sTask, aIndex);
+        }
+    };
+
+    using Pairing = PairingHeap<Task, &Task::m_PairingLink, TaskLess>;
+    using Fibonacci = FibonacciHeap<Task, &Task::m_FibonacciLink, TaskLess>;
+
+    // Lazy deletion: a task is pushed again on every decrease, outdated
+    // entries are skipped when popped.
+    class StdQueue
+    {
+    public:
+        bool empty() const { return m_Queue.empty(); }
+        Task& top()
+        {
+            while (m_Queue.top().first != m_Queue.top().second->m_Key)
+                m_Queue.pop();
+            return *m_Queue.top().second;
+        }
+        void insert(Task& aTask) { m_Queue.push(Entry(aTask.m_Key, &aTask)); }
+        void pop() { top(); m_Queue.pop(); }
+        void decreaseKey(Task& aTask) { insert(aTask); }
+    private:
+        using Entry = std::pair<uint64_t, Task*>;
+        struct EntryGreater
+        {
+            bool operator()(const Entry& a, const Entry& b) const { return a.first > b.first; }
+        };
+        std::priority_queue<Entry, std::vector<Entry>, EntryGreater> m_Queue;
+    };
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+// Scheduler-like "hold" model: the earliest task is taken and rescheduled
+// to a later time; every aDecreasePeriod-th operation also reschedules a
+// random task to an earlier time.
+template <class Heap>
+static void hold(const char* aName, size_t aSize, size_t aOps, size_t aDecreasePeriod)
+{
+    std::vector<Task> sTasks(aSize);
+    std::mt19937 sRand(aSize);
+    Heap sHeap;
+    for (Task& t : sTasks)
+    {
+        t.m_Key = sRand() % (aSize * 16);
+        sHeap.insert(t);
+    }
+    checkpoint("", 0);
+
+    for (size_t i = 0; i < aOps; i++)
+    {
+        Task& t = sHeap.top();
+        sHeap.pop();
+        t.m_Key += 1 + sRand() % (aSize * 16);
+        sHeap.insert(t);
+        if (0 != aDecreasePeriod && i % aDecreasePeriod == 0)
+        {
+            Task& d = sTasks[sRand() % aSize];
+            if (d.m_Key > 0)
+            {
+                d.m_Key -= 1 + sRand() % std::min<uint64_t>(d.m_Key, aSize);
+                sHeap.decreaseKey(d);
+            }
+        }
+    }
+    checkpoint(aName, aOps);
+    SideEffect += sHeap.top().m_Key;
+}
+
+static void test(size_t aSize, size_t aDecreasePeriod)
+{
+    const size_t OPS = 4 * 1024 * 1024;
+    std::cout << "Hold model, " << aSize << " tasks";
+    if (0 != aDecreasePeriod)
+        std::cout << ", decrease key every " << aDecreasePeriod << " ops";
+    std::cout << std::endl;
+    hold<Pairing>("PairingHeap", aSize, OPS, aDecreasePeriod);
+    hold<Fibonacci>("FibonacciHeap", aSize, OPS, aDecreasePeriod);
+    hold<BinaryHeap>("Intrusive binary heap", aSize, OPS, aDecreasePeriod);
+    hold<StdQueue>("std::priority_queue", aSize, OPS, aDecreasePeriod);
+}
+
+int main()
+{
+    const size_t SIZES[] = {1024, 64 * 1024, 1024 * 1024};
+    for (size_t sSize : SIZES)
+    {
+        test(sSize, 0);
+        test(sSize, 1);
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <OffsetRing.hpp>
+#include <Ring.hpp>
+
+// Removal of many rings at once, see removeRingBatch and sortRingBatch.
+
+namespace ring_batch_details
+{
+    inline void prefetchForWrite(const void* aAddr)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(aAddr, 1);
+#else
+        (void)aAddr;
+#endif
+    }
+
+    // Prefetch distance (in victims) of the victims themselves; their
+    // neighbours are prefetched at half of the distance, when the victim
+    // is already in cache.
+    const size_t PREFETCH_DISTANCE = 16;
+
+    // Neighbour access for both kinds of rings (see Ring.hpp, OffsetRing.hpp).
+    inline Ring* neigh(Ring* aRing, bool aNext)
+    {
+        return aRing->m_Neigh[aNext];
+    }
+    inline OffsetRing* neigh(OffsetRing* aRing, bool aNext)
+    {
+        return aRing->neigh(aNext);
+    }
+}
+
+// Removes rings aRingOf(aItems[i]), i < aCount, from the rings they are in
+// and makes them alone. Rings are processed in the given order in one pass:
+// victims and their neighbours are prefetched ahead, so the cache misses of
+// several removals overlap. Victims that go one after another both in the
+// array and in the ring form a run that is cut out by one split, so a
+// neighbour outside of the run is written once per run. Thus it's best to
+// pass victims in list order, e.g. as they were collected by traversal.
+// An alone ring is left intact. aRingOf may return either Ring* or
+// OffsetRing*.
+template <class T, class RingOf>
+void removeRingBatch(T* const* aItems, size_t aCount, RingOf aRingOf)
+{
+    using namespace ring_batch_details;
+    size_t sVictimsAhead = 0;
+    size_t sNeighboursAhead = 0;
+    for (size_t i = 0; i < aCount; )
+    {
+        // A run consumes several victims, keep the distance anyway.
+        for (; sVictimsAhead < aCount && sVictimsAhead < i + PREFETCH_DISTANCE; ++sVictimsAhead)
+            prefetchForWrite(aRingOf(aItems[sVictimsAhead]));
+        for (; sNeighboursAhead < aCount && sNeighboursAhead < i + PREFETCH_DISTANCE / 2; ++sNeighboursAhead)
+        {
+            auto* sAhead = aRingOf(aItems[sNeighboursAhead]);
+            prefetchForWrite(neigh(sAhead, 0));
+            prefetchForWrite(neigh(sAhead, 1));
+        }
+
+        auto* sFirst = aRingOf(aItems[i]);
+        auto* sLast = sFirst;
+        for (++i; i < aCount && neigh(sLast, 1) == aRingOf(aItems[i]); ++i)
+            sLast = neigh(sLast, 1);
+        sFirst->split(neigh(sLast, 1));
+        // Now the run is a separate ring, dissolve it.
+        for (auto* sRing = sFirst; ; )
+        {
+            auto* sNext = neigh(sRing, 1);
+            sRing->init();
+            if (sNext == sFirst)
+                break;
+            sRing = sNext;
+        }
+    }
+}
+
+// Sorts victims of removeRingBatch by their addresses. That is an option
+// when the victims are collected in random order: items that are close in
+// memory (e.g. allocated from one pool) are then removed one after another,
+// and, if the list was built in address order, runs are restored. Sorting
+// costs O(n log n) and spoils a batch that is already in list order; in
+// AutoListPerf/SlightlyOrderedListPerf the sort itself costs more than it
+// saves, so measure before preferring it.
+template <class T>
+void sortRingBatch(T** aItems, size_t aCount)
+{
+    std::sort(aItems, aItems + aCount, std::less<T*>());
+}
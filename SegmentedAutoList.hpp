@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <AutoList.hpp>
+
+// AutoList that keeps hidden marker nodes in its ring, about one per
+// SegmentSize items, so that the list can be cut into independent ranges
+// without walking it (see parallelForEach).
+//
+// A marker is placed after every SegmentSize insertions to the front (or to
+// the back). insertAfter doesn't place markers: items inserted in the middle
+// only grow the segment they land in, so a list built mostly by insertAfter
+// stays one segment (and parallelForEach runs it serially) until
+// rebalance(). Removals are not tracked (items remove themselves as usual),
+// so segments only shrink; rebalance() redistributes markers in O(n).
+// Iteration, front() and back() skip markers.
+template <class Item, AutoListLink Item::*LinkMember, size_t SegmentSize = 4096>
+class SegmentedAutoList
+{
+public:
+    SegmentedAutoList() : m_Ring(0) {}
+    ~SegmentedAutoList()
+    {
+        releaseMarkers();
+        m_Ring.remove();
+    }
+
+    SegmentedAutoList(const SegmentedAutoList&) : m_Ring(0) {}
+    SegmentedAutoList& operator=(const SegmentedAutoList&)
+    {
+        releaseMarkers();
+        m_Ring.remove();
+        m_Ring.init();
+        return *this;
+    }
+
+    SegmentedAutoList(SegmentedAutoList&& aList) noexcept
+        : m_Markers(std::move(aList.m_Markers)), m_MarkerCapacity(aList.m_MarkerCapacity),
+          m_MarkerCount(aList.m_MarkerCount), m_FrontCount(aList.m_FrontCount), m_BackCount(aList.m_BackCount)
+    {
+        aList.m_Ring.add(&m_Ring);
+        aList.m_Ring.remove();
+        aList.m_Ring.init();
+        aList.m_MarkerCapacity = aList.m_MarkerCount = 0;
+        aList.m_FrontCount = aList.m_BackCount = 0;
+    }
+    SegmentedAutoList& operator=(SegmentedAutoList&& aList) noexcept
+    {
+        m_Ring.swap(&aList.m_Ring);
+        std::swap(m_Markers, aList.m_Markers);
+        std::swap(m_MarkerCapacity, aList.m_MarkerCapacity);
+        std::swap(m_MarkerCount, aList.m_MarkerCount);
+        std::swap(m_FrontCount, aList.m_FrontCount);
+        std::swap(m_BackCount, aList.m_BackCount);
+        return *this;
+    }
+
+    void insertFront(Item& aItem)
+    {
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), false);
+        if (++m_FrontCount == SegmentSize)
+        {
+            m_FrontCount = 0;
+            m_Ring.add(newMarker(), false);
+        }
+    }
+    void insertBack(Item& aItem)
+    {
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), true);
+        if (++m_BackCount == SegmentSize)
+        {
+            m_BackCount = 0;
+            m_Ring.add(newMarker(), true);
+        }
+    }
+    // Doesn't create segments, see the class comment.
+    void insertAfter(Item& aExistingItem, Item& aNewItem)
+    {
+        (aExistingItem.*LinkMember).m_Ring.add(&((aNewItem.*LinkMember).m_Ring), false);
+    }
+    void removeItem(Item& aItem)
+    {
+        (aItem.*LinkMember).remove();
+    }
+    bool empty() const
+    {
+        return &m_Ring == skip(m_Ring.m_Neigh[1], 1);
+    }
+    int selfCheck() const
+    {
+        return m_Ring.selfCheck();
+    }
+    Item& front()
+    {
+        return *item(skip(m_Ring.m_Neigh[1], 1));
+    }
+    const Item& front() const
+    {
+        return *item(skip(m_Ring.m_Neigh[1], 1));
+    }
+    Item& back()
+    {
+        return *item(skip(m_Ring.m_Neigh[0], 0));
+    }
+    const Item& back() const
+    {
+        return *item(skip(m_Ring.m_Neigh[0], 0));
+    }
+
+    // Number of ranges the list is cut into.
+    size_t segmentCount() const
+    {
+        return m_MarkerCount + 1;
+    }
+
+    // Places markers exactly every SegmentSize items, O(n).
+    void rebalance()
+    {
+        releaseMarkers();
+        size_t sCount = 0;
+        for (Ring* sRing = m_Ring.m_Neigh[1]; sRing != &m_Ring; sRing = sRing->m_Neigh[1])
+        {
+            if (++sCount == SegmentSize)
+            {
+                sCount = 0;
+                sRing->add(newMarker(), false);
+                sRing = sRing->m_Neigh[1];
+            }
+        }
+        m_FrontCount = 0;
+        m_BackCount = sCount;
+    }
+
+    // Calls aFn for every item of aSegment-th range, aSegment < segmentCount().
+    // Ranges are disjoint and together cover the list.
+    template <class Fn>
+    void forEachInSegment(size_t aSegment, Fn&& aFn)
+    {
+        Ring* sStart = 0 == aSegment ? &m_Ring : &m_Markers[aSegment - 1];
+        for (Ring* sRing = sStart->m_Neigh[1]; sRing != &m_Ring && !isMarker(sRing); )
+        {
+            // The item may remove itself from the list in aFn.
+            Ring* sNext = sRing->m_Neigh[1];
+            aFn(*item(sRing));
+            sRing = sNext;
+        }
+    }
+
+    template <class TItem, class TRing, class TList>
+    class iterator_common
+    {
+    public:
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, TList* aList) : m_Ring(aRing), m_List(aList) {}
+        TItem& operator*() const { return *item(m_Ring); }
+        TItem* operator->() const { return item(m_Ring); }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring; }
+        bool operator!=(const iterator_common& aItr) const { return m_Ring != aItr.m_Ring; }
+        iterator_common& operator++() { m_Ring = m_List->skip(m_Ring->m_Neigh[1], 1); return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { m_Ring = m_List->skip(m_Ring->m_Neigh[0], 0); return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        TRing* m_Ring;
+        TList* m_List;
+    };
+    using iterator = iterator_common<Item, Ring, SegmentedAutoList>;
+    using const_iterator = iterator_common<const Item, const Ring, const SegmentedAutoList>;
+
+    iterator begin() { return iterator(skip(m_Ring.m_Neigh[1], 1), this); }
+    iterator end() { return iterator(&m_Ring, this); }
+    const_iterator begin() const { return const_iterator(skip(m_Ring.m_Neigh[1], 1), this); }
+    const_iterator end() const { return const_iterator(&m_Ring, this); }
+
+private:
+    Ring m_Ring;
+    std::unique_ptr<Ring[]> m_Markers;
+    size_t m_MarkerCapacity = 0;
+    size_t m_MarkerCount = 0;
+    size_t m_FrontCount = 0;
+    size_t m_BackCount = 0;
+
+    // Markers are recognized by address: they all live in one array.
+    bool isMarker(const Ring* aRing) const
+    {
+        return reinterpret_cast<uintptr_t>(aRing) - reinterpret_cast<uintptr_t>(m_Markers.get()) <
+               m_MarkerCapacity * sizeof(Ring);
+    }
+    Ring* skip(Ring* aRing, bool aNext)
+    {
+        while (isMarker(aRing))
+            aRing = aRing->m_Neigh[aNext];
+        return aRing;
+    }
+    const Ring* skip(const Ring* aRing, bool aNext) const
+    {
+        while (isMarker(aRing))
+            aRing = aRing->m_Neigh[aNext];
+        return aRing;
+    }
+
+    // Returns an unused marker, the array grows twice if it's exhausted;
+    // markers in use are moved to the new array in place.
+    Ring* newMarker()
+    {
+        if (m_MarkerCount == m_MarkerCapacity)
+        {
+            size_t sCapacity = 0 == m_MarkerCapacity ? 16 : m_MarkerCapacity * 2;
+            std::unique_ptr<Ring[]> sMarkers(new Ring[sCapacity]);
+            for (size_t i = 0; i < m_MarkerCount; i++)
+            {
+                m_Markers[i].add(&sMarkers[i]);
+                m_Markers[i].remove();
+            }
+            m_Markers = std::move(sMarkers);
+            m_MarkerCapacity = sCapacity;
+        }
+        return &m_Markers[m_MarkerCount++];
+    }
+    void releaseMarkers()
+    {
+        for (size_t i = 0; i < m_MarkerCount; i++)
+            m_Markers[i].remove();
+        m_MarkerCount = 0;
+    }
+
+    static Item* item(Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<Item*>(reinterpret_cast<char*>(aLink) - sOffset);
+    }
+    static const Item* item(const Ring* aLink)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Item*>(0)->*LinkMember));
+        return reinterpret_cast<const Item*>(reinterpret_cast<const char*>(aLink) - sOffset);
+    }
+};
+
+// Calls aFn(Item&) for every item of aList using aThreads threads (including
+// the calling one), every thread takes segments one by one. aFn may modify
+// items and remove the item it's called for, but must not touch other
+// items' links or the list; the list must not be modified concurrently.
+// Threads are created on every call, which costs tens of microseconds per
+// thread; so a thread is added only for every aMinSegmentsPerThread
+// segments, and a list shorter than that is processed by the calling thread.
+template <class List, class Fn>
+void parallelForEach(List& aList, Fn aFn, size_t aThreads, size_t aMinSegmentsPerThread = 4)
+{
+    const size_t sSegments = aList.segmentCount();
+    const size_t sMaxThreads = aMinSegmentsPerThread > 1 ? sSegments / aMinSegmentsPerThread : sSegments;
+    if (aThreads > sMaxThreads)
+        aThreads = sMaxThreads;
+    std::atomic<size_t> sNext(0);
+    auto sWork = [&aList, &aFn, &sNext, sSegments]()
+    {
+        for (size_t i = sNext.fetch_add(1); i < sSegments; i = sNext.fetch_add(1))
+            aList.forEachInSegment(i, aFn);
+    };
+    std::vector<std::thread> sThreads;
+    for (size_t i = 1; i < aThreads; i++)
+        sThreads.emplace_back(sWork);
+    sWork();
+    for (std::thread& sThread : sThreads)
+        sThread.join();
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <SegmentedAutoList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Object
+    {
+        AutoListLink m_Link;
+        uint64_t m_Key;
+        uint64_t m_Value;
+    };
+
+    using PlainList = AutoList<Object, &Object::m_Link>;
+    using SegmentedList = SegmentedAutoList<Object, &Object::m_Link>;
+
+    static size_t SideEffect = 0;
+
+    // Some computation per item, so that the benchmark is not purely
+    // bound by memory bandwidth.
+    inline void work(Object& o)
+    {
+        uint64_t x = o.m_Key;
+        for (int i = 0; i < 8; i++)
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+        o.m_Value += x >> 32;
+    }
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+static void test(size_t aSize)
+{
+    std::cout << "List of " << aSize << " items" << std::endl;
+    std::vector<Object> sObjects(aSize);
+    std::vector<size_t> sOrder(aSize);
+    for (size_t i = 0; i < aSize; i++)
+    {
+        sObjects[i].m_Key = i;
+        sObjects[i].m_Value = 0;
+        sOrder[i] = i;
+    }
+    std::mt19937 sRand(aSize);
+    std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+
+    {
+        PlainList sList;
+        checkpoint("", 0);
+        for (size_t i : sOrder)
+            sList.insertBack(sObjects[i]);
+        checkpoint("AutoList addition", aSize);
+        for (Object& o : sList)
+            work(o);
+        checkpoint("AutoList for each", aSize);
+    }
+
+    SegmentedList sList;
+    checkpoint("", 0);
+    for (size_t i : sOrder)
+        sList.insertBack(sObjects[i]);
+    checkpoint("SegmentedAutoList addition", aSize);
+    for (Object& o : sList)
+        work(o);
+    checkpoint("SegmentedAutoList for each", aSize);
+
+    size_t sMaxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t sThreads = 1; sThreads <= sMaxThreads; sThreads *= 2)
+    {
+        checkpoint("", 0);
+        parallelForEach(sList, work, sThreads);
+        std::cout << sThreads << " threads, ";
+        checkpoint("parallel for each", aSize);
+    }
+
+    for (const Object& o : sObjects)
+        SideEffect += o.m_Value >> 4;
+}
+
+int main()
+{
+    test(1024 * 1024);
+    test(8 * 1024 * 1024);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
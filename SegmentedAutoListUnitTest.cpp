@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <SegmentedAutoList.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    int m_Visits = 0;
+    AutoListLink m_Link;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+using ObjectList = SegmentedAutoList<Object, &Object::m_Link, 4>;
+
+// Every item must be visited by exactly one segment.
+template <class List>
+void checkSegments(List& aList, size_t aSize, const char* funcname, const char *filename, int line)
+{
+    size_t sVisited = 0;
+    for (size_t i = 0; i < aList.segmentCount(); i++)
+        aList.forEachInSegment(i, [&sVisited](Object& o) { ++o.m_Visits; ++sVisited; });
+    check(sVisited, aSize, funcname, filename, line);
+    for (Object& o : aList)
+    {
+        check(o.m_Visits, 1, funcname, filename, line);
+        o.m_Visits = 0;
+    }
+}
+
+#define CHECK_SEGMENTS(...) checkSegments(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+void simple()
+{
+    ANNOUNCE();
+
+    Object sObjects[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ObjectList sList;
+    CHECK(sList, std::vector<int>());
+    CHECK(sList.segmentCount(), size_t(1));
+    CHECK_SEGMENTS(sList, 0);
+
+    for (int i = 4; i >= 0; i--)
+        sList.insertFront(sObjects[i]);
+    for (int i = 5; i < 10; i++)
+        sList.insertBack(sObjects[i]);
+    CHECK(sList, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    CHECK(sList.segmentCount(), size_t(3));
+    CHECK_SEGMENTS(sList, 10);
+
+    sList.removeItem(sObjects[0]);
+    sList.insertAfter(sObjects[9], sObjects[0]);
+    CHECK(sList, {1, 2, 3, 4, 5, 6, 7, 8, 9, 0});
+    sList.removeItem(sObjects[1]);
+    sObjects[9].m_Link.remove();
+    CHECK(sList, {2, 3, 4, 5, 6, 7, 8, 0});
+    CHECK_SEGMENTS(sList, 8);
+
+    // Remove everything around markers, the list must appear empty.
+    for (Object& o : sObjects)
+        o.m_Link.remove();
+    CHECK(sList, std::vector<int>());
+    CHECK_SEGMENTS(sList, 0);
+
+    sList.insertBack(sObjects[3]);
+    CHECK(sList, {3});
+    CHECK_SEGMENTS(sList, 1);
+}
+
+void growth()
+{
+    ANNOUNCE();
+
+    const int COUNT = 1000;
+    std::vector<Object> sObjects(COUNT);
+    std::vector<int> sRef;
+    ObjectList sList;
+    for (int i = 0; i < COUNT; i++)
+    {
+        sObjects[i].m_Data = i;
+        if (i % 2 == 0)
+            sList.insertFront(sObjects[i]);
+        else
+            sList.insertBack(sObjects[i]);
+    }
+    for (int i = COUNT - 2; i >= 0; i -= 2)
+        sRef.push_back(i);
+    for (int i = 1; i < COUNT; i += 2)
+        sRef.push_back(i);
+    CHECK(sList, sRef);
+    CHECK(sList.segmentCount(), size_t(COUNT / 4 + 1));
+    CHECK_SEGMENTS(sList, COUNT);
+
+    // Thin out the list and redistribute markers.
+    std::vector<int> sThin;
+    for (int sData : sRef)
+    {
+        if (sData % 10 == 0)
+            sThin.push_back(sData);
+        else
+            sObjects[sData].m_Link.remove();
+    }
+    CHECK(sList, sThin);
+    CHECK_SEGMENTS(sList, sThin.size());
+    sList.rebalance();
+    CHECK(sList, sThin);
+    CHECK(sList.segmentCount(), size_t(sThin.size() / 4 + 1));
+    CHECK_SEGMENTS(sList, sThin.size());
+
+    ObjectList sMoved(std::move(sList));
+    CHECK(sList, std::vector<int>());
+    CHECK(sMoved, sThin);
+    CHECK_SEGMENTS(sMoved, sThin.size());
+    sList = std::move(sMoved);
+    CHECK(sList, sThin);
+    CHECK(sMoved, std::vector<int>());
+    CHECK_SEGMENTS(sList, sThin.size());
+
+    // insertAfter doesn't create segments, rebalance() does.
+    std::vector<Object> sAfterObjects(20);
+    ObjectList sAfter;
+    sAfter.insertBack(sAfterObjects[0]);
+    for (int i = 1; i < 20; i++)
+        sAfter.insertAfter(sAfterObjects[i - 1], sAfterObjects[i]);
+    CHECK(sAfter.segmentCount(), size_t(1));
+    sAfter.rebalance();
+    CHECK(sAfter.segmentCount(), size_t(20 / 4 + 1));
+    CHECK_SEGMENTS(sAfter, 20);
+}
+
+void parallel()
+{
+    ANNOUNCE();
+
+    const int COUNT = 10000;
+    std::vector<Object> sObjects(COUNT);
+    ObjectList sList;
+    for (int i = 0; i < COUNT; i++)
+    {
+        sObjects[i].m_Data = i;
+        sList.insertBack(sObjects[i]);
+    }
+    for (size_t sThreads = 1; sThreads <= 8; sThreads *= 2)
+    {
+        parallelForEach(sList, [](Object& o) { ++o.m_Visits; }, sThreads);
+        bool sOnce = true;
+        for (Object& o : sObjects)
+        {
+            sOnce = sOnce && o.m_Visits == 1;
+            o.m_Visits = 0;
+        }
+        CHECK(sOnce);
+    }
+
+    // Items are allowed to remove themselves.
+    parallelForEach(sList, [](Object& o) { if (o.m_Data % 2 != 0) o.m_Link.remove(); }, 4);
+    std::vector<int> sRef;
+    for (int i = 0; i < COUNT; i += 2)
+        sRef.push_back(i);
+    CHECK(sList, sRef);
+
+    // A short list is not worth a thread.
+    std::vector<Object> sShortObjects(8);
+    ObjectList sShort;
+    for (Object& o : sShortObjects)
+        sShort.insertBack(o);
+    const std::thread::id sSelf = std::this_thread::get_id();
+    std::atomic<bool> sSerial(true);
+    parallelForEach(sShort, [&sSerial, sSelf](Object& o)
+    {
+        ++o.m_Visits;
+        if (std::this_thread::get_id() != sSelf)
+            sSerial = false;
+    }, 8);
+    CHECK(sSerial.load());
+    bool sOnce = true;
+    for (const Object& o : sShortObjects)
+        sOnce = sOnce && o.m_Visits == 1;
+    CHECK(sOnce);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    growth();
+    parallel();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
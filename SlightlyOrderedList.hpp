@@ -25,9 +25,13 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
 
+#include <ListStats.hpp>
 #include <Ring.hpp>
+#include <RingBatch.hpp>
 
 class SlightlyOrderedListLink
 {
@@ -41,8 +45,11 @@ public:
     Ring m_Ring;
 };
 
-template <class Item, SlightlyOrderedListLink Item::*LinkMember, size_t ItemSize = sizeof(Item)>
-class SlightlyOrderedList
+// Stats is a statistics policy (see ListStats.hpp), stats are kept with
+// the list object and are not transferred by copy or move.
+template <class Item, SlightlyOrderedListLink Item::*LinkMember, size_t ItemSize = sizeof(Item),
+          class Stats = NoListStats>
+class SlightlyOrderedList : private Stats
 {
 public:
     SlightlyOrderedList() : m_Ring(0) {}
@@ -79,16 +86,46 @@ public:
         uintptr_t sAddr = reinterpret_cast<uintptr_t>(&aItem) >> ADDR_SHIFT;
         m_AddrSum += sAddr;
         ++m_Size;
-        m_Ring.add(&((aItem.*LinkMember).m_Ring), sAddr * m_Size > m_AddrSum);
+        bool sBack = sAddr * m_Size > m_AddrSum;
+        Stats::onInsert();
+        if (sBack)
+            Stats::onBack();
+        else
+            Stats::onFront();
+        m_Ring.add(&((aItem.*LinkMember).m_Ring), sBack);
     }
     void remove(Item& aItem)
     {
         uintptr_t sAddr = reinterpret_cast<uintptr_t>(&aItem) >> ADDR_SHIFT;
         m_AddrSum -= sAddr;
         --m_Size;
+        Stats::onRemove();
         (aItem.*LinkMember).m_Ring.remove();
         (aItem.*LinkMember).m_Ring.init();
     }
+    // Removes aCount items at once, faster than one by one if the items are
+    // given in list order (see removeRingBatch).
+    void removeBatch(Item* const* aItems, size_t aCount)
+    {
+        for (size_t i = 0; i < aCount; i++)
+        {
+            m_AddrSum -= reinterpret_cast<uintptr_t>(aItems[i]) >> ADDR_SHIFT;
+            Stats::onRemove();
+        }
+        m_Size -= aCount;
+        removeRingBatch(aItems, aCount, [](Item* aItem) { return &(aItem->*LinkMember).m_Ring; });
+    }
+    // The same as removeBatch, but first sorts aItems by address (see
+    // sortRingBatch), for batches that are collected in random order.
+    void removeBatchSorted(Item** aItems, size_t aCount)
+    {
+        sortRingBatch(aItems, aCount);
+        removeBatch(aItems, aCount);
+    }
+    const Stats& stats() const
+    {
+        return *this;
+    }
     bool empty() const
     {
         return m_Ring.isAlone();
@@ -115,28 +152,35 @@ public:
     }
 
     template <class TItem, class TRing>
-    class iterator_common : std::iterator<std::bidirectional_iterator_tag, TItem>
+    class iterator_common : ListStatsRef<Stats>
     {
     public:
-        explicit iterator_common(TRing* aRing) : m_Ring(aRing) {}
+        // Spelled out instead of deriving std::iterator, deprecated in C++17.
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, const Stats* aStats) : ListStatsRef<Stats>(aStats), m_Ring(aRing) {}
         TItem& operator*() const { return *item(m_Ring); }
         TItem* operator->() const { return item(m_Ring); }
         bool operator==(const iterator_common& aItr) { return m_Ring == aItr.m_Ring; }
         bool operator!=(const iterator_common& aItr) { return m_Ring != aItr.m_Ring; }
-        iterator_common& operator++() { m_Ring = m_Ring->m_Neigh[1]; return *this; }
-        iterator_common operator++(int) { iterator_common aTmp = *this; m_Ring = m_Ring->m_Neigh[1]; return aTmp; }
-        iterator_common& operator--() { m_Ring = m_Ring->m_Neigh[0]; return *this; }
-        iterator_common operator--(int) { iterator_common aTmp = *this; m_Ring = m_Ring->m_Neigh[0]; return aTmp; }
+        iterator_common& operator++() { this->onStep(); m_Ring = m_Ring->m_Neigh[1]; return *this; }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--() { this->onStep(); m_Ring = m_Ring->m_Neigh[0]; return *this; }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
     private:
         TRing* m_Ring;
     };
     using iterator = iterator_common<Item, Ring>;
     using const_iterator = iterator_common<const Item, const Ring>;
 
-    iterator begin() { return iterator(m_Ring.m_Neigh[1]); }
-    iterator end() { return iterator(&m_Ring); }
-    const_iterator begin() const { return const_iterator(m_Ring.m_Neigh[1]); }
-    const_iterator end() const { return const_iterator(&m_Ring); }
+    iterator begin() { return iterator(m_Ring.m_Neigh[1], this); }
+    iterator end() { return iterator(&m_Ring, this); }
+    const_iterator begin() const { return const_iterator(m_Ring.m_Neigh[1], this); }
+    const_iterator end() const { return const_iterator(&m_Ring, this); }
 
 private:
     Ring m_Ring;
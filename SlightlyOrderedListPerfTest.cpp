@@ -1,4 +1,5 @@
 #include <SlightlyOrderedList.hpp>
+#include <HeapScenarios.hpp>
 /*
  * Copyright (c) 2018, Aleksandr Lyapunov
  * All rights reserved.
@@ -170,9 +171,97 @@ static void big_sizes()
     checkpoint("Destruction", SIZE);
 }
 
+template <class Heap>
+static void huge_size(const char* aHeapName)
+{
+    const size_t SIZE = 2 * 1024 * 1024;
+    const size_t COUNT = 4 * 1024 * 1024;
+    std::vector<size_t> sRandom = randomIndexes(COUNT, SIZE);
+    std::cout << "Heap: " << aHeapName << std::endl;
+    checkpoint("", 0);
+
+    {
+        Heap sObjects(SIZE);
+        checkpoint("Construction", SIZE);
+        ObjectList sList;
+
+        for (size_t i = 0; i < SIZE; i++)
+            sList.insert(sObjects[i]);
+        checkpoint("Addition", SIZE);
+
+        for (size_t i : sRandom)
+        {
+            Object& o = sObjects[i];
+            sList.remove(o);
+            sList.insert(o);
+        }
+        checkpoint("Random relink", COUNT);
+
+        for (const Object& o : sList)
+            SideEffect += reinterpret_cast<uintptr_t>(&o) >> 4;
+        checkpoint("Traversal", SIZE);
+
+        for (size_t i = 0; i < SIZE; i++)
+            sList.remove(sObjects[i]);
+        checkpoint("Removing", SIZE);
+
+        // List in random order, a half of it is removed: random items or
+        // two of every four items in list order.
+        std::mt19937 sRand(SIZE);
+        std::vector<Object*> sOrder(SIZE);
+        for (size_t i = 0; i < SIZE; i++)
+            sOrder[i] = &sObjects[i];
+        std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+        std::vector<Object*> sRandomHalf(sOrder.begin(), sOrder.begin() + SIZE / 2);
+        std::shuffle(sRandomHalf.begin(), sRandomHalf.end(), sRand);
+        const char* NAMES[2][3] = {{"Random removing (one by one)", "Random removing (batch)",
+                                    "Random removing (sorted batch)"},
+                                   {"List order removing (one by one)", "List order removing (batch)",
+                                    "List order removing (sorted batch)"}};
+        for (int sListOrder = 0; sListOrder < 2; sListOrder++)
+        {
+            for (int sBatched = 0; sBatched < 3; sBatched++)
+            {
+                for (Object* o : sOrder)
+                    sList.insert(*o);
+                std::vector<Object*> sListOrderHalf;
+                size_t sPos = 0;
+                for (Object& o : sList)
+                    if (sPos++ % 4 < 2)
+                        sListOrderHalf.push_back(&o);
+                std::vector<Object*> sBatch = sListOrder ? sListOrderHalf : sRandomHalf;
+                checkpoint("", 0);
+
+                if (sBatched == 2)
+                    sList.removeBatchSorted(sBatch.data(), sBatch.size());
+                else if (sBatched)
+                    sList.removeBatch(sBatch.data(), sBatch.size());
+                else
+                    for (Object* o : sBatch)
+                        sList.remove(*o);
+                checkpoint(NAMES[sListOrder][sBatched], sBatch.size());
+
+                for (Object* o : sOrder)
+                    if (!o->m_Link.isAlone())
+                        sList.remove(*o);
+                checkpoint("", 0);
+            }
+        }
+    }
+    checkpoint("Destruction", SIZE);
+}
+
+static void huge_sizes()
+{
+    huge_size<MallocHeap<Object>>("malloc");
+    huge_size<PoolHeap<Object>>("pool");
+    huge_size<FragmentedHeap<Object>>("fragmented");
+}
+
 int main()
 {
     small_sizes();
     big_sizes();
+    huge_sizes();
     std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
 }
\ No newline at end of file
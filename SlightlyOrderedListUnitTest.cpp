@@ -281,10 +281,90 @@ static void iterations()
     CHECK(sList, {});
 }
 
+static void batch_removal()
+{
+    ANNOUNCE();
+
+    using CountedList = SlightlyOrderedList<Object, &Object::m_Link, sizeof(Object), ListStats<>>;
+    Object sItems[8];
+    for (size_t i = 0; i < 8; i++)
+        sItems[i] = i;
+
+    CountedList sList;
+    for (size_t i = 0; i < 8; i++)
+        sList.insert(sItems[i]);
+    Object* sBatch[] = {&sItems[5], &sItems[0], &sItems[3], &sItems[4], &sItems[7]};
+    sList.removeBatch(sBatch, 5);
+    CHECK(sList.stats().removes(), size_t(5));
+    CHECK(sItems[4].m_Link.isAlone());
+    CHECK(sList.front().m_Data, 1);
+    CHECK(sList.back().m_Data, 6);
+    size_t sSum = 0;
+    for (const Object& sObj : sList)
+        sSum += sObj.m_Data;
+    CHECK(sSum, size_t(1 + 2 + 6));
+
+    // Address sum and size must be consistent: the list behaves as new.
+    // The sorted variant reorders the batch by address.
+    Object* sRest[] = {&sItems[6], &sItems[1], &sItems[2]};
+    sList.removeBatchSorted(sRest, 3);
+    CHECK(sList.empty());
+    CHECK(sRest[0] == &sItems[1] && sRest[1] == &sItems[2] && sRest[2] == &sItems[6]);
+    for (size_t i = 8; i > 0; i--)
+        sList.insert(sItems[i - 1]);
+    CHECK(sList.stats().fronts(), size_t(1 + 8));
+    CHECK(sList.front().m_Data, 0);
+    CHECK(sList.back().m_Data, 7);
+    for (size_t i = 0; i < 8; i++)
+        sList.remove(sItems[i]);
+}
+
+static void stats()
+{
+    ANNOUNCE();
+
+    static_assert(sizeof(ObjectList) == sizeof(Ring) + sizeof(uintptr_t) + sizeof(size_t),
+                  "Disabled stats must cost nothing");
+    static_assert(sizeof(ObjectList::iterator) == sizeof(Ring*), "Disabled stats must cost nothing");
+
+    using CountedList = SlightlyOrderedList<Object, &Object::m_Link, sizeof(Object), ListStats<>>;
+    Object sItems[5];
+    for (size_t i = 0; i < 5; i++)
+        sItems[i] = i;
+
+    CountedList sList;
+    for (size_t i = 0; i < 5; i++)
+        sList.insert(sItems[i]);
+    CHECK(sList.stats().inserts(), size_t(5));
+    CHECK(sList.stats().fronts(), size_t(1));
+    CHECK(sList.stats().backs(), size_t(4));
+
+    size_t sSum = 0;
+    for (const Object& sObj : sList)
+        sSum += sObj.m_Data;
+    CHECK(sSum, size_t(10));
+    CHECK(sList.stats().steps(), size_t(5));
+
+    for (size_t i = 0; i < 5; i++)
+        sList.remove(sItems[i]);
+    CHECK(sList.stats().removes(), size_t(5));
+    CHECK(sList.empty());
+
+    sList.stats().reset();
+    for (size_t i = 5; i > 0; i--)
+        sList.insert(sItems[i - 1]);
+    CHECK(sList.stats().fronts(), size_t(5));
+    CHECK(sList.stats().backs(), size_t(0));
+    for (size_t i = 0; i < 5; i++)
+        sList.remove(sItems[i]);
+}
+
 int main()
 {
     simple();
     iterations();
+    batch_removal();
+    stats();
 
     if (rc == 0)
         std::cout << "Success" << std::endl;
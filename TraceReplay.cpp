@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <SlightlyOrderedList.hpp>
+#include <OperationTrace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Replays an operation trace (see OperationTrace.hpp) over different lists.
+// Usage:
+//   TraceReplay <trace> [autolist|ordered|stdlist|all]
+//   TraceReplay generate <trace> [objects] [operations] [lists]
+
+namespace
+{
+
+size_t SideEffect = 0;
+
+// Hardware cache counters of this thread, if the kernel lets us read them.
+class CacheCounters
+{
+public:
+    CacheCounters()
+    {
+#ifdef __linux__
+        m_Fd[0] = open(PERF_COUNT_HW_CACHE_REFERENCES);
+        m_Fd[1] = open(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+    ~CacheCounters()
+    {
+#ifdef __linux__
+        for (int sFd : m_Fd)
+            if (sFd >= 0)
+                close(sFd);
+#endif
+    }
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+
+    bool available() const
+    {
+        return m_Fd[0] >= 0 && m_Fd[1] >= 0;
+    }
+    void start()
+    {
+#ifdef __linux__
+        for (int sFd : m_Fd)
+        {
+            if (sFd < 0)
+                continue;
+            ioctl(sFd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(sFd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    // Stops counting and returns {references, misses}.
+    void stop(uint64_t& aReferences, uint64_t& aMisses)
+    {
+        aReferences = read(m_Fd[0]);
+        aMisses = read(m_Fd[1]);
+    }
+
+private:
+    int m_Fd[2] = {-1, -1};
+
+#ifdef __linux__
+    static int open(uint64_t aConfig)
+    {
+        perf_event_attr sAttr;
+        memset(&sAttr, 0, sizeof(sAttr));
+        sAttr.size = sizeof(sAttr);
+        sAttr.type = PERF_TYPE_HARDWARE;
+        sAttr.config = aConfig;
+        sAttr.disabled = 1;
+        sAttr.exclude_kernel = 1;
+        sAttr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &sAttr, 0, -1, -1, 0));
+    }
+#endif
+    static uint64_t read(int aFd)
+    {
+        uint64_t sRes = 0;
+#ifdef __linux__
+        if (aFd < 0)
+            return 0;
+        ioctl(aFd, PERF_EVENT_IOC_DISABLE, 0);
+        if (sizeof(sRes) != ::read(aFd, &sRes, sizeof(sRes)))
+            sRes = 0;
+#else
+        (void)aFd;
+#endif
+        return sRes;
+    }
+};
+
+// Replayers apply an operation if it is valid for the current state
+// (e.g. an insert of an unlinked object) and return false otherwise. A copy
+// or a move of an object to itself is never valid.
+
+struct AutoListReplay
+{
+    struct Item
+    {
+        AutoListLink m_Link;
+        uint64_t m_Value;
+    };
+    using List = AutoList<Item, &Item::m_Link>;
+
+    std::vector<Item> m_Items;
+    std::vector<List> m_Lists;
+
+    AutoListReplay(uint64_t aObjectCount, uint32_t aListCount) : m_Items(aObjectCount), m_Lists(aListCount)
+    {
+        for (size_t i = 0; i < m_Items.size(); i++)
+            m_Items[i].m_Value = i;
+    }
+
+    bool apply(const TraceRecord& aRec)
+    {
+        List& sList = m_Lists[aRec.m_List];
+        Item& sItem = m_Items[aRec.m_Id];
+        switch (aRec.m_Op)
+        {
+            case TRACE_INSERT_FRONT:
+                if (!sItem.m_Link.isAlone())
+                    return false;
+                sList.insertFront(sItem);
+                return true;
+            case TRACE_INSERT_BACK:
+                if (!sItem.m_Link.isAlone())
+                    return false;
+                sList.insertBack(sItem);
+                return true;
+            case TRACE_REMOVE:
+                sList.removeItem(sItem);
+                return true;
+            case TRACE_RELINK_FRONT:
+                sList.removeItem(sItem);
+                sList.insertFront(sItem);
+                return true;
+            case TRACE_RELINK_BACK:
+                sList.removeItem(sItem);
+                sList.insertBack(sItem);
+                return true;
+            case TRACE_COPY:
+                if (aRec.m_Id == aRec.m_Id2)
+                    return false;
+                m_Items[aRec.m_Id2] = sItem;
+                return true;
+            case TRACE_MOVE:
+                if (aRec.m_Id == aRec.m_Id2)
+                    return false;
+                m_Items[aRec.m_Id2].m_Link.remove();
+                m_Items[aRec.m_Id2] = std::move(sItem);
+                return true;
+            case TRACE_TRAVERSE:
+                for (const Item& sCur : sList)
+                    SideEffect += sCur.m_Value;
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+struct SlightlyOrderedListReplay
+{
+    struct Item
+    {
+        SlightlyOrderedListLink m_Link;
+        uint32_t m_List;
+        uint64_t m_Value;
+    };
+    using List = SlightlyOrderedList<Item, &Item::m_Link>;
+
+    std::vector<Item> m_Items;
+    std::vector<List> m_Lists;
+
+    SlightlyOrderedListReplay(uint64_t aObjectCount, uint32_t aListCount) : m_Items(aObjectCount), m_Lists(aListCount)
+    {
+        for (size_t i = 0; i < m_Items.size(); i++)
+            m_Items[i].m_Value = i;
+    }
+
+    void insert(Item& aItem, uint32_t aList)
+    {
+        aItem.m_List = aList;
+        m_Lists[aList].insert(aItem);
+    }
+    void remove(Item& aItem)
+    {
+        if (!aItem.m_Link.isAlone())
+            m_Lists[aItem.m_List].remove(aItem);
+    }
+
+    bool apply(const TraceRecord& aRec)
+    {
+        Item& sItem = m_Items[aRec.m_Id];
+        switch (aRec.m_Op)
+        {
+            case TRACE_INSERT_FRONT:
+            case TRACE_INSERT_BACK:
+                if (!sItem.m_Link.isAlone())
+                    return false;
+                insert(sItem, aRec.m_List);
+                return true;
+            case TRACE_REMOVE:
+                remove(sItem);
+                return true;
+            case TRACE_RELINK_FRONT:
+            case TRACE_RELINK_BACK:
+                remove(sItem);
+                insert(sItem, aRec.m_List);
+                return true;
+            case TRACE_COPY:
+                if (aRec.m_Id == aRec.m_Id2)
+                    return false;
+                remove(m_Items[aRec.m_Id2]);
+                m_Items[aRec.m_Id2].m_Value = sItem.m_Value;
+                if (!sItem.m_Link.isAlone())
+                    insert(m_Items[aRec.m_Id2], sItem.m_List);
+                return true;
+            case TRACE_MOVE:
+                if (aRec.m_Id == aRec.m_Id2)
+                    return false;
+                remove(m_Items[aRec.m_Id2]);
+                m_Items[aRec.m_Id2].m_Value = sItem.m_Value;
+                if (!sItem.m_Link.isAlone())
+                {
+                    remove(sItem);
+                    insert(m_Items[aRec.m_Id2], sItem.m_List);
+                }
+                return true;
+            case TRACE_TRAVERSE:
+                for (const Item& sCur : m_Lists[aRec.m_List])
+                    SideEffect += sCur.m_Value;
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+struct StdListReplay
+{
+    struct Item
+    {
+        std::list<Item*>::iterator m_Pos;
+        std::list<Item*>* m_List = nullptr;
+        uint64_t m_Value;
+    };
+    using List = std::list<Item*>;
+
+    std::vector<Item> m_Items;
+    std::vector<List> m_Lists;
+
+    StdListReplay(uint64_t aObjectCount, uint32_t aListCount) : m_Items(aObjectCount), m_Lists(aListCount)
+    {
+        for (size_t i = 0; i < m_Items.size(); i++)
+            m_Items[i].m_Value = i;
+    }
+
+    void insert(Item& aItem, List& aList, List::iterator aPos)
+    {
+        aItem.m_List = &aList;
+        aItem.m_Pos = aList.insert(aPos, &aItem);
+    }
+    void remove(Item& aItem)
+    {
+        if (nullptr == aItem.m_List)
+            return;
+        aItem.m_List->erase(aItem.m_Pos);
+        aItem.m_List = nullptr;
+    }
+
+    bool apply(const TraceRecord& aRec)
+    {
+        List& sList = m_Lists[aRec.m_List];
+        Item& sItem = m_Items[aRec.m_Id];
+        switch (aRec.m_Op)
+        {
+            case TRACE_INSERT_FRONT:
+            case TRACE_INSERT_BACK:
+                if (nullptr != sItem.m_List)
+                    return false;
+                insert(sItem, sList, aRec.m_Op == TRACE_INSERT_FRONT ? sList.begin() : sList.end());
+                return true;
+            case TRACE_REMOVE:
+                remove(sItem);
+                return true;
+            case TRACE_RELINK_FRONT:
+            case TRACE_RELINK_BACK:
+                if (nullptr == sItem.m_List)
+                {
+                    insert(sItem, sList, aRec.m_Op == TRACE_RELINK_FRONT ? sList.begin() : sList.end());
+                    return true;
+                }
+                sList.splice(aRec.m_Op == TRACE_RELINK_FRONT ? sList.begin() : sList.end(), *sItem.m_List, sItem.m_Pos);
+                sItem.m_List = &sList;
+                return true;
+            case TRACE_COPY:
+                if (aRec.m_Id == aRec.m_Id2)
+                    return false;
+                remove(m_Items[aRec.m_Id2]);
+                m_Items[aRec.m_Id2].m_Value = sItem.m_Value;
+                if (nullptr != sItem.m_List)
+                    insert(m_Items[aRec.m_Id2], *sItem.m_List, std::next(sItem.m_Pos));
+                return true;
+            case TRACE_MOVE:
+                if (aRec.m_Id == aRec.m_Id2)
+                    return false;
+                remove(m_Items[aRec.m_Id2]);
+                m_Items[aRec.m_Id2].m_Value = sItem.m_Value;
+                if (nullptr != sItem.m_List)
+                {
+                    m_Items[aRec.m_Id2].m_List = sItem.m_List;
+                    m_Items[aRec.m_Id2].m_Pos = sItem.m_Pos;
+                    *sItem.m_Pos = &m_Items[aRec.m_Id2];
+                    sItem.m_List = nullptr;
+                }
+                return true;
+            case TRACE_TRAVERSE:
+                for (const Item* sCur : sList)
+                    SideEffect += sCur->m_Value;
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+template <class Replay>
+void replay(const char* aName, const TraceHeader& aHeader, const std::vector<TraceRecord>& aRecords)
+{
+    Replay sReplay(aHeader.m_ObjectCount, aHeader.m_ListCount);
+    CacheCounters sCounters;
+    size_t sSkipped = 0;
+
+    using namespace std::chrono;
+    high_resolution_clock::time_point sWas = high_resolution_clock::now();
+    sCounters.start();
+    for (const TraceRecord& sRecord : aRecords)
+        sSkipped += !sReplay.apply(sRecord);
+    uint64_t sReferences, sMisses;
+    sCounters.stop(sReferences, sMisses);
+    duration<double> sSpan = duration_cast<duration<double>>(high_resolution_clock::now() - sWas);
+
+    std::cout << std::left << std::setw(18) << aName << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << aRecords.size() / 1000000. / sSpan.count();
+    if (sCounters.available())
+        std::cout << std::setw(16) << std::setprecision(3) << double(sReferences) / aRecords.size()
+                  << std::setw(16) << double(sMisses) / aRecords.size();
+    else
+        std::cout << std::setw(16) << "n/a" << std::setw(16) << "n/a";
+    std::cout << std::setw(12) << sSkipped << std::endl;
+}
+
+int generate(const char* aPath, uint64_t aObjects, uint64_t aOperations, uint32_t aLists)
+{
+    TraceWriter sWriter;
+    if (!sWriter.open(aPath))
+    {
+        std::cerr << "Can't create " << aPath << std::endl;
+        return 1;
+    }
+    std::mt19937_64 sRand(aObjects);
+    // Object i belongs to list i % aLists, hot objects are the lower ids.
+    for (uint64_t i = 0; i < aObjects; i++)
+        sWriter.insertFront(i, i % aLists);
+    for (uint64_t i = 0; i < aOperations; i++)
+    {
+        uint64_t sId = sRand() % aObjects;
+        if (sRand() % 4 != 0)
+            sId %= aObjects / 16 + 1;
+        uint32_t sList = sId % aLists;
+        unsigned sDice = sRand() % 1000;
+        if (sDice < 600)
+            sWriter.relinkFront(sId, sList);
+        else if (sDice < 800)
+            sWriter.relinkBack(sId, sList);
+        else if (sDice < 999)
+        {
+            sWriter.remove(sId, sList);
+            sWriter.insertBack(sId, sList);
+        }
+        else if (0 == sRand() % 100)
+            sWriter.traverse(sList);
+    }
+    if (!sWriter.close())
+    {
+        std::cerr << "Can't write " << aPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    if (argc >= 3 && 0 == strcmp(argv[1], "generate"))
+    {
+        uint64_t sObjects = argc > 3 ? std::stoull(argv[3]) : 1024 * 1024;
+        uint64_t sOperations = argc > 4 ? std::stoull(argv[4]) : 16 * 1024 * 1024;
+        uint32_t sLists = argc > 5 ? std::stoul(argv[5]) : 1;
+        if (0 == sObjects || 0 == sLists)
+        {
+            std::cerr << "Objects and lists must be positive" << std::endl;
+            return 1;
+        }
+        return generate(argv[2], sObjects, sOperations, sLists);
+    }
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <trace> [autolist|ordered|stdlist|all]" << std::endl;
+        std::cerr << "       " << argv[0] << " generate <trace> [objects] [operations] [lists]" << std::endl;
+        return 1;
+    }
+
+    TraceReader sReader;
+    if (!sReader.open(argv[1]))
+    {
+        std::cerr << "Can't read trace " << argv[1] << std::endl;
+        return 1;
+    }
+    // The header counts are checked against the records before they size
+    // any allocation: a record takes a byte at least, and the object and
+    // list counts are exactly the ones the records use.
+    const TraceHeader& sHeader = sReader.header();
+    std::vector<TraceRecord> sRecords;
+    sRecords.reserve(std::min<uint64_t>(sHeader.m_RecordCount, sReader.dataSize()));
+    uint64_t sObjectsUsed = 0;
+    uint32_t sListsUsed = 0;
+    TraceRecord sRecord;
+    while (sReader.next(sRecord))
+    {
+        if (sRecord.m_List >= sHeader.m_ListCount ||
+            sRecord.m_Id >= sHeader.m_ObjectCount ||
+            sRecord.m_Id2 >= sHeader.m_ObjectCount)
+            break;
+        sRecords.push_back(sRecord);
+        sListsUsed = std::max(sListsUsed, sRecord.m_List + 1);
+        if (sRecord.m_Op != TRACE_TRAVERSE)
+            sObjectsUsed = std::max(sObjectsUsed, std::max(sRecord.m_Id, sRecord.m_Id2) + 1);
+    }
+    if (sRecords.size() != sHeader.m_RecordCount ||
+        sHeader.m_ObjectCount > sObjectsUsed || sHeader.m_ListCount > sListsUsed)
+    {
+        std::cerr << "Broken trace " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::string sWhat = argc > 2 ? argv[2] : "all";
+    std::cout << "Records: " << sRecords.size() << ", objects: " << sReader.header().m_ObjectCount
+              << ", lists: " << sReader.header().m_ListCount << std::endl;
+    std::cout << std::left << std::setw(18) << "List" << std::right << std::setw(12) << "Mrps"
+              << std::setw(16) << "Cache refs/op" << std::setw(16) << "Cache miss/op" << std::setw(12) << "Skipped" << std::endl;
+    if (sWhat == "autolist" || sWhat == "all")
+        replay<AutoListReplay>("AutoList", sReader.header(), sRecords);
+    if (sWhat == "ordered" || sWhat == "all")
+        replay<SlightlyOrderedListReplay>("SlightlyOrdered", sReader.header(), sRecords);
+    if (sWhat == "stdlist" || sWhat == "all")
+        replay<StdListReplay>("list<Item*>", sReader.header(), sRecords);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+    return 0;
+}
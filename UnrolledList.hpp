@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include <Ring.hpp>
+
+// Unrolled intrusive list: item pointers are stored in chunks of ChunkSize
+// entries, the chunks are linked by Ring. A traversal loads one chunk per
+// ChunkSize items instead of one link per item, and the loads of the items
+// don't depend on each other, so they are not serialized by pointer chasing.
+//
+// Removal and insertAfter are O(ChunkSize), not O(1) as in AutoList: every
+// item keeps a back reference to its chunk in its UnrolledListLink, the item
+// is searched for in the chunk and the tail of the chunk is shifted to keep
+// the order. The position in the chunk is not kept: shifting would have to
+// update it in every moved item, a cache miss each. A full chunk is split in
+// halves on insertion, a chunk less than half full after removal is merged
+// with a neighbour if they fit in one chunk, so chunks stay about half full
+// at least.
+//
+// ChunkSize of 8..32 is the useful range (see UnrolledListPerf): smaller
+// chunks lose the unrolling, larger ones make removal slow. 4 is the least
+// size that split and merge work with, it's allowed for tests.
+//
+// Unlike AutoListLink, the link doesn't unlink itself: an item must be
+// removed before it's destroyed. Copying a link gives an unlinked one.
+
+class UnrolledListLink
+{
+public:
+    UnrolledListLink() = default;
+    UnrolledListLink(const UnrolledListLink&) {}
+    UnrolledListLink& operator=(const UnrolledListLink&) { return *this; }
+
+    bool isLinked() const
+    {
+        return nullptr != m_Chunk;
+    }
+
+private:
+    template <class Item, UnrolledListLink Item::*LinkMember, size_t ChunkSize>
+    friend class UnrolledList;
+    void* m_Chunk = nullptr;
+};
+
+template <class Item, UnrolledListLink Item::*LinkMember, size_t ChunkSize = 16>
+class UnrolledList
+{
+    static_assert(ChunkSize >= 4 && ChunkSize <= 32, "Chunks are split in halves and merged, and searched linearly");
+
+public:
+    UnrolledList() : m_Ring(0) {}
+    ~UnrolledList()
+    {
+        clear();
+        delete m_Spare;
+    }
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+
+    bool empty() const
+    {
+        return 0 == m_Size;
+    }
+    size_t size() const
+    {
+        return m_Size;
+    }
+    size_t chunkCount() const
+    {
+        return m_ChunkCount;
+    }
+
+    Item& front()
+    {
+        return *chunk(m_Ring.m_Neigh[1])->m_Items[0];
+    }
+    const Item& front() const
+    {
+        return *chunk(m_Ring.m_Neigh[1])->m_Items[0];
+    }
+    Item& back()
+    {
+        Chunk* sChunk = chunk(m_Ring.m_Neigh[0]);
+        return *sChunk->m_Items[sChunk->m_Count - 1];
+    }
+    const Item& back() const
+    {
+        const Chunk* sChunk = chunk(m_Ring.m_Neigh[0]);
+        return *sChunk->m_Items[sChunk->m_Count - 1];
+    }
+
+    void insertBack(Item& aItem)
+    {
+        Chunk* sChunk = m_Ring.isAlone() ? nullptr : chunk(m_Ring.m_Neigh[0]);
+        if (nullptr == sChunk || ChunkSize == sChunk->m_Count)
+            sChunk = newChunk(&m_Ring, true);
+        put(sChunk, sChunk->m_Count, aItem);
+    }
+    void insertFront(Item& aItem)
+    {
+        Chunk* sChunk = m_Ring.isAlone() ? nullptr : chunk(m_Ring.m_Neigh[1]);
+        if (nullptr == sChunk || ChunkSize == sChunk->m_Count)
+            sChunk = newChunk(&m_Ring, false);
+        put(sChunk, 0, aItem);
+    }
+    // Inserts aItem right after aPos, that must be in the list.
+    void insertAfter(Item& aPos, Item& aItem)
+    {
+        UnrolledListLink& sLink = aPos.*LinkMember;
+        Chunk* sChunk = static_cast<Chunk*>(sLink.m_Chunk);
+        size_t sIndex = sChunk->find(aPos) + 1;
+        if (ChunkSize == sChunk->m_Count)
+        {
+            Chunk* sNext = split(sChunk);
+            if (sIndex > sChunk->m_Count)
+            {
+                sIndex -= sChunk->m_Count;
+                sChunk = sNext;
+            }
+        }
+        put(sChunk, sIndex, aItem);
+    }
+    void removeItem(Item& aItem)
+    {
+        UnrolledListLink& sLink = aItem.*LinkMember;
+        Chunk* sChunk = static_cast<Chunk*>(sLink.m_Chunk);
+        size_t sCount = --sChunk->m_Count;
+        for (size_t i = sChunk->find(aItem); i < sCount; i++)
+            sChunk->m_Items[i] = sChunk->m_Items[i + 1];
+        sLink.m_Chunk = nullptr;
+        --m_Size;
+        compact(sChunk);
+    }
+    bool contains(const Item& aItem) const
+    {
+        const UnrolledListLink& sLink = aItem.*LinkMember;
+        return sLink.isLinked() && static_cast<const Chunk*>(sLink.m_Chunk)->m_List == this;
+    }
+    void clear()
+    {
+        while (!m_Ring.isAlone())
+        {
+            Chunk* sChunk = chunk(m_Ring.m_Neigh[1]);
+            for (size_t i = 0; i < sChunk->m_Count; i++)
+                (sChunk->m_Items[i]->*LinkMember).m_Chunk = nullptr;
+            sChunk->m_Count = 0;
+            freeChunk(sChunk);
+        }
+        m_Size = 0;
+    }
+
+    // Calls aFunc for every item, a tight loop over chunks.
+    template <class Func>
+    void forEach(Func&& aFunc) const
+    {
+        for (const Ring* sRing = m_Ring.m_Neigh[1]; sRing != &m_Ring; sRing = sRing->m_Neigh[1])
+        {
+            const Chunk* sChunk = chunk(sRing);
+            for (size_t i = 0; i < sChunk->m_Count; i++)
+                aFunc(*sChunk->m_Items[i]);
+        }
+    }
+
+    int selfCheck() const
+    {
+        if (m_Ring.selfCheck() != 0)
+            return 1;
+        size_t sSize = 0;
+        size_t sChunks = 0;
+        for (const Ring* sRing = m_Ring.m_Neigh[1]; sRing != &m_Ring; sRing = sRing->m_Neigh[1])
+        {
+            const Chunk* sChunk = chunk(sRing);
+            if (0 == sChunk->m_Count || sChunk->m_Count > ChunkSize || sChunk->m_List != this)
+                return 2;
+            for (size_t i = 0; i < sChunk->m_Count; i++)
+                if ((sChunk->m_Items[i]->*LinkMember).m_Chunk != sChunk)
+                    return 3;
+            sSize += sChunk->m_Count;
+            ++sChunks;
+        }
+        if (sSize != m_Size || sChunks != m_ChunkCount)
+            return 4;
+        return 0;
+    }
+
+private:
+    struct Chunk
+    {
+        // Must be the first member, see chunk().
+        Ring m_Ring;
+        const UnrolledList* m_List;
+        size_t m_Count = 0;
+        Item* m_Items[ChunkSize];
+        explicit Chunk(const UnrolledList* aList) : m_Ring(0), m_List(aList) {}
+
+        size_t find(const Item& aItem) const
+        {
+            size_t i = 0;
+            while (m_Items[i] != &aItem)
+                ++i;
+            return i;
+        }
+    };
+
+    static Chunk* chunk(Ring* aRing)
+    {
+        return reinterpret_cast<Chunk*>(aRing);
+    }
+    static const Chunk* chunk(const Ring* aRing)
+    {
+        return reinterpret_cast<const Chunk*>(aRing);
+    }
+
+    template <class TItem, class TRing>
+    class iterator_common
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename std::remove_const<TItem>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TItem*;
+        using reference = TItem&;
+
+        iterator_common(TRing* aRing, size_t aIndex) : m_Ring(aRing), m_Index(aIndex) {}
+        TItem& operator*() const { return *chunk(m_Ring)->m_Items[m_Index]; }
+        TItem* operator->() const { return chunk(m_Ring)->m_Items[m_Index]; }
+        bool operator==(const iterator_common& aItr) const { return m_Ring == aItr.m_Ring && m_Index == aItr.m_Index; }
+        bool operator!=(const iterator_common& aItr) const { return !(*this == aItr); }
+        iterator_common& operator++()
+        {
+            if (++m_Index == chunk(m_Ring)->m_Count)
+            {
+                m_Ring = m_Ring->m_Neigh[1];
+                m_Index = 0;
+            }
+            return *this;
+        }
+        iterator_common operator++(int) { iterator_common aTmp = *this; ++*this; return aTmp; }
+        iterator_common& operator--()
+        {
+            if (0 == m_Index)
+            {
+                m_Ring = m_Ring->m_Neigh[0];
+                m_Index = chunk(m_Ring)->m_Count;
+            }
+            --m_Index;
+            return *this;
+        }
+        iterator_common operator--(int) { iterator_common aTmp = *this; --*this; return aTmp; }
+    private:
+        // The end is the list's own ring with index 0.
+        TRing* m_Ring;
+        size_t m_Index;
+    };
+
+public:
+    using iterator = iterator_common<Item, Ring>;
+    using const_iterator = iterator_common<const Item, const Ring>;
+
+    iterator begin() { return iterator(m_Ring.m_Neigh[1], 0); }
+    iterator end() { return iterator(&m_Ring, 0); }
+    const_iterator begin() const { return const_iterator(m_Ring.m_Neigh[1], 0); }
+    const_iterator end() const { return const_iterator(&m_Ring, 0); }
+
+private:
+    Ring m_Ring;
+    size_t m_Size = 0;
+    size_t m_ChunkCount = 0;
+    // One free chunk is kept to avoid allocation churn at chunk boundaries.
+    Chunk* m_Spare = nullptr;
+
+    // New empty chunk after aRing (or before if aBefore).
+    Chunk* newChunk(Ring* aRing, bool aBefore)
+    {
+        Chunk* sChunk = m_Spare;
+        if (nullptr == sChunk)
+            sChunk = new Chunk(this);
+        m_Spare = nullptr;
+        aRing->add(&sChunk->m_Ring, aBefore);
+        ++m_ChunkCount;
+        return sChunk;
+    }
+    void freeChunk(Chunk* aChunk)
+    {
+        assert(0 == aChunk->m_Count);
+        aChunk->m_Ring.remove();
+        aChunk->m_Ring.init();
+        --m_ChunkCount;
+        if (nullptr == m_Spare)
+            m_Spare = aChunk;
+        else
+            delete aChunk;
+    }
+
+    void put(Chunk* aChunk, size_t aIndex, Item& aItem)
+    {
+        assert(aChunk->m_Count < ChunkSize);
+        for (size_t i = aChunk->m_Count; i > aIndex; i--)
+            aChunk->m_Items[i] = aChunk->m_Items[i - 1];
+        aChunk->m_Items[aIndex] = &aItem;
+        (aItem.*LinkMember).m_Chunk = aChunk;
+        ++aChunk->m_Count;
+        ++m_Size;
+    }
+    // Moves aCount items from the start of aFrom to the end of aTo.
+    static void move(Chunk* aFrom, size_t aFirst, size_t aCount, Chunk* aTo)
+    {
+        for (size_t i = 0; i < aCount; i++)
+        {
+            Item* sItem = aFrom->m_Items[aFirst + i];
+            aTo->m_Items[aTo->m_Count++] = sItem;
+            (sItem->*LinkMember).m_Chunk = aTo;
+        }
+    }
+    // Moves the second half of a full chunk to a new chunk after it.
+    Chunk* split(Chunk* aChunk)
+    {
+        Chunk* sNext = newChunk(&aChunk->m_Ring, false);
+        size_t sKeep = ChunkSize / 2;
+        move(aChunk, sKeep, aChunk->m_Count - sKeep, sNext);
+        aChunk->m_Count = sKeep;
+        return sNext;
+    }
+    void compact(Chunk* aChunk)
+    {
+        if (0 == aChunk->m_Count)
+        {
+            freeChunk(aChunk);
+            return;
+        }
+        if (aChunk->m_Count >= ChunkSize / 2)
+            return;
+        Ring* sNextRing = aChunk->m_Ring.m_Neigh[1];
+        if (sNextRing != &m_Ring && aChunk->m_Count + chunk(sNextRing)->m_Count <= ChunkSize)
+        {
+            Chunk* sNext = chunk(sNextRing);
+            move(sNext, 0, sNext->m_Count, aChunk);
+            sNext->m_Count = 0;
+            freeChunk(sNext);
+            return;
+        }
+        Ring* sPrevRing = aChunk->m_Ring.m_Neigh[0];
+        if (sPrevRing != &m_Ring && aChunk->m_Count + chunk(sPrevRing)->m_Count <= ChunkSize)
+        {
+            move(aChunk, 0, aChunk->m_Count, chunk(sPrevRing));
+            aChunk->m_Count = 0;
+            freeChunk(aChunk);
+        }
+    }
+};
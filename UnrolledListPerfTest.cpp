@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <AutoList.hpp>
+#include <UnrolledList.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t ITEM_SIZE = 128;
+
+    struct AutoObject
+    {
+        AutoListLink m_Link;
+        uint32_t m_Key;
+        char m_Cold[ITEM_SIZE - sizeof(AutoListLink) - sizeof(uint32_t)];
+    };
+
+    struct UnrolledObject
+    {
+        UnrolledListLink m_Link;
+        uint32_t m_Key;
+        char m_Cold[ITEM_SIZE - sizeof(UnrolledListLink) - sizeof(uint32_t)];
+    };
+
+    using AutoObjectList = AutoList<AutoObject, &AutoObject::m_Link>;
+    template <size_t ChunkSize>
+    using UnrolledObjectList = UnrolledList<UnrolledObject, &UnrolledObject::m_Link, ChunkSize>;
+
+    static size_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+struct Scenario
+{
+    size_t m_Size;
+    std::vector<uint32_t> m_Order;
+    std::vector<uint32_t> m_Random;
+
+    explicit Scenario(size_t aSize) : m_Size(aSize), m_Order(aSize), m_Random(1024 * 1024)
+    {
+        for (size_t i = 0; i < aSize; i++)
+            m_Order[i] = i;
+        std::mt19937 sRand(aSize);
+        std::shuffle(m_Order.begin(), m_Order.end(), sRand);
+        for (uint32_t& sIndex : m_Random)
+            sIndex = sRand() % aSize;
+    }
+};
+
+static void autoList(const Scenario& aScenario)
+{
+    std::cout << "AutoList, " << aScenario.m_Size << " items of " << sizeof(AutoObject) << " bytes" << std::endl;
+    std::vector<AutoObject> sObjects(aScenario.m_Size);
+    for (size_t i = 0; i < aScenario.m_Size; i++)
+        sObjects[i].m_Key = i;
+    AutoObjectList sList;
+    checkpoint("", 0);
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.insertBack(sObjects[i]);
+    checkpoint("Addition", aScenario.m_Size);
+
+    for (auto sItr = sList.begin(); sItr != sList.end(); ++sItr)
+        ++SideEffect;
+    checkpoint("Traversal (links only)", aScenario.m_Size);
+
+    for (const AutoObject& o : sList)
+        SideEffect += o.m_Key;
+    checkpoint("Traversal (one field)", aScenario.m_Size);
+
+    for (uint32_t i : aScenario.m_Random)
+    {
+        sList.removeItem(sObjects[i]);
+        sList.insertFront(sObjects[i]);
+    }
+    checkpoint("Random relink", aScenario.m_Random.size());
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.removeItem(sObjects[i]);
+    checkpoint("Removing", aScenario.m_Size);
+}
+
+template <size_t ChunkSize>
+static void unrolled(const Scenario& aScenario)
+{
+    std::cout << "UnrolledList<" << ChunkSize << ">, " << aScenario.m_Size << " items of " << sizeof(UnrolledObject) << " bytes" << std::endl;
+    std::vector<UnrolledObject> sObjects(aScenario.m_Size);
+    for (size_t i = 0; i < aScenario.m_Size; i++)
+        sObjects[i].m_Key = i;
+    UnrolledObjectList<ChunkSize> sList;
+    checkpoint("", 0);
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.insertBack(sObjects[i]);
+    checkpoint("Addition", aScenario.m_Size);
+
+    for (auto sItr = sList.begin(); sItr != sList.end(); ++sItr)
+        ++SideEffect;
+    checkpoint("Traversal (links only)", aScenario.m_Size);
+
+    for (const UnrolledObject& o : sList)
+        SideEffect += o.m_Key;
+    checkpoint("Traversal (one field)", aScenario.m_Size);
+
+    sList.forEach([](const UnrolledObject& o) { SideEffect += o.m_Key; });
+    checkpoint("forEach (one field)", aScenario.m_Size);
+
+    for (uint32_t i : aScenario.m_Random)
+    {
+        sList.removeItem(sObjects[i]);
+        sList.insertFront(sObjects[i]);
+    }
+    checkpoint("Random relink", aScenario.m_Random.size());
+
+    for (uint32_t i : aScenario.m_Order)
+        sList.removeItem(sObjects[i]);
+    checkpoint("Removing", aScenario.m_Size);
+}
+
+int main()
+{
+    const size_t SIZES[] = {64 * 1024, 1024 * 1024};
+    for (size_t sSize : SIZES)
+    {
+        Scenario sScenario(sSize);
+        autoList(sScenario);
+        unrolled<8>(sScenario);
+        unrolled<16>(sScenario);
+        unrolled<32>(sScenario);
+    }
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <UnrolledList.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template <class List>
+void check(const List& aList, std::vector<int> aArr, const char* funcname, const char *filename, int line)
+{
+    bool sFailed = aList.selfCheck() != 0;
+    if (aList.empty() != aArr.empty())
+        sFailed = true;
+    if (!aList.empty() && !aArr.empty() &&
+        (aList.front().m_Data != aArr.front() || aList.back().m_Data != aArr.back()))
+        sFailed = true;
+
+    std::vector<int> sForward;
+    for (auto sItr = aList.begin(); sItr != aList.end() && sForward.size() <= aArr.size(); ++sItr)
+        sForward.push_back(sItr->m_Data);
+    std::vector<int> sBackward;
+    for (auto sItr = aList.end(); sItr != aList.begin() && sBackward.size() <= aArr.size(); )
+        sBackward.insert(sBackward.begin(), (--sItr)->m_Data);
+    if (sForward != aArr || sBackward != aArr)
+        sFailed = true;
+
+    if (sFailed)
+    {
+        std::cerr << "Check failed: list {";
+        for (size_t i = 0; i < sForward.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << sForward[i];
+        std::cerr << "} expected to be {";
+        for (size_t i = 0; i < aArr.size(); i++)
+            std::cerr << (i == 0 ? "" : ", ") << aArr[i];
+        std::cerr << "} in " << funcname << " at " << filename << ":" << line << std::endl;
+        rc = 1;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct Object
+{
+    int m_Data;
+    UnrolledListLink m_Link;
+    Object(int aId = 0) : m_Data(aId) {}
+};
+
+template <size_t ChunkSize>
+using ObjectList = UnrolledList<Object, &Object::m_Link, ChunkSize>;
+
+void simple()
+{
+    ANNOUNCE();
+
+    Object sObjects[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    ObjectList<4> sList;
+    CHECK(sList, std::vector<int>());
+    CHECK(!sList.contains(sObjects[0]));
+
+    sList.insertBack(sObjects[2]);
+    sList.insertFront(sObjects[1]);
+    sList.insertBack(sObjects[3]);
+    sList.insertFront(sObjects[0]);
+    CHECK(sList, {0, 1, 2, 3});
+    CHECK(sList.chunkCount(), size_t(1));
+    CHECK(sList.contains(sObjects[0]));
+
+    // Full chunk: a new one at the ends, a split in the middle.
+    sList.insertBack(sObjects[5]);
+    CHECK(sList, {0, 1, 2, 3, 5});
+    CHECK(sList.chunkCount(), size_t(2));
+    sList.insertAfter(sObjects[3], sObjects[4]);
+    CHECK(sList, {0, 1, 2, 3, 4, 5});
+    sList.insertAfter(sObjects[0], sObjects[6]);
+    CHECK(sList, {0, 6, 1, 2, 3, 4, 5});
+    sList.insertAfter(sObjects[2], sObjects[7]);
+    CHECK(sList, {0, 6, 1, 2, 7, 3, 4, 5});
+    CHECK(sList.size(), size_t(8));
+
+    ObjectList<4> sOther;
+    sOther.insertBack(sObjects[8]);
+    CHECK(!sList.contains(sObjects[8]));
+    CHECK(sOther.contains(sObjects[8]));
+    sOther.removeItem(sObjects[8]);
+    CHECK(!sOther.contains(sObjects[8]));
+
+    // Removal shifts and merges less than half full chunks.
+    size_t sChunks = sList.chunkCount();
+    sList.removeItem(sObjects[6]);
+    sList.removeItem(sObjects[7]);
+    sList.removeItem(sObjects[0]);
+    CHECK(sList, {1, 2, 3, 4, 5});
+    CHECK(sList.chunkCount() < sChunks);
+    CHECK(!sList.contains(sObjects[0]));
+    sList.removeItem(sObjects[5]);
+    sList.removeItem(sObjects[1]);
+    CHECK(sList, {2, 3, 4});
+    CHECK(sList.chunkCount(), size_t(1));
+
+    int sSum = 0;
+    sList.forEach([&sSum](const Object& aObject) { sSum += aObject.m_Data; });
+    CHECK(sSum, 9);
+
+    sList.clear();
+    CHECK(sList, std::vector<int>());
+    CHECK(sList.chunkCount(), size_t(0));
+    CHECK(!sList.contains(sObjects[3]));
+    sList.insertFront(sObjects[3]);
+    CHECK(sList, {3});
+    sList.removeItem(sObjects[3]);
+    CHECK(sList, std::vector<int>());
+}
+
+template <size_t ChunkSize>
+void massive()
+{
+    ANNOUNCE();
+
+    const int COUNT = 500;
+    std::vector<Object> sObjects(COUNT);
+    for (int i = 0; i < COUNT; i++)
+        sObjects[i].m_Data = i;
+    ObjectList<ChunkSize> sList;
+    std::vector<int> sRef;
+    std::mt19937 sRand(ChunkSize);
+    bool sOk = true;
+    for (int sStep = 0; sStep < 20000 && sOk; sStep++)
+    {
+        int i = sRand() % COUNT;
+        auto sPos = std::find(sRef.begin(), sRef.end(), i);
+        if (sPos != sRef.end())
+        {
+            sList.removeItem(sObjects[i]);
+            sRef.erase(sPos);
+        }
+        else if (sRef.empty() || sRand() % 4 == 0)
+        {
+            sList.insertBack(sObjects[i]);
+            sRef.push_back(i);
+        }
+        else if (sRand() % 3 == 0)
+        {
+            sList.insertFront(sObjects[i]);
+            sRef.insert(sRef.begin(), i);
+        }
+        else
+        {
+            size_t sAfter = sRand() % sRef.size();
+            sList.insertAfter(sObjects[sRef[sAfter]], sObjects[i]);
+            sRef.insert(sRef.begin() + sAfter + 1, i);
+        }
+        sOk = sList.selfCheck() == 0 && sList.size() == sRef.size();
+        sOk = sOk && sList.contains(sObjects[i]) == (std::find(sRef.begin(), sRef.end(), i) != sRef.end());
+        if (sStep % 1000 == 0)
+            CHECK(sList, sRef);
+    }
+    CHECK(sOk);
+    CHECK(sList, sRef);
+
+    // Chunks stay about half full when items are removed one by one.
+    std::vector<int> sOrder = sRef;
+    std::shuffle(sOrder.begin(), sOrder.end(), sRand);
+    for (size_t k = 0; k < sOrder.size() / 2; k++)
+    {
+        sList.removeItem(sObjects[sOrder[k]]);
+        sRef.erase(std::find(sRef.begin(), sRef.end(), sOrder[k]));
+    }
+    CHECK(sList, sRef);
+    CHECK(sList.chunkCount() <= 4 * sList.size() / ChunkSize + 2);
+    sList.clear();
+    CHECK(sList, std::vector<int>());
+}
+
+} // anonymous namespace
+
+int main()
+{
+    simple();
+    massive<4>();
+    massive<16>();
+    massive<32>();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <AutoList.hpp>
+#include <CacheLine.hpp>
+#include <Futex.hpp>
+
+// Work-stealing task pool with intrusive tasks: a task embeds its link, so
+// spawning never allocates. Every worker owns a TaskDeque: the owner pushes
+// and pops at the back (LIFO), a thief takes the older half from the front
+// with one Ring::split. Idle workers park on a futex.
+//
+// A task must stay alive until it has run; it may destroy itself in run().
+
+class TaskGroup;
+
+class Task
+{
+public:
+    virtual ~Task() = default;
+    virtual void run() = 0;
+
+    AutoListLink m_Link;
+    // Group to notify when the task completes, set by spawn.
+    TaskGroup* m_Group = nullptr;
+};
+
+// Counter of unfinished tasks, see WorkStealingPool::wait.
+class TaskGroup
+{
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    bool done() const
+    {
+        return 0 == (m_State.load(std::memory_order_acquire) & ~PARKED);
+    }
+
+private:
+    friend class WorkStealingPool;
+    // Pending task count and a flag of a parked waiter in one futex word:
+    // the group may be destroyed as soon as the count drops to zero, so
+    // finish must not touch it after the decrement.
+    static constexpr uint32_t PARKED = 1u << 31;
+    std::atomic<uint32_t> m_State{0};
+
+    void finish()
+    {
+        uint32_t sWas = m_State.fetch_sub(1, std::memory_order_acq_rel);
+        if (sWas == (PARKED | 1))
+            futexWake(&m_State, UINT32_MAX);
+    }
+};
+
+// Deque of tasks with a lock. Besides the ends, it tracks the middle node:
+// every push or pop moves it by one node at most, so stealing the front
+// half is O(1). Appending a stolen chain walks to its middle, that's paid
+// by running the chain.
+class TaskDeque
+{
+public:
+    TaskDeque() : m_Ring(0), m_Mid(&m_Ring) {}
+    ~TaskDeque()
+    {
+        m_Ring.remove();
+    }
+    TaskDeque(const TaskDeque&) = delete;
+    TaskDeque& operator=(const TaskDeque&) = delete;
+
+    void push(Task& aTask)
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        m_Ring.add(&aTask.m_Link.m_Ring, true);
+        if (m_Mid == &m_Ring)
+            ++m_MidIndex;
+        setSize(m_Size + 1);
+    }
+    // Takes the newest task.
+    Task* pop()
+    {
+        if (0 == size())
+            return nullptr;
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        if (0 == m_Size)
+            return nullptr;
+        Ring* sRing = m_Ring.m_Neigh[0];
+        if (m_Mid == sRing)
+            m_Mid = &m_Ring;
+        else if (m_Mid == &m_Ring)
+            --m_MidIndex;
+        sRing->remove();
+        sRing->init();
+        setSize(m_Size - 1);
+        return task(sRing);
+    }
+    // Cuts the older half of the tasks (rounded up) out to a separate ring.
+    // Returns its first node (the oldest task) or nullptr if the deque is
+    // empty, aCount is set to the number of the tasks.
+    Ring* steal(size_t& aCount)
+    {
+        aCount = 0;
+        if (0 == size())
+            return nullptr;
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        if (0 == m_Size)
+            return nullptr;
+        Ring* sFirst = m_Ring.m_Neigh[1];
+        aCount = m_MidIndex;
+        sFirst->split(m_Mid);
+        m_MidIndex = 0;
+        setSize(m_Size - aCount);
+        return sFirst;
+    }
+    // Appends a ring of aCount tasks (see steal) to the back.
+    void pushChain(Ring* aFirst, size_t aCount)
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        m_Ring.join(aFirst);
+        if (m_Mid == &m_Ring)
+            m_MidIndex += aCount;
+        setSize(m_Size + aCount);
+    }
+    // Number of tasks, may be stale unless called by the only user.
+    size_t size() const
+    {
+        return m_SizeHint.load(std::memory_order_relaxed);
+    }
+    int selfCheck() const
+    {
+        std::lock_guard<FutexMutex> sGuard(m_Mutex);
+        if (m_Ring.selfCheck() != 0)
+            return 1;
+        if (m_Ring.calcSize() != m_Size + 1)
+            return 2;
+        const Ring* sRing = m_Ring.m_Neigh[1];
+        for (size_t i = 0; i < m_MidIndex; i++)
+            sRing = sRing->m_Neigh[1];
+        if (sRing != m_Mid || m_MidIndex != (m_Size + 1) / 2)
+            return 3;
+        return 0;
+    }
+
+    static Task* task(Ring* aRing)
+    {
+        const uintptr_t sOffset = reinterpret_cast<uintptr_t>(&(reinterpret_cast<Task*>(0)->m_Link.m_Ring));
+        return reinterpret_cast<Task*>(reinterpret_cast<char*>(aRing) - sOffset);
+    }
+
+private:
+    mutable FutexMutex m_Mutex;
+    Ring m_Ring;
+    // The first node of the newer half, m_Ring if the deque is empty; its
+    // index is (m_Size + 1) / 2, and m_Ring has index m_Size.
+    Ring* m_Mid;
+    size_t m_MidIndex = 0;
+    size_t m_Size = 0;
+    std::atomic<size_t> m_SizeHint{0};
+
+    void setSize(size_t aSize)
+    {
+        m_Size = aSize;
+        m_SizeHint.store(aSize, std::memory_order_relaxed);
+        size_t sTarget = (aSize + 1) / 2;
+        while (m_MidIndex < sTarget)
+        {
+            m_Mid = m_Mid->m_Neigh[1];
+            ++m_MidIndex;
+        }
+        while (m_MidIndex > sTarget)
+        {
+            m_Mid = m_Mid->m_Neigh[0];
+            --m_MidIndex;
+        }
+    }
+};
+
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(size_t aWorkers = std::thread::hardware_concurrency())
+        : m_Workers(aWorkers == 0 ? 1 : aWorkers)
+    {
+        for (size_t i = 0; i < m_Workers.size(); i++)
+            m_Workers[i].m_Thread = std::thread([this, i]() { loop(i); });
+    }
+    ~WorkStealingPool()
+    {
+        m_Stop.store(true, std::memory_order_seq_cst);
+        m_WorkSequence.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(&m_WorkSequence, UINT32_MAX);
+        for (Worker& sWorker : m_Workers)
+            sWorker.m_Thread.join();
+    }
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Adds a task; aGroup (if given) counts it until it completes. Called by
+    // a worker, it goes to the worker's deque, otherwise to one of deques
+    // round robin.
+    void spawn(Task& aTask, TaskGroup* aGroup = nullptr)
+    {
+        aTask.m_Group = aGroup;
+        if (nullptr != aGroup)
+            aGroup->m_State.fetch_add(1, std::memory_order_relaxed);
+        Worker* sWorker = current();
+        if (nullptr == sWorker)
+            sWorker = &m_Workers[m_NextExternal.fetch_add(1, std::memory_order_relaxed) % m_Workers.size()];
+        sWorker->m_Deque.push(aTask);
+        wakeOne();
+    }
+    // Waits until all tasks of aGroup complete. A worker runs other tasks
+    // meanwhile, another thread parks.
+    void wait(TaskGroup& aGroup)
+    {
+        Worker* sWorker = current();
+        if (nullptr != sWorker)
+        {
+            while (!aGroup.done())
+            {
+                Task* sTask = find(*sWorker);
+                if (nullptr != sTask)
+                    execute(*sTask);
+                else
+                    cpuRelax();
+            }
+            return;
+        }
+        for (;;)
+        {
+            uint32_t sState = aGroup.m_State.load(std::memory_order_acquire);
+            if (0 == (sState & ~TaskGroup::PARKED))
+                break;
+            if (0 == (sState & TaskGroup::PARKED))
+            {
+                sState |= TaskGroup::PARKED;
+                if ((aGroup.m_State.fetch_or(TaskGroup::PARKED, std::memory_order_acq_rel) & ~TaskGroup::PARKED) == 0)
+                    break;
+            }
+            futexWait(&aGroup.m_State, sState);
+        }
+        aGroup.m_State.store(0, std::memory_order_relaxed);
+    }
+
+    size_t workerCount() const
+    {
+        return m_Workers.size();
+    }
+    // Successful steals and tasks moved by them, for tuning and benchmarks.
+    size_t stealCount() const
+    {
+        size_t sRes = 0;
+        for (const Worker& sWorker : m_Workers)
+            sRes += sWorker.m_Steals.load(std::memory_order_relaxed);
+        return sRes;
+    }
+    size_t stolenCount() const
+    {
+        size_t sRes = 0;
+        for (const Worker& sWorker : m_Workers)
+            sRes += sWorker.m_Stolen.load(std::memory_order_relaxed);
+        return sRes;
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Worker
+    {
+        TaskDeque m_Deque;
+        std::thread m_Thread;
+        std::atomic<size_t> m_Steals{0};
+        std::atomic<size_t> m_Stolen{0};
+        std::minstd_rand m_Rand;
+    };
+    static constexpr int IDLE_ROUNDS = 64;
+
+    CacheAlignedArray<Worker> m_Workers;
+    std::atomic<bool> m_Stop{false};
+    std::atomic<size_t> m_NextExternal{0};
+    std::atomic<uint32_t> m_WorkSequence{0};
+    std::atomic<uint32_t> m_Sleepers{0};
+
+    struct Current
+    {
+        const WorkStealingPool* m_Pool;
+        Worker* m_Worker;
+    };
+    static Current& currentSlot()
+    {
+        static thread_local Current sCurrent{nullptr, nullptr};
+        return sCurrent;
+    }
+    Worker* current() const
+    {
+        const Current& sCurrent = currentSlot();
+        return sCurrent.m_Pool == this ? sCurrent.m_Worker : nullptr;
+    }
+
+    static void execute(Task& aTask)
+    {
+        TaskGroup* sGroup = aTask.m_Group;
+        aTask.run();
+        if (nullptr != sGroup)
+            sGroup->finish();
+    }
+
+    // Own newest task or the oldest half of a random victim's tasks.
+    Task* find(Worker& aWorker)
+    {
+        Task* sTask = aWorker.m_Deque.pop();
+        if (nullptr != sTask)
+            return sTask;
+        size_t sCount = m_Workers.size();
+        size_t sStart = aWorker.m_Rand() % sCount;
+        for (size_t i = 0; i < sCount; i++)
+        {
+            Worker& sVictim = m_Workers[(sStart + i) % sCount];
+            if (&sVictim == &aWorker)
+                continue;
+            size_t sStolen;
+            Ring* sFirst = sVictim.m_Deque.steal(sStolen);
+            if (nullptr == sFirst)
+                continue;
+            aWorker.m_Steals.fetch_add(1, std::memory_order_relaxed);
+            aWorker.m_Stolen.fetch_add(sStolen, std::memory_order_relaxed);
+            // The oldest stolen task is run, the rest goes to the own deque.
+            Ring* sRest = sFirst->m_Neigh[1];
+            if (sStolen > 1)
+            {
+                sFirst->remove();
+                aWorker.m_Deque.pushChain(sRest, sStolen - 1);
+                wakeOne();
+            }
+            sFirst->init();
+            return TaskDeque::task(sFirst);
+        }
+        return nullptr;
+    }
+
+    bool anyWork() const
+    {
+        for (const Worker& sWorker : m_Workers)
+            if (sWorker.m_Deque.size() != 0)
+                return true;
+        return false;
+    }
+    void wakeOne()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (0 == m_Sleepers.load(std::memory_order_relaxed))
+            return;
+        m_WorkSequence.fetch_add(1, std::memory_order_release);
+        futexWake(&m_WorkSequence, 1);
+    }
+
+    void loop(size_t aIndex)
+    {
+        Worker& sWorker = m_Workers[aIndex];
+        sWorker.m_Rand.seed(aIndex + 1);
+        currentSlot() = Current{this, &sWorker};
+        int sIdle = 0;
+        while (!m_Stop.load(std::memory_order_relaxed))
+        {
+            Task* sTask = find(sWorker);
+            if (nullptr != sTask)
+            {
+                execute(*sTask);
+                sIdle = 0;
+                continue;
+            }
+            if (++sIdle < IDLE_ROUNDS)
+            {
+                cpuRelax();
+                continue;
+            }
+            // Park: the sleeper count is published before the last check
+            // for work, spawn publishes work before checking the count.
+            uint32_t sSequence = m_WorkSequence.load(std::memory_order_acquire);
+            m_Sleepers.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!anyWork() && !m_Stop.load(std::memory_order_seq_cst))
+                futexWait(&m_WorkSequence, sSequence);
+            m_Sleepers.fetch_sub(1, std::memory_order_relaxed);
+            sIdle = 0;
+        }
+        currentSlot() = Current{nullptr, nullptr};
+    }
+};
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <WorkStealing.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    static uint64_t SideEffect = 0;
+}
+
+static void checkpoint(const char* aText, size_t aOpCount)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point now = high_resolution_clock::now();
+    static high_resolution_clock::time_point was;
+    duration<double> time_span = duration_cast<duration<double>>(now - was);
+    if (0 != aOpCount)
+    {
+        double Mrps = aOpCount / 1000000. / time_span.count();
+        std::cout << aText << ": " << Mrps << " Mrps" << std::endl;
+    }
+    was = now;
+}
+
+static uint64_t fibSerial(unsigned aN)
+{
+    return aN < 2 ? aN : fibSerial(aN - 1) + fibSerial(aN - 2);
+}
+
+// Number of calls of fibSerial(aN), the unit of work in fib tests.
+static size_t fibCalls(unsigned aN)
+{
+    return aN < 2 ? 1 : 1 + fibCalls(aN - 1) + fibCalls(aN - 2);
+}
+
+struct FibTask : Task
+{
+    WorkStealingPool& m_Pool;
+    unsigned m_N;
+    unsigned m_Cutoff;
+    uint64_t m_Result = 0;
+
+    FibTask(WorkStealingPool& aPool, unsigned aN, unsigned aCutoff) : m_Pool(aPool), m_N(aN), m_Cutoff(aCutoff) {}
+    void run() override
+    {
+        if (m_N <= m_Cutoff)
+        {
+            m_Result = fibSerial(m_N);
+            return;
+        }
+        FibTask sLeft(m_Pool, m_N - 1, m_Cutoff);
+        FibTask sRight(m_Pool, m_N - 2, m_Cutoff);
+        TaskGroup sGroup;
+        m_Pool.spawn(sLeft, &sGroup);
+        sRight.run();
+        m_Pool.wait(sGroup);
+        m_Result = sLeft.m_Result + sRight.m_Result;
+    }
+};
+
+struct Node
+{
+    Node* m_Child[2] = {nullptr, nullptr};
+    uint32_t m_Key = 0;
+};
+
+// Random binary search tree, depth is about 3 log(N).
+static std::vector<Node> buildTree(size_t aSize)
+{
+    std::vector<uint32_t> sKeys(aSize);
+    for (size_t i = 0; i < aSize; i++)
+        sKeys[i] = i;
+    std::mt19937 sRand(aSize);
+    std::shuffle(sKeys.begin(), sKeys.end(), sRand);
+    std::vector<Node> sNodes(aSize);
+    for (size_t i = 0; i < aSize; i++)
+    {
+        sNodes[i].m_Key = sKeys[i];
+        if (i == 0)
+            continue;
+        Node* sParent = &sNodes[0];
+        for (;;)
+        {
+            Node*& sChild = sParent->m_Child[sKeys[i] > sParent->m_Key];
+            if (nullptr == sChild)
+            {
+                sChild = &sNodes[i];
+                break;
+            }
+            sParent = sChild;
+        }
+    }
+    return sNodes;
+}
+
+static uint64_t walkSerial(const Node* aNode)
+{
+    uint64_t sRes = 0;
+    while (nullptr != aNode)
+    {
+        sRes += aNode->m_Key;
+        sRes += walkSerial(aNode->m_Child[0]);
+        aNode = aNode->m_Child[1];
+    }
+    return sRes;
+}
+
+// Spawns the left subtree and walks the right one while above aCutoff depth.
+struct WalkTask : Task
+{
+    WorkStealingPool& m_Pool;
+    const Node* m_Node;
+    unsigned m_Depth;
+    unsigned m_Cutoff;
+    uint64_t m_Result = 0;
+
+    WalkTask(WorkStealingPool& aPool, const Node* aNode, unsigned aDepth, unsigned aCutoff)
+        : m_Pool(aPool), m_Node(aNode), m_Depth(aDepth), m_Cutoff(aCutoff) {}
+    void run() override
+    {
+        if (nullptr == m_Node)
+            return;
+        if (m_Depth >= m_Cutoff)
+        {
+            m_Result = walkSerial(m_Node);
+            return;
+        }
+        WalkTask sLeft(m_Pool, m_Node->m_Child[0], m_Depth + 1, m_Cutoff);
+        WalkTask sRight(m_Pool, m_Node->m_Child[1], m_Depth + 1, m_Cutoff);
+        TaskGroup sGroup;
+        if (nullptr != sLeft.m_Node)
+            m_Pool.spawn(sLeft, &sGroup);
+        sRight.run();
+        m_Pool.wait(sGroup);
+        m_Result = m_Node->m_Key + sLeft.m_Result + sRight.m_Result;
+    }
+};
+
+template <class T>
+static void runRoot(WorkStealingPool& aPool, T& aTask)
+{
+    TaskGroup sGroup;
+    aPool.spawn(aTask, &sGroup);
+    aPool.wait(sGroup);
+}
+
+static void printSteals(const WorkStealingPool& aPool)
+{
+    std::cout << "  (steals: " << aPool.stealCount() << ", tasks stolen: " << aPool.stolenCount() << ")" << std::endl;
+}
+
+static void fib(const std::vector<size_t>& aWorkers)
+{
+    const unsigned N = 30;
+    const unsigned CUTOFFS[] = {1, 10, 20};
+    size_t sCalls = fibCalls(N);
+    std::cout << "fib(" << N << "), " << sCalls << " calls" << std::endl;
+
+    checkpoint("", 0);
+    SideEffect += fibSerial(N);
+    checkpoint("Serial", sCalls);
+
+    for (size_t sWorkers : aWorkers)
+    {
+        WorkStealingPool sPool(sWorkers);
+        for (unsigned sCutoff : CUTOFFS)
+        {
+            std::string sText = "Pool of " + std::to_string(sWorkers) + ", serial below " + std::to_string(sCutoff);
+            FibTask sTask(sPool, N, sCutoff);
+            checkpoint("", 0);
+            runRoot(sPool, sTask);
+            checkpoint(sText.c_str(), sCalls);
+            SideEffect += sTask.m_Result;
+        }
+        printSteals(sPool);
+    }
+}
+
+static void treeWalk(const std::vector<size_t>& aWorkers)
+{
+    const size_t SIZE = 4 * 1024 * 1024;
+    const unsigned CUTOFFS[] = {64, 16, 8};
+    std::vector<Node> sNodes = buildTree(SIZE);
+    std::cout << "Tree walk, " << SIZE << " nodes" << std::endl;
+
+    checkpoint("", 0);
+    SideEffect += walkSerial(&sNodes[0]);
+    checkpoint("Serial", SIZE);
+
+    for (size_t sWorkers : aWorkers)
+    {
+        WorkStealingPool sPool(sWorkers);
+        for (unsigned sCutoff : CUTOFFS)
+        {
+            std::string sText = "Pool of " + std::to_string(sWorkers) + ", serial below depth " + std::to_string(sCutoff);
+            WalkTask sTask(sPool, &sNodes[0], 0, sCutoff);
+            checkpoint("", 0);
+            runRoot(sPool, sTask);
+            checkpoint(sText.c_str(), SIZE);
+            SideEffect += sTask.m_Result;
+        }
+        printSteals(sPool);
+    }
+}
+
+int main()
+{
+    size_t sMaxWorkers = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    std::vector<size_t> sWorkers;
+    for (size_t i = 1; i <= sMaxWorkers; i *= 2)
+        sWorkers.push_back(i);
+    fib(sWorkers);
+    treeWalk(sWorkers);
+    std::cout << "Side effect (ignore it): " << SideEffect << std::endl;
+}
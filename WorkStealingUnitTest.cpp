@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2018, Aleksandr Lyapunov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <WorkStealing.hpp>
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+int rc = 0;
+
+void check(bool exp, const char* funcname, const char *filename, int line)
+{
+    if (!exp)
+    {
+        rc = 1;
+        std::cerr << "Check failed in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+template<class T>
+void check(const T& x, const T& y, const char* funcname, const char *filename, int line)
+{
+    if (x != y)
+    {
+        rc = 1;
+        std::cerr << "Check failed: " << x << " != " << y <<  " in " << funcname << " at " << filename << ":" << line << std::endl;
+    }
+}
+
+#define CHECK(...) check(__VA_ARGS__, __func__, __FILE__, __LINE__)
+
+struct Announcer
+{
+    const char* m_Func;
+    explicit Announcer(const char* aFunc) : m_Func(aFunc) { std::cout << "Test " << m_Func << " started" << std::endl; }
+    ~Announcer() { std::cout << "Test " << m_Func << " finished" << std::endl; }
+};
+
+#define ANNOUNCE() Announcer sAnn(__func__)
+
+struct CountTask : Task
+{
+    int m_Id = 0;
+    std::atomic<int> m_Runs{0};
+    void run() override
+    {
+        m_Runs.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+std::vector<int> ids(Ring* aFirst, size_t aCount)
+{
+    std::vector<int> sRes;
+    Ring* sRing = aFirst;
+    for (size_t i = 0; i < aCount; i++, sRing = sRing->m_Neigh[1])
+        sRes.push_back(static_cast<CountTask*>(TaskDeque::task(sRing))->m_Id);
+    if (sRing != aFirst)
+        sRes.push_back(-1);
+    return sRes;
+}
+
+void deque_simple()
+{
+    ANNOUNCE();
+
+    CountTask sTasks[8];
+    for (int i = 0; i < 8; i++)
+        sTasks[i].m_Id = i;
+
+    TaskDeque sDeque;
+    size_t sCount;
+    CHECK(sDeque.pop() == nullptr);
+    CHECK(sDeque.steal(sCount) == nullptr);
+    CHECK(sCount, size_t(0));
+
+    sDeque.push(sTasks[0]);
+    CHECK(sDeque.selfCheck(), 0);
+    Ring* sFirst = sDeque.steal(sCount);
+    CHECK(sCount, size_t(1));
+    CHECK(ids(sFirst, sCount) == std::vector<int>({0}));
+    CHECK(sDeque.size(), size_t(0));
+    CHECK(sDeque.selfCheck(), 0);
+    sFirst->init();
+
+    for (int i = 1; i < 8; i++)
+    {
+        sDeque.push(sTasks[i]);
+        CHECK(sDeque.selfCheck(), 0);
+    }
+    CHECK(sDeque.pop() == &sTasks[7]);
+    CHECK(sDeque.selfCheck(), 0);
+
+    // 1..6: the older half goes to a thief.
+    sFirst = sDeque.steal(sCount);
+    CHECK(sDeque.selfCheck(), 0);
+    CHECK(ids(sFirst, sCount) == std::vector<int>({1, 2, 3}));
+    CHECK(sDeque.size(), size_t(3));
+
+    TaskDeque sThief;
+    sThief.pushChain(sFirst, sCount);
+    CHECK(sThief.selfCheck(), 0);
+    CHECK(sThief.pop() == &sTasks[3]);
+    CHECK(sThief.pop() == &sTasks[2]);
+    CHECK(sThief.selfCheck(), 0);
+
+    sFirst = sDeque.steal(sCount);
+    CHECK(ids(sFirst, sCount) == std::vector<int>({4, 5}));
+    sThief.pushChain(sFirst, sCount);
+    CHECK(sThief.selfCheck(), 0);
+    CHECK(sThief.pop() == &sTasks[5]);
+    CHECK(sThief.pop() == &sTasks[4]);
+    CHECK(sThief.pop() == &sTasks[1]);
+    CHECK(sThief.pop() == nullptr);
+    CHECK(sDeque.pop() == &sTasks[6]);
+    CHECK(sDeque.pop() == nullptr);
+    CHECK(sDeque.selfCheck(), 0);
+    CHECK(sThief.selfCheck(), 0);
+}
+
+void deque_massive()
+{
+    ANNOUNCE();
+
+    const int COUNT = 300;
+    std::vector<CountTask> sTasks(COUNT);
+    for (int i = 0; i < COUNT; i++)
+        sTasks[i].m_Id = i;
+
+    TaskDeque sDeque;
+    std::deque<int> sRef;
+    std::vector<bool> sIn(COUNT, false);
+    std::mt19937 sRand(7);
+    bool sOk = true;
+    for (int sStep = 0; sStep < 20000 && sOk; sStep++)
+    {
+        unsigned sOp = sRand() % 10;
+        if (sOp < 6)
+        {
+            int i = sRand() % COUNT;
+            if (sIn[i])
+                continue;
+            sDeque.push(sTasks[i]);
+            sRef.push_back(i);
+            sIn[i] = true;
+        }
+        else if (sOp < 9)
+        {
+            Task* sTask = sDeque.pop();
+            int sExpected = sRef.empty() ? -1 : sRef.back();
+            int sGot = sTask == nullptr ? -1 : static_cast<CountTask*>(sTask)->m_Id;
+            sOk = sExpected == sGot;
+            if (!sRef.empty())
+            {
+                sRef.pop_back();
+                sIn[sGot] = false;
+            }
+        }
+        else
+        {
+            size_t sCount;
+            Ring* sFirst = sDeque.steal(sCount);
+            std::vector<int> sExpected(sRef.begin(), sRef.begin() + (sRef.size() + 1) / 2);
+            sOk = (sFirst == nullptr ? std::vector<int>() : ids(sFirst, sCount)) == sExpected;
+            for (int i : sExpected)
+            {
+                sRef.pop_front();
+                sIn[i] = false;
+                sTasks[i].m_Link.m_Ring.remove();
+                sTasks[i].m_Link.m_Ring.init();
+            }
+        }
+        sOk = sOk && sDeque.selfCheck() == 0 && sDeque.size() == sRef.size();
+    }
+    CHECK(sOk);
+    while (sDeque.pop() != nullptr)
+        ;
+}
+
+struct FibTask : Task
+{
+    WorkStealingPool& m_Pool;
+    unsigned m_N;
+    uint64_t m_Result = 0;
+
+    FibTask(WorkStealingPool& aPool, unsigned aN) : m_Pool(aPool), m_N(aN) {}
+    void run() override
+    {
+        if (m_N < 2)
+        {
+            m_Result = m_N;
+            return;
+        }
+        FibTask sLeft(m_Pool, m_N - 1);
+        FibTask sRight(m_Pool, m_N - 2);
+        TaskGroup sGroup;
+        m_Pool.spawn(sLeft, &sGroup);
+        sRight.run();
+        m_Pool.wait(sGroup);
+        m_Result = sLeft.m_Result + sRight.m_Result;
+    }
+};
+
+void pool_fib()
+{
+    ANNOUNCE();
+
+    for (size_t sWorkers : {1, 2, 4})
+    {
+        WorkStealingPool sPool(sWorkers);
+        FibTask sTask(sPool, 20);
+        TaskGroup sGroup;
+        sPool.spawn(sTask, &sGroup);
+        sPool.wait(sGroup);
+        CHECK(sTask.m_Result, uint64_t(6765));
+        CHECK(sGroup.done());
+    }
+}
+
+// Every task spawned from outside or by other tasks runs exactly once.
+struct FanTask : Task
+{
+    WorkStealingPool* m_Pool = nullptr;
+    std::vector<CountTask>* m_Leaves = nullptr;
+    size_t m_Begin = 0;
+    size_t m_End = 0;
+    TaskGroup* m_LeafGroup = nullptr;
+    void run() override
+    {
+        for (size_t i = m_Begin; i < m_End; i++)
+            m_Pool->spawn((*m_Leaves)[i], m_LeafGroup);
+    }
+};
+
+void pool_massive()
+{
+    ANNOUNCE();
+
+    const size_t FANS = 64;
+    const size_t PER_FAN = 500;
+    WorkStealingPool sPool(4);
+    for (int sRound = 0; sRound < 5; sRound++)
+    {
+        std::vector<CountTask> sLeaves(FANS * PER_FAN);
+        std::vector<FanTask> sFans(FANS);
+        TaskGroup sGroup;
+        for (size_t i = 0; i < FANS; i++)
+        {
+            sFans[i].m_Pool = &sPool;
+            sFans[i].m_Leaves = &sLeaves;
+            sFans[i].m_Begin = i * PER_FAN;
+            sFans[i].m_End = (i + 1) * PER_FAN;
+            sFans[i].m_LeafGroup = &sGroup;
+            sPool.spawn(sFans[i], &sGroup);
+        }
+        sPool.wait(sGroup);
+        bool sOk = true;
+        for (CountTask& sLeaf : sLeaves)
+            sOk = sOk && sLeaf.m_Runs.load() == 1;
+        CHECK(sOk);
+    }
+}
+
+void pool_parked()
+{
+    ANNOUNCE();
+
+    // Workers park when idle and must wake up for a new task.
+    WorkStealingPool sPool(3);
+    for (int i = 0; i < 10; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        CountTask sTask;
+        TaskGroup sGroup;
+        sPool.spawn(sTask, &sGroup);
+        sPool.wait(sGroup);
+        CHECK(sTask.m_Runs.load(), 1);
+    }
+}
+
+} // anonymous namespace
+
+int main()
+{
+    deque_simple();
+    deque_massive();
+    pool_fib();
+    pool_massive();
+    pool_parked();
+
+    if (rc == 0)
+        std::cout << "Success" << std::endl;
+    else
+        std::cout << "Failed" << std::endl;
+    return rc;
+}